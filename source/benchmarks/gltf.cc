@@ -0,0 +1,955 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Elias Engelbert Plank
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <realtime/animation.h>
+#include <realtime/base64.h>
+#include <realtime/gltf.h>
+#include <realtime/gltf_accessor.h>
+#include <realtime/gltf_meshopt.h>
+#include <realtime/hierarchy.h>
+#include <realtime/image.h>
+#include <realtime/mesh.h>
+#include <realtime/morph.h>
+
+namespace {
+
+/// The number of vertices of a primitive that can still be indexed with 16 bits
+constexpr u32 SPLIT_SIZE = 65536;
+
+/// Appends the bytes of a value to a buffer
+/// @tparam T The type of the value
+/// @param buffer The buffer
+/// @param value The value
+template<typename T>
+void append(std::string &buffer, const T &value) {
+    buffer.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+/// Generates a binary glTF file with a mesh of the given number of vertices, laid out like exporters do:
+/// interleaved float positions and normals, 16-bit normalized texture coordinates, 8-bit normalized colours
+/// and six indices per vertex. Primitives are split so that their indices fit 16 bits if requested.
+/// @param vertices The number of vertices
+/// @param split Whether the mesh is split into primitives with 16-bit indices
+/// @return The bytes of the GLB file
+std::string generate_glb(u32 vertices, bool split) {
+    std::string binary{};
+    std::string views{};
+    std::string accessors{};
+    std::string primitives{};
+    usize view_count = 0;
+    usize accessor_count = 0;
+
+    auto add_view = [&](usize offset, usize length, u32 stride) {
+        if (view_count++ > 0) {
+            views += ',';
+        }
+        views += R"({"buffer":0,"byteOffset":)" + std::to_string(offset) + R"(,"byteLength":)" +
+                 std::to_string(length);
+        if (stride > 0) {
+            views += R"(,"byteStride":)" + std::to_string(stride);
+        }
+        views += '}';
+        return view_count - 1;
+    };
+    auto add_accessor = [&](usize view, usize offset, u32 component_type, bool normalized, u32 count,
+                            const char *type) {
+        if (accessor_count++ > 0) {
+            accessors += ',';
+        }
+        accessors += R"({"bufferView":)" + std::to_string(view) + R"(,"byteOffset":)" + std::to_string(offset) +
+                     R"(,"componentType":)" + std::to_string(component_type) + R"(,"normalized":)" +
+                     (normalized ? "true" : "false") + R"(,"count":)" + std::to_string(count) + R"(,"type":")" +
+                     type + R"("})";
+        return accessor_count - 1;
+    };
+    auto align = [&binary] {
+        binary.resize((binary.size() + 3) & ~usize{ 3 }, '\0');
+    };
+
+    for (u32 first = 0; first < vertices; first += split ? SPLIT_SIZE : vertices) {
+        auto count = split ? std::min(SPLIT_SIZE, vertices - first) : vertices;
+
+        auto offset = binary.size();
+        for (u32 vertex = 0; vertex < count; vertex++) {
+            auto angle = static_cast<f32>(first + vertex) * 0.001f;
+            for (auto value : { angle, angle * 0.5f, -angle, 0.0f, 1.0f, 0.0f }) {
+                append(binary, value);
+            }
+        }
+        auto interleaved = add_view(offset, binary.size() - offset, 6 * sizeof(f32));
+
+        offset = binary.size();
+        for (u32 vertex = 0; vertex < count; vertex++) {
+            append(binary, static_cast<u16>(vertex * 7));
+            append(binary, static_cast<u16>(vertex * 13));
+        }
+        auto uvs = add_view(offset, binary.size() - offset, 0);
+
+        offset = binary.size();
+        for (u32 vertex = 0; vertex < count; vertex++) {
+            append(binary, static_cast<u32>(vertex * 2654435761u));
+        }
+        auto colors = add_view(offset, binary.size() - offset, 0);
+
+        offset = binary.size();
+        auto wide = count > SPLIT_SIZE;
+        for (u32 index = 0; index < 6 * count; index++) {
+            auto vertex = static_cast<u32>((u64{ index } * 40503u) % count);
+            if (wide) {
+                append(binary, vertex);
+            } else {
+                append(binary, static_cast<u16>(vertex));
+            }
+        }
+        auto indices = add_view(offset, binary.size() - offset, 0);
+        align();
+
+        if (not primitives.empty()) {
+            primitives += ',';
+        }
+        primitives += R"({"attributes":{"POSITION":)" +
+                      std::to_string(add_accessor(interleaved, 0, 5126, false, count, "VEC3")) +
+                      R"(,"NORMAL":)" + std::to_string(add_accessor(interleaved, 12, 5126, false, count, "VEC3")) +
+                      R"(,"TEXCOORD_0":)" + std::to_string(add_accessor(uvs, 0, 5123, true, count, "VEC2")) +
+                      R"(,"COLOR_0":)" + std::to_string(add_accessor(colors, 0, 5121, true, count, "VEC4")) +
+                      R"(},"indices":)" +
+                      std::to_string(add_accessor(indices, 0, wide ? 5125 : 5123, false, 6 * count, "SCALAR")) +
+                      R"(,"mode":4})";
+    }
+
+    auto json = R"({"asset":{"version":"2.0","generator":"realtime-gltf-bench"},"buffers":[{"byteLength":)" +
+                std::to_string(binary.size()) + R"(}],"bufferViews":[)" + views + R"(],"accessors":[)" + accessors +
+                R"(],"meshes":[{"primitives":[)" + primitives + "]}]}";
+    json.resize((json.size() + 3) & ~usize{ 3 }, ' ');
+
+    std::string result{};
+    append(result, u32{ 0x46546C67 });
+    append(result, u32{ 2 });
+    append(result, static_cast<u32>(12 + 8 + json.size() + 8 + binary.size()));
+    append(result, static_cast<u32>(json.size()));
+    append(result, rt::GlbFile::Chunk::Type::JSON);
+    result += json;
+    append(result, static_cast<u32>(binary.size()));
+    append(result, rt::GlbFile::Chunk::Type::BINARY);
+    result += binary;
+    return result;
+}
+
+/// Encodes bytes as base64 text with padding
+/// @param data The bytes
+/// @return The base64 text
+std::string encode_base64(std::string_view data) {
+    constexpr std::string_view ALPHABET = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string result{};
+    result.reserve((data.size() + 2) / 3 * 4);
+    for (usize index = 0; index < data.size(); index += 3) {
+        auto remaining = std::min<usize>(data.size() - index, 3);
+        u32 group = 0;
+        for (usize byte = 0; byte < 3; byte++) {
+            group = group << 8 | (byte < remaining ? static_cast<u8>(data[index + byte]) : 0u);
+        }
+        for (usize character = 0; character < 4; character++) {
+            result.push_back(character <= remaining ? ALPHABET[group >> (18 - 6 * character) & 63] : '=');
+        }
+    }
+    return result;
+}
+
+/// Encodes interleaved vertices like the attribute codec of EXT_meshopt_compression. The zigzag-encoded byte
+/// deltas of a block of vertices are transposed, and every group of sixteen deltas is packed with as few bits
+/// as possible.
+/// @param data The vertices
+/// @param stride The size of a vertex, a multiple of four of at most 256 bytes
+/// @return The encoded stream
+std::string encode_meshopt_attributes(std::string_view data, usize stride) {
+    constexpr usize GROUP_SIZE = 16;
+    auto count = data.size() / stride;
+    auto block_size = std::min((usize{ 8192 } / stride) & ~(GROUP_SIZE - 1), usize{ 256 });
+
+    std::string result(1, static_cast<char>(0xA0));
+    auto last = data.substr(0, stride);
+    std::vector<u8> deltas{};
+    for (usize first = 0; first < count; first += block_size) {
+        auto elements = std::min(block_size, count - first);
+        auto groups = (elements + GROUP_SIZE - 1) / GROUP_SIZE;
+        for (usize byte = 0; byte < stride; byte++) {
+            deltas.assign(groups * GROUP_SIZE, 0);
+            auto previous = static_cast<u8>(last[byte]);
+            for (usize element = 0; element < elements; element++) {
+                auto value = static_cast<u8>(data[(first + element) * stride + byte]);
+                auto delta = static_cast<u8>(value - previous);
+                deltas[element] = static_cast<u8>(delta << 1 ^ static_cast<u8>(static_cast<s8>(delta) >> 7));
+                previous = value;
+            }
+
+            // Every group takes the mode that packs it into the fewest bytes, values that do not fit are escaped
+            std::string header((groups + 3) / 4, '\0');
+            std::string body{};
+            for (usize group = 0; group < groups; group++) {
+                const auto *values = deltas.data() + group * GROUP_SIZE;
+                u32 mode = 3;
+                usize size = GROUP_SIZE;
+                if (std::all_of(values, values + GROUP_SIZE, [](u8 value) { return value == 0; })) {
+                    mode = 0;
+                    size = 0;
+                }
+                for (u32 candidate = 1; candidate < 3 and mode != 0; candidate++) {
+                    auto escape = (1u << candidate * 2) - 1;
+                    auto escapes = std::count_if(values, values + GROUP_SIZE,
+                                                 [escape](u8 value) { return value >= escape; });
+                    auto packed = GROUP_SIZE * candidate / 4 + static_cast<usize>(escapes);
+                    if (packed < size) {
+                        mode = candidate;
+                        size = packed;
+                    }
+                }
+                header[group / 4] = static_cast<char>(header[group / 4] | mode << group % 4 * 2);
+                if (mode == 3) {
+                    body.append(reinterpret_cast<const char *>(values), GROUP_SIZE);
+                } else if (mode != 0) {
+                    auto bits = mode * 2;
+                    auto escape = (1u << bits) - 1;
+                    std::string packed(GROUP_SIZE * bits / 8, '\0');
+                    std::string escaped{};
+                    for (usize index = 0; index < GROUP_SIZE; index++) {
+                        auto value = std::min<u32>(values[index], escape);
+                        if (value == escape) {
+                            escaped.push_back(static_cast<char>(values[index]));
+                        }
+                        auto &target = packed[index * bits / 8];
+                        target = static_cast<char>(target | value << (8 - bits - index * bits % 8));
+                    }
+                    body += packed;
+                    body += escaped;
+                }
+            }
+            result += header;
+            result += body;
+        }
+        last = data.substr((first + elements - 1) * stride, stride);
+    }
+
+    // The tail lets decoders read whole vectors past the last group and ends with the baseline vertex
+    result.append(std::max(stride, usize{ 32 }) - stride, '\0');
+    result.append(data.substr(0, stride));
+    return result;
+}
+
+/// Turns the JSON of a binary glTF file into a glTF file whose single buffer refers to the given URI
+/// @param json The JSON chunk of the GLB file
+/// @param uri The URI of the buffer
+/// @return The JSON text of the glTF file
+std::string with_buffer_uri(std::string_view json, std::string_view uri) {
+    constexpr std::string_view BUFFERS = R"("buffers":[{)";
+    auto result = std::string{ json };
+    result.insert(result.find(BUFFERS) + BUFFERS.size(), R"("uri":")" + std::string{ uri } + R"(",)");
+    return result;
+}
+
+/// Compresses data into a zlib stream of a single block with the fixed Huffman codes, whose matches repeat the
+/// previous pixel or the pixel above, as a simple stand-in for the output of image editors
+/// @param data The data
+/// @param pixel_size The distance of the previous pixel
+/// @param row_size The distance of the pixel above
+/// @return The zlib stream
+std::string compress_fixed(std::string_view data, usize pixel_size, usize row_size) {
+    constexpr u16 LENGTH_BASE[] = { 3,  4,  5,  6,  7,  8,  9,  10, 11,  13,  15,  17,  19,  23, 27,
+                                    31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+    constexpr u8 LENGTH_EXTRA[] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+                                    2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+    constexpr u16 DISTANCE_BASE[] = { 1,    2,    3,    4,    5,    7,     9,     13,    17,  25,
+                                      33,   49,   65,   97,   129,  193,   257,   385,   513, 769,
+                                      1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+
+    std::string result{ "\x78\x01" };
+    u64 bits = 0;
+    u32 count = 0;
+    auto put = [&](u32 value, u32 length) {
+        bits |= u64{ value } << count;
+        for (count += length; count >= 8; count -= 8) {
+            result.push_back(static_cast<char>(bits & 0xFF));
+            bits >>= 8;
+        }
+    };
+    // Huffman codes are packed starting with their most significant bit
+    auto put_code = [&put](u32 code, u32 length) {
+        u32 reversed = 0;
+        for (u32 bit = 0; bit < length; bit++) {
+            reversed = reversed << 1 | (code >> bit & 1);
+        }
+        put(reversed, length);
+    };
+    auto put_symbol = [&put_code](u32 symbol) {
+        if (symbol < 144) {
+            put_code(0x30 + symbol, 8);
+        } else if (symbol < 256) {
+            put_code(0x190 + symbol - 144, 9);
+        } else if (symbol < 280) {
+            put_code(symbol - 256, 7);
+        } else {
+            put_code(0xC0 + symbol - 280, 8);
+        }
+    };
+
+    put(1, 1);
+    put(1, 2);
+    for (usize index = 0; index < data.size();) {
+        usize best_length = 0;
+        usize best_distance = 0;
+        for (auto distance : { pixel_size, row_size }) {
+            if (distance > index or distance > 32768) {
+                continue;
+            }
+            usize length = 0;
+            while (length < 258 and index + length < data.size() and
+                   data[index + length] == data[index + length - distance]) {
+                length++;
+            }
+            if (length > best_length) {
+                best_length = length;
+                best_distance = distance;
+            }
+        }
+        if (best_length < 3) {
+            put_symbol(static_cast<u8>(data[index++]));
+            continue;
+        }
+
+        usize length_symbol = std::size(LENGTH_BASE) - 1;
+        while (LENGTH_BASE[length_symbol] > best_length) {
+            length_symbol--;
+        }
+        put_symbol(257 + static_cast<u32>(length_symbol));
+        put(static_cast<u32>(best_length - LENGTH_BASE[length_symbol]), LENGTH_EXTRA[length_symbol]);
+        usize distance_symbol = std::size(DISTANCE_BASE) - 1;
+        while (DISTANCE_BASE[distance_symbol] > best_distance) {
+            distance_symbol--;
+        }
+        put_code(static_cast<u32>(distance_symbol), 5);
+        put(static_cast<u32>(best_distance - DISTANCE_BASE[distance_symbol]),
+            distance_symbol < 4 ? 0 : static_cast<u32>(distance_symbol / 2 - 1));
+        index += best_length;
+    }
+    put_symbol(256);
+    put(0, 7);
+
+    u32 low = 1;
+    u32 high = 0;
+    for (auto byte : data) {
+        low = (low + static_cast<u8>(byte)) % 65521;
+        high = (high + low) % 65521;
+    }
+    for (auto shift : { 24, 16, 8, 0 }) {
+        result.push_back(static_cast<char>((high << 16 | low) >> shift & 0xFF));
+    }
+    return result;
+}
+
+/// Appends a big-endian 32-bit integer to a buffer
+/// @param buffer The buffer
+/// @param value The value
+void append_big_endian(std::string &buffer, u32 value) {
+    for (auto shift : { 24, 16, 8, 0 }) {
+        buffer.push_back(static_cast<char>(value >> shift & 0xFF));
+    }
+}
+
+/// Generates an RGBA PNG image of a noisy gradient, whose scanlines are filtered with the previous pixel and
+/// the pixel above alternately
+/// @param width The width of the image
+/// @param height The height of the image
+/// @return The bytes of the PNG file
+std::string generate_png(u32 width, u32 height) {
+    auto stride = usize{ width } * 4;
+    std::string raw((stride + 1) * height, '\0');
+    std::string previous(stride, '\0');
+    std::string row(stride, '\0');
+    for (u32 y = 0; y < height; y++) {
+        for (u32 x = 0; x < width; x++) {
+            auto noise = (x * 7919 + y * 104729) >> 5 & 3;
+            row[x * 4 + 0] = static_cast<char>(x * 255 / width + noise);
+            row[x * 4 + 1] = static_cast<char>(y * 255 / height);
+            row[x * 4 + 2] = static_cast<char>((x + y) / 8 + noise);
+            row[x * 4 + 3] = static_cast<char>(255);
+        }
+        auto *filtered = raw.data() + y * (stride + 1);
+        filtered[0] = static_cast<char>(y % 2 == 0 ? 1 : 2);
+        for (usize index = 0; index < stride; index++) {
+            auto predictor = y % 2 == 0 ? (index >= 4 ? row[index - 4] : 0) : previous[index];
+            filtered[index + 1] = static_cast<char>(row[index] - predictor);
+        }
+        std::swap(row, previous);
+    }
+
+    auto chunk = [](std::string &png, std::string_view type, std::string_view data) {
+        append_big_endian(png, static_cast<u32>(data.size()));
+        png += type;
+        png += data;
+        append_big_endian(png, 0);
+    };
+    std::string header{};
+    append_big_endian(header, width);
+    append_big_endian(header, height);
+    header += std::string_view{ "\x08\x06\x00\x00\x00", 5 };
+
+    std::string png{ "\x89PNG\r\n\x1a\n" };
+    chunk(png, "IHDR", header);
+    chunk(png, "IDAT", compress_fixed(raw, 4, stride + 1));
+    chunk(png, "IEND", {});
+    return png;
+}
+
+/// Writes a file
+/// @param path The path of the file
+/// @param data The contents of the file
+/// @return A value that indicates whether the file could be written
+bool write_file(const rt::fs::path &path, std::string_view data) {
+    std::ofstream file{ path, std::ios::binary };
+    file.write(data.data(), static_cast<std::streamsize>(data.size()));
+    return file.good();
+}
+
+/// Measures the average duration of the given function
+/// @param function The function
+/// @return The average duration in seconds, zero if the function failed
+template<typename Function>
+f64 measure(Function &&function) {
+    using Clock = std::chrono::steady_clock;
+    constexpr auto MIN_DURATION = std::chrono::milliseconds{ 250 };
+
+    usize iterations = 0;
+    auto begin = Clock::now();
+    auto elapsed = Clock::duration{};
+    do {
+        if (not function()) {
+            return 0.0;
+        }
+        iterations++;
+        elapsed = Clock::now() - begin;
+    } while (elapsed < MIN_DURATION);
+    return std::chrono::duration<f64>(elapsed).count() / static_cast<f64>(iterations);
+}
+
+}// namespace
+
+int main(int argc, char **argv) {
+    std::vector<u32> sizes{};
+    std::vector<rt::fs::path> files{};
+    for (auto arg = 1; arg < argc; arg++) {
+        auto argument = std::string_view{ argv[arg] };
+        if (auto size = rt::number_from_view<u32>(argument)) {
+            sizes.push_back(*size);
+        } else {
+            files.emplace_back(argument);
+        }
+    }
+    if (sizes.empty() and files.empty()) {
+        sizes = { 1000000, 4000000 };
+    }
+
+    std::vector<std::pair<std::string, rt::fs::path>> samples{};
+    for (const auto &file : files) {
+        samples.emplace_back(file.filename().string(), file);
+    }
+    for (auto size : sizes) {
+        for (auto split : { true, false }) {
+            auto name = std::to_string(size) + (split ? "-split" : "-single");
+            auto path = rt::fs::temp_directory_path() / ("realtime-gltf-bench-" + name + ".glb");
+            if (not write_file(path, generate_glb(size, split))) {
+                std::printf("cannot write %s\n", path.string().c_str());
+                return EXIT_FAILURE;
+            }
+            samples.emplace_back(name, path);
+        }
+    }
+
+    // Importing maps the file, parses its JSON and decodes every primitive into the builder
+    std::printf("%-24s %12s %12s %12s %12s\n", "model", "vertices", "indices", "MB/s", "Mvertices/s");
+    for (const auto &[name, path] : samples) {
+        rt::Mesh::Builder builder{};
+        auto duration = measure([&builder, &path] { return builder.from_gltf(path); });
+        if (duration == 0.0) {
+            std::printf("%-24s %12s %12s %12s %12s\n", name.c_str(), "-", "-", "-", "-");
+            continue;
+        }
+        auto megabytes = static_cast<f64>(rt::fs::file_size(path)) / (1024.0 * 1024.0);
+        std::printf("%-24s %12zu %12zu %12.2f %12.2f\n", name.c_str(), builder.vertices.size(),
+                    builder.indices.size(), megabytes / duration,
+                    static_cast<f64>(builder.vertices.size()) / duration / 1e6);
+    }
+
+    // Every attribute is decoded with every backend, the results must match to the bit
+    using Backend = rt::gltf::AccessorView::Backend;
+    constexpr std::pair<Backend, const char *> BACKENDS[] = {
+        { Backend::SCALAR, "scalar" },
+        { Backend::SSE2, "sse2" },
+    };
+    using Vertex = rt::Mesh::Vertex;
+    struct Attribute {
+        const char *name;
+        usize offset;
+        usize count;
+    };
+    constexpr Attribute ATTRIBUTES[] = {
+        { "position", offsetof(Vertex, position), 3 },
+        { "normal", offsetof(Vertex, normal), 3 },
+        { "texcoord", offsetof(Vertex, uv), 2 },
+        { "color", offsetof(Vertex, color), 3 },
+    };
+
+    std::printf("\n%-24s %-10s %8s %12s %12s\n", "model", "attribute", "backend", "MB/s", "Melements/s");
+    for (const auto &[name, path] : samples) {
+        auto file = rt::GltfFile::read(path);
+        if (not file or file->document.meshes.empty()) {
+            continue;
+        }
+        std::vector<std::vector<u8>> storage{};
+        auto buffer_views = rt::gltf::resolve_views(file->document, file->buffers, storage);
+        if (not buffer_views) {
+            continue;
+        }
+
+        // The first primitive is representative of the whole model
+        const auto *primitive = &file->document.meshes.front().primitives.front();
+        const auto &attributes = primitive->attributes;
+        const std::optional<u32> accessors[] = { attributes.position, attributes.normal, attributes.texcoord_0,
+                                                 attributes.color_0, primitive->indices };
+
+        for (usize attribute = 0; attribute < std::size(accessors); attribute++) {
+            if (not accessors[attribute]) {
+                continue;
+            }
+            auto view = rt::gltf::AccessorView::create(file->document, *buffer_views, *accessors[attribute]);
+            if (not view) {
+                continue;
+            }
+            auto element = view->components * rt::gltf::component_size(view->component_type);
+            auto bytes = static_cast<f64>(view->count * element);
+            auto indices = attribute == std::size(ATTRIBUTES);
+
+            std::vector<Vertex> reference{};
+            std::vector<u32> reference_indices{};
+            for (auto [backend, backend_name] : BACKENDS) {
+                if (not rt::gltf::AccessorView::supported(backend)) {
+                    continue;
+                }
+                std::vector<Vertex> vertices(indices ? 0 : view->count);
+                std::vector<u32> widened(indices ? view->count : 0);
+                auto duration = measure([&] {
+                    if (indices) {
+                        return view->read_indices(widened.data(), 0, std::numeric_limits<u32>::max(), backend);
+                    }
+                    const auto &target = ATTRIBUTES[attribute];
+                    auto *out = reinterpret_cast<f32 *>(reinterpret_cast<u8 *>(vertices.data()) + target.offset);
+                    view->read_floats(out, target.count, sizeof(Vertex), backend);
+                    return true;
+                });
+
+                if (reference.empty() and reference_indices.empty()) {
+                    reference = std::move(vertices);
+                    reference_indices = std::move(widened);
+                } else if (vertices != reference or widened != reference_indices) {
+                    std::printf("%s %s: %s differs from scalar\n", name.c_str(),
+                                indices ? "indices" : ATTRIBUTES[attribute].name, backend_name);
+                    return EXIT_FAILURE;
+                }
+                std::printf("%-24s %-10s %8s %12.2f %12.2f\n", name.c_str(),
+                            indices ? "indices" : ATTRIBUTES[attribute].name, backend_name,
+                            duration > 0.0 ? bytes / duration / (1024.0 * 1024.0) : 0.0,
+                            duration > 0.0 ? static_cast<f64>(view->count) / duration / 1e6 : 0.0);
+            }
+        }
+    }
+
+    // World matrices are updated in one sweep, for a single deep chain as well as a wide binary tree
+    constexpr u32 NODES = 100000;
+    std::printf("\n%-24s %12s %12s %12s\n", "hierarchy", "nodes", "ms", "Mnodes/s");
+    for (auto deep : { true, false }) {
+        rt::Hierarchy hierarchy{};
+        auto local = rt::NodeTransform{};
+        local.translation = { 0.0f, 0.01f, 0.0f };
+        local.rotation = glm::normalize(glm::quat{ 0.999f, 0.0f, 0.04f, 0.0f });
+        for (u32 node = 0; node < NODES; node++) {
+            auto parent = node == 0 ? rt::Hierarchy::NONE : (deep ? node - 1 : (node - 1) / 2);
+            hierarchy.add(parent, local);
+        }
+        auto duration = measure([&hierarchy] {
+            hierarchy.update();
+            return true;
+        });
+        std::printf("%-24s %12u %12.3f %12.2f\n", deep ? "chain" : "binary-tree", NODES, duration * 1e3,
+                    static_cast<f64>(NODES) / duration / 1e6);
+    }
+
+    // Every node of a tree is animated by a translation, rotation and scale channel, whose samplers share a
+    // few timelines of different lengths and cycle through all interpolations
+    constexpr u32 ANIMATED_NODES = 1000;
+    constexpr u32 KEYS[] = { 30, 60, 120, 240 };
+    using AnimationBackend = rt::AnimationClip::Backend;
+    constexpr std::pair<AnimationBackend, const char *> ANIMATION_BACKENDS[] = {
+        { AnimationBackend::SCALAR, "scalar" },
+        { AnimationBackend::SSE2, "sse2" },
+    };
+
+    rt::Hierarchy skeleton{};
+    for (u32 node = 0; node < ANIMATED_NODES; node++) {
+        skeleton.add(node == 0 ? rt::Hierarchy::NONE : (node - 1) / 2, rt::NodeTransform{});
+    }
+    std::vector<f32> times{};
+    std::vector<rt::AnimationClip::Timeline> timelines{};
+    for (auto keys : KEYS) {
+        timelines.push_back({ static_cast<u32>(times.size()), keys });
+        for (u32 key = 0; key < keys; key++) {
+            times.push_back(static_cast<f32>(key) / static_cast<f32>(keys) * 4.0f);
+        }
+    }
+    using Path = rt::AnimationClip::Path;
+    using Interpolation = rt::AnimationClip::Interpolation;
+    constexpr Interpolation INTERPOLATIONS[] = { Interpolation::LINEAR, Interpolation::STEP,
+                                                 Interpolation::CUBICSPLINE };
+    std::vector<rt::AnimationClip::Channel> channels{};
+    std::vector<glm::vec4> values{};
+    for (u32 node = 0; node < ANIMATED_NODES; node++) {
+        for (auto path : { Path::TRANSLATION, Path::ROTATION, Path::SCALE }) {
+            auto timeline = static_cast<u32>(channels.size() % std::size(KEYS));
+            auto interpolation = INTERPOLATIONS[channels.size() % std::size(INTERPOLATIONS)];
+            auto count = timelines[timeline].count * (interpolation == Interpolation::CUBICSPLINE ? 3 : 1);
+            channels.push_back({ node, path, interpolation, timeline, static_cast<u32>(values.size()) });
+            for (u32 value = 0; value < count; value++) {
+                auto angle = static_cast<f32>(value + node) * 0.1f;
+                auto sample = glm::vec4{ std::sin(angle), std::cos(angle), 0.5f, path == Path::ROTATION ? 1.0f : 0.0f };
+                values.push_back(path == Path::ROTATION ? sample * (1.0f / glm::length(sample)) : sample);
+            }
+        }
+    }
+    auto clip = rt::AnimationClip::create(std::move(times), std::move(timelines), channels, values);
+
+    std::printf("\n%-24s %8s %12s %12s %12s\n", "animation", "backend", "channels", "us", "Mchannels/s");
+    std::vector<rt::NodeTransform> reference_locals{};
+    for (auto [backend, backend_name] : ANIMATION_BACKENDS) {
+        if (not rt::AnimationClip::supported(backend)) {
+            continue;
+        }
+        auto time = 0.0f;
+        auto duration = measure([&] {
+            time = time + 0.013f > clip.duration ? 0.0f : time + 0.013f;
+            clip.sample(time, skeleton, backend);
+            return true;
+        });
+        clip.sample(1.234f, skeleton, backend);
+        if (reference_locals.empty()) {
+            reference_locals = skeleton.locals;
+        } else if (not std::equal(reference_locals.begin(), reference_locals.end(), skeleton.locals.begin(),
+                                  [](const auto &a, const auto &b) {
+                                      return a.translation == b.translation and a.rotation == b.rotation and
+                                             a.scale == b.scale;
+                                  })) {
+            std::printf("animation: %s differs from scalar\n", backend_name);
+            return EXIT_FAILURE;
+        }
+        std::printf("%-24s %8s %12zu %12.3f %12.2f\n", "tree", backend_name, clip.channel_count(), duration * 1e6,
+                    static_cast<f64>(clip.channel_count()) / duration / 1e6);
+    }
+
+    // Vertices are skinned by four joints each, as most exporters limit them, into a separate array that stands
+    // in for mapped vertex memory
+    constexpr u32 SKINNED_VERTICES = 100000;
+    constexpr u32 JOINTS = 64;
+    skeleton.update();
+    auto skin = rt::Skin{};
+    for (u32 joint = 0; joint < JOINTS; joint++) {
+        skin.joints.push_back(joint);
+        skin.inverse_bind_matrices.push_back(glm::inverse(skeleton.worlds[joint]));
+    }
+    auto skinned = rt::SkinnedVertices{ {}, {}, {}, JOINTS };
+    for (u32 vertex = 0; vertex < SKINNED_VERTICES; vertex++) {
+        auto angle = static_cast<f32>(vertex) * 0.001f;
+        skinned.bind_pose.push_back({ { std::sin(angle), std::cos(angle), angle }, { 1.0f, 1.0f, 1.0f },
+                                      { std::cos(angle), 0.0f, std::sin(angle) }, { angle, angle } });
+        auto &influence = skinned.influences.emplace_back();
+        influence.joints = { static_cast<u16>(vertex % JOINTS), static_cast<u16>((vertex + 1) % JOINTS),
+                             static_cast<u16>((vertex + 7) % JOINTS), static_cast<u16>((vertex + 31) % JOINTS) };
+        influence.weights = { 0.4f, 0.3f, 0.2f, 0.1f };
+    }
+    clip.sample(2.5f, skeleton);
+    skeleton.update();
+
+    std::printf("\n%-24s %8s %12s %12s %12s\n", "skinning", "backend", "vertices", "ms", "Mvertices/s");
+    std::vector<Vertex> reference_vertices{};
+    for (auto [backend, backend_name] : ANIMATION_BACKENDS) {
+        if (not rt::AnimationClip::supported(backend)) {
+            continue;
+        }
+        std::vector<glm::mat4> palette(JOINTS);
+        std::vector<Vertex> vertices(SKINNED_VERTICES);
+        auto duration = measure([&] {
+            skin.compute_palette(skeleton, 0, palette, backend);
+            skinned.skin(palette, vertices, backend);
+            return true;
+        });
+        if (reference_vertices.empty()) {
+            reference_vertices = std::move(vertices);
+        } else if (vertices != reference_vertices) {
+            std::printf("skinning: %s differs from scalar\n", backend_name);
+            return EXIT_FAILURE;
+        }
+        std::printf("%-24s %8s %12u %12.3f %12.2f\n", "four-joints", backend_name, SKINNED_VERTICES, duration * 1e3,
+                    static_cast<f64>(SKINNED_VERTICES) / duration / 1e6);
+    }
+
+    // Facial rigs displace small, mostly contiguous regions of a mesh with many targets, of which only a few
+    // change their weight from frame to frame
+    constexpr u32 MORPHED_VERTICES = 50000;
+    constexpr u32 MORPH_TARGETS = 64;
+    constexpr u32 REGION = 1000;
+    auto morph = rt::MorphTargets{};
+    morph.base = std::vector<Vertex>(MORPHED_VERTICES);
+    for (u32 target = 0; target < MORPH_TARGETS; target++) {
+        auto first = static_cast<u32>(morph.vertices.size());
+        auto start = target * 7919 % (MORPHED_VERTICES - REGION);
+        for (u32 vertex = start; vertex < start + REGION; vertex += 1 + vertex % 3) {
+            morph.vertices.push_back(vertex);
+            morph.positions.push_back({ 0.01f, 0.02f, 0.0f });
+            morph.normals.push_back({ 0.0f, 0.1f, 0.0f });
+        }
+        morph.targets.push_back({ first, static_cast<u32>(morph.vertices.size()) - first });
+    }
+    morph.weights.assign(MORPH_TARGETS, 0.0f);
+
+    std::printf("\n%-24s %12s %12s %12s %12s\n", "morph", "changed", "vertices", "ranges", "us");
+    for (auto changed : { 1u, 8u, MORPH_TARGETS }) {
+        std::vector<Vertex> vertices = morph.base;
+        std::vector<f32> current(MORPH_TARGETS, 0.0f);
+        std::vector<f32> weights(MORPH_TARGETS, 0.5f);
+        std::vector<rt::Mesh::VertexRange> dirty{};
+        auto frame = 0u;
+        auto duration = measure([&] {
+            for (u32 target = 0; target < changed; target++) {
+                weights[(frame + target) % MORPH_TARGETS] = static_cast<f32>(frame % 100) * 0.01f;
+            }
+            frame++;
+            dirty.clear();
+            morph.blend(weights, current, vertices, dirty);
+            return true;
+        });
+        usize written = 0;
+        for (const auto &range : dirty) {
+            written += range.count;
+        }
+        std::printf("%-24s %12u %12zu %12zu %12.3f\n", "sparse", changed, written, dirty.size(), duration * 1e6);
+    }
+
+    // Data URIs are decoded with every backend, the results must match to the bit
+    using Base64Backend = rt::Base64Decoder::Backend;
+    constexpr std::pair<Base64Backend, const char *> BASE64_BACKENDS[] = {
+        { Base64Backend::SCALAR, "scalar" },
+        { Base64Backend::SSSE3, "ssse3" },
+    };
+    constexpr usize BASE64_SIZE = 48 << 20;
+    std::string payload(BASE64_SIZE, '\0');
+    for (usize index = 0; index < payload.size(); index++) {
+        payload[index] = static_cast<char>(index * 2654435761u >> 13);
+    }
+    auto text = encode_base64(payload);
+
+    std::printf("\n%-24s %8s %12s %12s\n", "base64", "backend", "MB", "MB/s");
+    for (auto [backend, backend_name] : BASE64_BACKENDS) {
+        if (not rt::Base64Decoder::supported(backend)) {
+            continue;
+        }
+        std::vector<u8> decoded(BASE64_SIZE);
+        auto duration = measure([&] { return rt::Base64Decoder::decode(text, decoded, backend); });
+        if (duration == 0.0 or std::memcmp(decoded.data(), payload.data(), payload.size()) != 0) {
+            std::printf("%-24s %8s mismatch\n", "decode", backend_name);
+            return EXIT_FAILURE;
+        }
+        auto megabytes = static_cast<f64>(text.size()) / (1024.0 * 1024.0);
+        std::printf("%-24s %8s %12.2f %12.2f\n", "decode", backend_name, megabytes, megabytes / duration);
+    }
+
+    // Vertices are compressed like gltfpack does, once with quantized attributes and once with floats, and decoded
+    // with every backend, the results must match the original vertices to the bit
+    using MeshoptBackend = rt::gltf::MeshoptDecoder::Backend;
+    constexpr std::pair<MeshoptBackend, const char *> MESHOPT_BACKENDS[] = {
+        { MeshoptBackend::SCALAR, "scalar" },
+        { MeshoptBackend::SSSE3, "ssse3" },
+    };
+    constexpr u32 MESHOPT_VERTICES = 1 << 20;
+    constexpr u32 MESHOPT_WIDTH = 1024;
+    std::string quantized{};
+    std::string floats{};
+    for (u32 vertex = 0; vertex < MESHOPT_VERTICES; vertex++) {
+        auto x = vertex % MESHOPT_WIDTH;
+        auto y = vertex / MESHOPT_WIDTH;
+        auto height = std::sin(static_cast<f32>(x) * 0.02f) * std::cos(static_cast<f32>(y) * 0.03f);
+        auto normal = glm::normalize(glm::vec3{ -std::cos(static_cast<f32>(x) * 0.02f), 4.0f, 0.5f });
+
+        // 16-bit positions padded to four components, 8-bit normals and 16-bit texture coordinates
+        append(quantized, static_cast<u16>(x * 64));
+        append(quantized, static_cast<u16>((height + 1.0f) * 32767.0f));
+        append(quantized, static_cast<u16>(y * 64));
+        append(quantized, u16{ 0 });
+        for (auto component : { normal.x, normal.y, normal.z, 0.0f }) {
+            append(quantized, static_cast<s8>(std::round(component * 127.0f)));
+        }
+        append(quantized, static_cast<u16>(x * 64));
+        append(quantized, static_cast<u16>(y * 64));
+
+        append(floats, glm::vec3{ static_cast<f32>(x) * 0.01f, height, static_cast<f32>(y) * 0.01f });
+        append(floats, normal);
+    }
+    struct Stream {
+        const char *name;
+        std::string_view vertices;
+        usize stride;
+    };
+    const Stream streams[] = {
+        { "quantized", quantized, 16 },
+        { "float", floats, 24 },
+    };
+
+    std::printf("\n%-24s %8s %12s %12s %12s\n", "meshopt", "backend", "MB", "ratio", "MB/s");
+    for (const auto &[stream_name, vertices, stride] : streams) {
+        auto compressed = encode_meshopt_attributes(vertices, stride);
+        auto compression = rt::gltf::MeshoptDecoder::Compression{
+            0,
+            0,
+            static_cast<u32>(compressed.size()),
+            static_cast<u32>(stride),
+            MESHOPT_VERTICES,
+            rt::gltf::MeshoptDecoder::Compression::Mode::ATTRIBUTES,
+        };
+        auto data = std::span{ reinterpret_cast<const u8 *>(compressed.data()), compressed.size() };
+        auto megabytes = static_cast<f64>(vertices.size()) / (1024.0 * 1024.0);
+        for (auto [backend, backend_name] : MESHOPT_BACKENDS) {
+            if (not rt::gltf::MeshoptDecoder::supported(backend)) {
+                continue;
+            }
+            std::vector<u8> decoded(vertices.size());
+            auto duration = measure(
+                    [&] { return rt::gltf::MeshoptDecoder::decode(compression, data, decoded, backend); });
+            if (duration == 0.0 or std::memcmp(decoded.data(), vertices.data(), vertices.size()) != 0) {
+                std::printf("%-24s %8s mismatch\n", stream_name, backend_name);
+                return EXIT_FAILURE;
+            }
+            std::printf("%-24s %8s %12.2f %12.2f %12.2f\n", stream_name, backend_name, megabytes,
+                        static_cast<f64>(vertices.size()) / static_cast<f64>(compressed.size()), megabytes / duration);
+        }
+    }
+
+    // The first generated model is imported from JSON as well, with its buffer in a separate file and embedded
+    // as a data URI
+    std::vector<rt::fs::path> temporaries{};
+    if (not sizes.empty()) {
+        auto name = std::to_string(sizes.front()) + "-split";
+        auto directory = rt::fs::temp_directory_path();
+        auto glb = rt::GlbFile::read(directory / ("realtime-gltf-bench-" + name + ".glb"));
+        if (not glb) {
+            std::printf("cannot read %s\n", name.c_str());
+            return EXIT_FAILURE;
+        }
+        auto binary = std::string_view{ reinterpret_cast<const char *>(glb->binary().data()), glb->binary().size() };
+        auto bin = "realtime-gltf-bench-" + name + ".bin";
+        const std::pair<rt::fs::path, std::string> variants[] = {
+            { directory / bin, std::string{ binary } },
+            { directory / ("realtime-gltf-bench-" + name + "-external.gltf"), with_buffer_uri(glb->json(), bin) },
+            { directory / ("realtime-gltf-bench-" + name + "-embedded.gltf"),
+              with_buffer_uri(glb->json(), "data:application/octet-stream;base64," + encode_base64(binary)) },
+        };
+        for (const auto &[path, data] : variants) {
+            if (not write_file(path, data)) {
+                std::printf("cannot write %s\n", path.string().c_str());
+                return EXIT_FAILURE;
+            }
+            temporaries.push_back(path);
+        }
+
+        // The size of the external variant includes its buffer
+        struct Variant {
+            const char *name;
+            rt::fs::path path;
+            usize size;
+        };
+        const Variant imports[] = {
+            { "external", variants[1].first, variants[0].second.size() + variants[1].second.size() },
+            { "embedded", variants[2].first, variants[2].second.size() },
+        };
+
+        std::printf("\n%-24s %12s %12s %12s\n", "gltf", "MB", "ms", "MB/s");
+        for (const auto &[variant, path, size] : imports) {
+            rt::Mesh::Builder builder{};
+            auto duration = measure([&builder, &path] { return builder.from_gltf(path); });
+            if (duration == 0.0) {
+                std::printf("%-24s %12s %12s %12s\n", variant, "-", "-", "-");
+                continue;
+            }
+            auto megabytes = static_cast<f64>(size) / (1024.0 * 1024.0);
+            std::printf("%-24s %12.2f %12.3f %12.2f\n", variant, megabytes, duration * 1e3, megabytes / duration);
+        }
+    }
+
+    // Images are decoded like the texture loader does on its worker threads
+    constexpr u32 IMAGE_SIZE = 2048;
+    auto png = generate_png(IMAGE_SIZE, IMAGE_SIZE);
+    auto encoded = std::span{ reinterpret_cast<const u8 *>(png.data()), png.size() };
+    std::printf("\n%-24s %12s %12s %12s %12s\n", "image", "MB", "ms", "MB/s", "Mpixels/s");
+    auto image = std::optional<rt::Image>{};
+    auto duration = measure([&] {
+        image = rt::Image::decode(encoded);
+        return image.has_value();
+    });
+    if (duration == 0.0) {
+        std::printf("%-24s cannot decode\n", "png");
+        return EXIT_FAILURE;
+    }
+    auto decoded_megabytes = static_cast<f64>(image->pixels.size()) / (1024.0 * 1024.0);
+    std::printf("%-24s %12.2f %12.3f %12.2f %12.2f\n", "png", static_cast<f64>(png.size()) / (1024.0 * 1024.0),
+                duration * 1e3, decoded_megabytes / duration,
+                static_cast<f64>(IMAGE_SIZE) * IMAGE_SIZE / duration / 1e6);
+
+    for (auto size : sizes) {
+        for (auto split : { "split", "single" }) {
+            temporaries.push_back(rt::fs::temp_directory_path() /
+                                  ("realtime-gltf-bench-" + std::to_string(size) + "-" + split + ".glb"));
+        }
+    }
+    for (const auto &path : temporaries) {
+        std::error_code error{};
+        rt::fs::remove(path, error);
+    }
+    return EXIT_SUCCESS;
+}
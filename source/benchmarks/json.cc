@@ -0,0 +1,646 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Elias Engelbert Plank
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <new>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+// The process status API must follow the Windows header
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#include <realtime/gltf.h>
+#include <realtime/json.h>
+#include <realtime/json_document.h>
+#include <realtime/json_handler.h>
+#include <realtime/json_pointer.h>
+#include <realtime/json_records.h>
+#include <realtime/json_stream.h>
+#include <realtime/json_tape.h>
+#include <realtime/json_writer.h>
+
+namespace {
+
+/// Global allocation statistics, gathered by the replaced operator new and delete
+struct AllocationStats {
+    usize count;
+    usize current;
+    usize peak;
+} allocation_stats{};
+
+/// Every allocation is prefixed with its size so that the current footprint can be tracked
+constexpr usize ALLOCATION_HEADER = alignof(std::max_align_t);
+
+/// Generates a glTF-like accessor
+/// @param index The index of the accessor
+/// @return The stringified accessor
+std::string generate_accessor(usize index) {
+    return R"({"bufferView":)" + std::to_string(index % 64) + R"(,"byteOffset":)" + std::to_string(index * 12) +
+           R"(,"componentType":5126,"count":)" + std::to_string(index + 3) +
+           R"(,"type":"VEC3","normalized":false,"max":[1.0,0.5e1,-2.25],"min":[-1.0,-0.5E-1,2.25],)" +
+           R"("name":"accessor \")" + std::to_string(index) + R"(\"\n"})";
+}
+
+/// Generates a glTF-like JSON document of roughly the given size
+/// @param size The approximate size of the document in bytes
+/// @return The stringified JSON document
+std::string generate_document(usize size) {
+    std::string result = R"({"asset":{"version":"2.0","generator":"realtime-json-bench"},"accessors":[)";
+    for (usize index = 0; result.size() < size; index++) {
+        if (index > 0) {
+            result += ',';
+        }
+        result += generate_accessor(index);
+    }
+    result += "]}";
+    return result;
+}
+
+/// Generates JSON Lines of glTF-like accessors of roughly the given size
+/// @param size The approximate size of the data in bytes
+/// @return The JSON Lines data
+std::string generate_lines(usize size) {
+    std::string result{};
+    for (usize index = 0; result.size() < size; index++) {
+        result += generate_accessor(index);
+        result += '\n';
+    }
+    return result;
+}
+
+/// Generates a JSON document with a single array of numbers, like inline matrices or animation data
+/// @param size The approximate size of the document in bytes
+/// @return The stringified JSON document
+std::string generate_numbers(usize size) {
+    std::string result = R"({"data":[)";
+    for (usize index = 0; result.size() < size; index++) {
+        if (index > 0) {
+            result += ',';
+        }
+        result += std::to_string(static_cast<f64>(index) * 0.25);
+    }
+    result += "]}";
+    return result;
+}
+
+/// Generates a JSON document that alternately nests objects and arrays with a single child each
+/// @param depth The number of nested objects
+/// @return The stringified JSON document
+std::string generate_nested(usize depth) {
+    std::string result{};
+    for (usize level = 0; level < depth; level++) {
+        result += R"({"child":[)";
+    }
+    result += "true";
+    for (usize level = 0; level < depth; level++) {
+        result += "]}";
+    }
+    return result;
+}
+
+/// Generates a JSON document of records that are each nested 32 levels deep
+/// @param size The approximate size of the document in bytes
+/// @return The stringified JSON document
+std::string generate_deep(usize size) {
+    constexpr usize RECORD_DEPTH = 32;
+    auto record = generate_nested(RECORD_DEPTH);
+    std::string result = R"({"records":[)";
+    for (usize index = 0; result.size() < size; index++) {
+        if (index > 0) {
+            result += ',';
+        }
+        result += record;
+    }
+    result += "]}";
+    return result;
+}
+
+/// Generates a JSON document of strings with plain ASCII runs, escape sequences and multi-byte UTF-8
+/// @param size The approximate size of the document in bytes
+/// @return The stringified JSON document
+std::string generate_strings(usize size) {
+    constexpr const char *FRAGMENTS[] = {
+        "The quick brown fox jumps over the lazy dog. ",
+        R"(C:\\assets\\textures\\albedo.png )",
+        R"(\"quoted\" \t tabbed \n )",
+        "caf\u00e9 na\u00efve \u65e5\u672c\u8a9e ",
+        R"(\u00e9\u65e5\ud83d\ude00 )",
+    };
+    std::string result = R"({"strings":[)";
+    for (usize index = 0; result.size() < size; index++) {
+        if (index > 0) {
+            result += ',';
+        }
+        result += '"';
+        for (usize fragment = 0; fragment <= index % 7; fragment++) {
+            result += FRAGMENTS[(index + fragment) % std::size(FRAGMENTS)];
+        }
+        result += '"';
+    }
+    result += "]}";
+    return result;
+}
+
+/// A document of the benchmark corpus
+struct Sample {
+    std::string name;
+    std::string data;
+};
+
+/// Generates the synthetic corpus for the given size
+/// @param size The approximate size of every document in bytes
+/// @return The generated documents
+std::vector<Sample> generate_corpus(usize size) {
+    auto suffix = "-" + std::to_string(size);
+    return {
+        { "gltf" + suffix, generate_document(size) },
+        { "deep" + suffix, generate_deep(size) },
+        { "strings" + suffix, generate_strings(size) },
+        { "numbers" + suffix, generate_numbers(size) },
+    };
+}
+
+/// Loads the JSON documents at the given path into the corpus. Directories are searched recursively for
+/// .json and .gltf files, whose whole content is used, and .glb files, whose JSON chunk is used.
+/// @param path The path to a file or directory
+/// @param corpus The corpus
+void load_corpus(const rt::fs::path &path, std::vector<Sample> &corpus) {
+    std::error_code error{};
+    if (rt::fs::is_directory(path, error)) {
+        for (const auto &entry : rt::fs::recursive_directory_iterator{ path, error }) {
+            if (entry.is_regular_file(error)) {
+                load_corpus(entry.path(), corpus);
+            }
+        }
+        return;
+    }
+
+    auto extension = path.extension();
+    if (extension != ".json" and extension != ".gltf" and extension != ".glb") {
+        return;
+    }
+    auto content = rt::read_file(path, std::ios::binary);
+    if (not content) {
+        return;
+    }
+    if (extension == ".glb") {
+        // The JSON chunk follows the 12 byte header and its own 8 byte length and type
+        constexpr usize HEADER_SIZE = 12;
+        constexpr usize JSON_CHUNK_OFFSET = 20;
+        u32 length = 0;
+        if (content->size() < JSON_CHUNK_OFFSET) {
+            return;
+        }
+        std::memcpy(&length, content->data() + HEADER_SIZE, sizeof(length));
+        if (length > content->size() - JSON_CHUNK_OFFSET) {
+            return;
+        }
+        *content = content->substr(JSON_CHUNK_OFFSET, length);
+    }
+    corpus.push_back({ path.filename().string(), std::move(*content) });
+}
+
+/// Retrieves the peak resident set size of the process, which only ever grows
+/// @return The peak resident set size in kilobytes
+usize peak_rss() {
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters{};
+    if (K32GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return counters.PeakWorkingSetSize / 1024;
+    }
+    return 0;
+#else
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+    return static_cast<usize>(usage.ru_maxrss) / 1024;
+#else
+    return static_cast<usize>(usage.ru_maxrss);
+#endif
+#endif
+}
+
+/// Measures the throughput of the given function in megabytes per second
+/// @param data The data that is processed by the function
+/// @param function The function
+/// @return The throughput in megabytes per second
+template<typename Function>
+f64 throughput(std::string_view data, Function &&function) {
+    using Clock = std::chrono::steady_clock;
+    constexpr auto MIN_DURATION = std::chrono::milliseconds{ 250 };
+
+    usize iterations = 0;
+    auto begin = Clock::now();
+    auto elapsed = Clock::duration{};
+    do {
+        if (not function(data)) {
+            return 0.0;
+        }
+        iterations++;
+        elapsed = Clock::now() - begin;
+    } while (elapsed < MIN_DURATION);
+
+    auto seconds = std::chrono::duration<f64>(elapsed).count();
+    auto megabytes = static_cast<f64>(data.size() * iterations) / (1024.0 * 1024.0);
+    return megabytes / seconds;
+}
+
+/// Measures the number of allocations and the peak heap usage of the given function
+/// @param data The data that is processed by the function
+/// @param function The function
+/// @return The allocation statistics, the peak is relative to the heap usage before the call
+template<typename Function>
+AllocationStats allocations(std::string_view data, Function &&function) {
+    auto before = allocation_stats;
+    allocation_stats.peak = allocation_stats.current;
+    function(data);
+    auto result = AllocationStats{ allocation_stats.count - before.count, 0,
+                                   allocation_stats.peak - before.current };
+    allocation_stats.peak = std::max(before.peak, allocation_stats.peak);
+    return result;
+}
+
+/// Sums the count of every accessor and skips all other values that are not needed for that
+class AccessorCounter final : public rt::JsonHandler {
+public:
+    Action on_key(std::string_view key) override {
+        counting = key == "count";
+        return counting or key == "accessors" ? Action::CONTINUE : Action::SKIP;
+    }
+
+    Action on_number(f64 number) override {
+        if (counting) {
+            total += number;
+        }
+        return Action::CONTINUE;
+    }
+
+    f64 total = 0.0;
+
+private:
+    bool counting = false;
+};
+
+}// namespace
+
+/// Replaces the global allocation functions to gather allocation statistics
+void *operator new(usize size) {
+    auto *block = static_cast<u8 *>(std::malloc(size + ALLOCATION_HEADER));
+    if (not block) {
+        throw std::bad_alloc{};
+    }
+    *reinterpret_cast<usize *>(block) = size;
+    allocation_stats.count++;
+    allocation_stats.current += size;
+    allocation_stats.peak = std::max(allocation_stats.peak, allocation_stats.current);
+    return block + ALLOCATION_HEADER;
+}
+
+/// Replaces the global allocation functions to gather allocation statistics
+void operator delete(void *pointer) noexcept {
+    if (pointer) {
+        auto *block = static_cast<u8 *>(pointer) - ALLOCATION_HEADER;
+        allocation_stats.current -= *reinterpret_cast<usize *>(block);
+        std::free(block);
+    }
+}
+
+/// Replaces the global allocation functions to gather allocation statistics
+void operator delete(void *pointer, usize) noexcept {
+    operator delete(pointer);
+}
+
+int main(int argc, char **argv) {
+    std::vector<usize> sizes{};
+    std::vector<Sample> corpus{};
+    std::optional<rt::fs::path> results{};
+    std::optional<rt::fs::path> dump{};
+    for (auto arg = 1; arg < argc; arg++) {
+        auto argument = std::string_view{ argv[arg] };
+        if (argument == "--json" and arg + 1 < argc) {
+            results = argv[++arg];
+        } else if (argument == "--dump" and arg + 1 < argc) {
+            dump = argv[++arg];
+        } else if (auto size = rt::number_from_view<usize>(argument)) {
+            sizes.push_back(*size);
+        } else {
+            load_corpus(argument, corpus);
+        }
+    }
+    if (sizes.empty()) {
+        sizes = { 1024, 1024 * 1024, 100 * 1024 * 1024 };
+    }
+    for (auto size : sizes) {
+        auto generated = generate_corpus(size);
+        std::move(generated.begin(), generated.end(), std::back_inserter(corpus));
+    }
+
+    // The corpus doubles as the seed corpus of the fuzzer
+    if (dump) {
+        std::error_code error{};
+        rt::fs::create_directories(*dump, error);
+        for (const auto &sample : corpus) {
+            std::ofstream file{ *dump / (sample.name + ".json"), std::ios::binary };
+            file.write(sample.data.data(), static_cast<std::streamsize>(sample.data.size()));
+        }
+        return EXIT_SUCCESS;
+    }
+
+    auto parse_json = [](std::string_view data) { return rt::Json::parse(data).has_value(); };
+    auto parse_tape = [](std::string_view data) { return rt::JsonTape::parse(data).has_value(); };
+    auto count_accessors = [](std::string_view data) {
+        AccessorCounter counter;
+        return counter.parse(data);
+    };
+    auto stream_accessors = [](std::string_view data) {
+        constexpr usize CHUNK_SIZE = 64 * 1024;
+        AccessorCounter counter;
+        rt::JsonStreamParser parser{ counter };
+        for (usize offset = 0; offset < data.size(); offset += CHUNK_SIZE) {
+            parser.feed(data.substr(offset, CHUNK_SIZE));
+        }
+        return parser.finish() == rt::JsonStreamParser::Status::DONE;
+    };
+
+    using Mode = std::pair<const char *, std::function<bool(std::string_view)>>;
+    const std::vector<Mode> modes = {
+        { "tokenize", [](std::string_view data) { return not rt::detail::JsonLexer::tokenize(data).empty(); } },
+        { "parse", parse_json },
+        { "document", [](std::string_view data) { return rt::JsonDocument::parse(data).has_value(); } },
+        { "view", [](std::string_view data) { return rt::JsonDocument::view(data).has_value(); } },
+        { "tape", parse_tape },
+        { "handler", count_accessors },
+        { "stream", stream_accessors },
+        { "binding", [](std::string_view data) { return rt::gltf::Document::parse(data).has_value(); } },
+        { "rewrite",
+          [](std::string_view data) {
+              rt::JsonWriter writer;
+              return writer.parse(data);
+          } },
+    };
+
+    // Every document is run through every mode, modes that reject a document, like the glTF binding on
+    // anything but glTF, are reported as failed. The allocations and the peak heap usage are those of a
+    // single run, the peak resident set size is that of the whole process so far.
+    std::string lines{};
+    std::printf("%-24s %-10s %12s %12s %12s %12s %12s\n", "document", "mode", "size", "MB/s", "allocs",
+                "peak KB", "RSS KB");
+    for (const auto &sample : corpus) {
+        for (const auto &[mode, function] : modes) {
+            auto speed = throughput(sample.data, function);
+            auto heap = allocations(sample.data, function);
+            auto rss = peak_rss();
+            if (speed > 0.0) {
+                std::printf("%-24s %-10s %12zu %12.2f %12zu %12zu %12zu\n", sample.name.c_str(), mode,
+                            sample.data.size(), speed, heap.count, heap.peak / 1024, rss);
+            } else {
+                std::printf("%-24s %-10s %12zu %12s %12s %12s %12zu\n", sample.name.c_str(), mode, sample.data.size(),
+                            "-", "-", "-", rss);
+            }
+
+            rt::JsonWriter writer;
+            writer.on_object_begin();
+            writer.on_key("document");
+            writer.on_string_view(sample.name);
+            writer.on_key("mode");
+            writer.on_string_view(mode);
+            writer.on_key("size");
+            writer.on_number(static_cast<f64>(sample.data.size()));
+            writer.on_key("ok");
+            writer.on_bool(speed > 0.0);
+            writer.on_key("mb_per_s");
+            writer.on_number(speed);
+            writer.on_key("allocations");
+            writer.on_number(static_cast<f64>(heap.count));
+            writer.on_key("peak_heap_kb");
+            writer.on_number(static_cast<f64>(heap.peak / 1024));
+            writer.on_key("peak_rss_kb");
+            writer.on_number(static_cast<f64>(rss));
+            writer.on_object_end();
+            lines += writer.output();
+            lines += '\n';
+        }
+    }
+    if (results) {
+        std::ofstream file{ *results, std::ios::binary };
+        file.write(lines.data(), static_cast<std::streamsize>(lines.size()));
+        if (not file.good()) {
+            std::printf("cannot write %s\n", results->string().c_str());
+            return EXIT_FAILURE;
+        }
+    }
+
+    using Backend = rt::detail::JsonIndexer::Backend;
+    constexpr std::pair<Backend, const char *> BACKENDS[] = {
+        { Backend::SCALAR, "scalar" },
+        { Backend::SSE2, "sse2" },
+        { Backend::AVX2, "avx2" },
+    };
+
+    std::printf("\n%12s %8s %16s %16s\n", "size", "backend", "index MB/s", "tokenize MB/s");
+    for (auto size : sizes) {
+        auto document = generate_document(size);
+        for (auto [backend, name] : BACKENDS) {
+            if (not rt::detail::JsonIndexer::supported(backend)) {
+                continue;
+            }
+            auto index = throughput(document, [backend](std::string_view data) {
+                return rt::detail::JsonIndexer::index(data, backend).has_value();
+            });
+            auto tokenize = throughput(document, [backend](std::string_view data) {
+                return not rt::detail::JsonLexer{ data, backend }.tokenize().empty();
+            });
+            std::printf("%12zu %8s %16.2f %16.2f\n", document.size(), name, index, tokenize);
+        }
+    }
+
+    std::printf("\n%12s %16s %16s %16s\n", "size", "rewrite MB/s", "pretty MB/s", "serialize MB/s");
+    for (auto size : sizes) {
+        auto document = generate_document(size);
+        auto rewrite = throughput(document, [](std::string_view data) {
+            rt::JsonWriter writer;
+            return writer.parse(data);
+        });
+        auto pretty = throughput(document, [](std::string_view data) {
+            rt::JsonWriter writer{ rt::JsonWriter::Style::PRETTY };
+            return writer.parse(data);
+        });
+
+        // Serializing the tree is measured against the size of the data it was parsed from
+        auto json = rt::Json::parse(document);
+        auto serialize = throughput(document, [&json](std::string_view) {
+            return not rt::JsonWriter::serialize(*json).empty();
+        });
+        std::printf("%12zu %16.2f %16.2f %16.2f\n", document.size(), rewrite, pretty, serialize);
+    }
+
+    // A warm start maps the cached tape and only hashes the data instead of lexing and parsing it
+    auto cache = rt::fs::temp_directory_path() / "realtime-json-bench.tape";
+    std::printf("\n%12s %16s %16s\n", "size", "tape MB/s", "cached MB/s");
+    for (auto size : sizes) {
+        auto document = generate_document(size);
+        auto tape = rt::JsonTape::parse(document);
+        if (not tape or not tape->save(cache)) {
+            return EXIT_FAILURE;
+        }
+        auto parse = throughput(document, parse_tape);
+        auto load = throughput(document, [&cache](std::string_view data) {
+            return rt::JsonTape::load(data, cache).has_value();
+        });
+        std::printf("%12zu %16.2f %16.2f\n", document.size(), parse, load);
+    }
+    std::error_code error{};
+    rt::fs::remove(cache, error);
+
+    // Queries are measured against the size of the data the queried tree or tape was parsed from
+    auto buffer_views = rt::JsonPointer::compile("/accessors/*/bufferView");
+    std::printf("\n%12s %16s %16s %16s\n", "size", "get MB/s", "pointer MB/s", "tape pointer MB/s");
+    for (auto size : sizes) {
+        auto document = generate_document(size);
+        auto json = rt::Json::parse(document);
+        auto tape = rt::JsonTape::parse(document);
+        auto get = throughput(document, [&json](std::string_view) {
+            f64 sum = 0.0;
+            if (auto *accessors = json->get("accessors").as<rt::Json::Array>()) {
+                for (auto &accessor : *accessors) {
+                    if (auto *object = accessor.as<rt::Json>()) {
+                        sum += object->get("bufferView").as<rt::Json::Number>().value_or(0.0);
+                    }
+                }
+            }
+            return sum >= 0.0;
+        });
+        auto pointer = throughput(document, [&json, &buffer_views](std::string_view) {
+            f64 sum = 0.0;
+            buffer_views->for_each(*json, [&sum](const rt::Json::Value &value) {
+                sum += value.as<rt::Json::Number>().value_or(0.0);
+            });
+            return sum >= 0.0;
+        });
+        auto tape_pointer = throughput(document, [&tape, &buffer_views](std::string_view) {
+            f64 sum = 0.0;
+            buffer_views->for_each(*tape, [&sum](rt::JsonTape::Value value) { sum += value.number().value_or(0.0); });
+            return sum >= 0.0;
+        });
+        std::printf("%12zu %16.2f %16.2f %16.2f\n", document.size(), get, pointer, tape_pointer);
+    }
+
+    auto parse_record = [](std::string_view record) { return rt::JsonTape::parse(record); };
+    std::vector<usize> thread_counts = { 1 };
+    for (usize count = 2; count < std::thread::hardware_concurrency(); count *= 2) {
+        thread_counts.push_back(count);
+    }
+    if (std::thread::hardware_concurrency() > 1) {
+        thread_counts.push_back(std::thread::hardware_concurrency());
+    }
+
+    std::printf("\n%12s %8s %16s %16s\n", "size", "threads", "lines MB/s", "array MB/s");
+    for (auto size : sizes) {
+        auto lines = generate_lines(size);
+        // Every line ends with a line break, which turns into the separators and the closing bracket
+        auto array = "[" + lines;
+        std::replace(array.begin(), array.end(), '\n', ',');
+        array.back() = ']';
+
+        for (auto count : thread_counts) {
+            rt::ThreadPool pool{ count };
+            auto parse_lines = throughput(lines, [&pool, &parse_record](std::string_view data) {
+                return rt::JsonRecords::parse_lines(data, pool, parse_record).has_value();
+            });
+            auto parse_array = throughput(array, [&pool, &parse_record](std::string_view data) {
+                return rt::JsonRecords::parse_array(data, pool, parse_record).has_value();
+            });
+            std::printf("%12zu %8zu %16.2f %16.2f\n", lines.size(), count, parse_lines, parse_array);
+        }
+    }
+
+    std::printf("\n%12s %16s %16s %16s\n", "size", "numbers", "retained KB", "bytes/number");
+    for (auto size : sizes) {
+        auto numbers = generate_numbers(size);
+        auto before = allocation_stats.current;
+        auto json = rt::Json::parse(numbers);
+        auto retained = allocation_stats.current - before;
+        const auto *data = json ? (*json)["data"].as<rt::Json::Array>() : nullptr;
+        if (data == nullptr) {
+            return EXIT_FAILURE;
+        }
+        std::printf("%12zu %16zu %16zu %16.2f\n", numbers.size(), data->size(), retained / 1024,
+                    static_cast<f64>(retained) / static_cast<f64>(data->size()));
+    }
+
+    // A deep copy allocates every node exactly once, so beyond the allocations of the lexer and the copy,
+    // parsing may only allocate a constant amount of scratch space, otherwise nested values are copied on
+    // their way up
+    constexpr usize MAX_DEPTH = 64;
+    auto lex = [](std::string_view data) {
+        using TokenType = rt::detail::JsonLexer::TokenType;
+        rt::detail::JsonLexer lexer{ data };
+        auto type = lexer.lex().type;
+        while (type != TokenType::END and type != TokenType::INVALID) {
+            type = lexer.lex().type;
+        }
+        return type == TokenType::END;
+    };
+
+    auto status = EXIT_SUCCESS;
+    std::optional<usize> scratch{};
+    std::printf("\n%12s %16s %16s %16s\n", "depth", "parse allocs", "lex allocs", "copy allocs");
+    for (usize depth = 1; depth <= MAX_DEPTH; depth *= 2) {
+        auto nested = generate_nested(depth);
+        auto json = rt::Json::parse(nested);
+        if (not json) {
+            return EXIT_FAILURE;
+        }
+        auto parse = allocations(nested, parse_json);
+        auto lexer = allocations(nested, lex);
+        auto copy = allocations(nested, [&json](std::string_view) { return rt::Json{ *json }.size() == 1; });
+        if (not scratch) {
+            scratch = parse.count - lexer.count - copy.count;
+        }
+        if (parse.count != lexer.count + copy.count + *scratch) {
+            status = EXIT_FAILURE;
+        }
+        std::printf("%12zu %16zu %16zu %16zu\n", depth, parse.count, lexer.count, copy.count);
+    }
+    if (status != EXIT_SUCCESS) {
+        std::printf("parsing copies nested values\n");
+    }
+    return status;
+}
@@ -0,0 +1,70 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Elias Engelbert Plank
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <span>
+#include <vector>
+
+#include <realtime/image.h>
+#include <realtime/zlib.h>
+
+namespace {
+
+/// Aborts the run so that the fuzzer keeps the input that broke an invariant
+/// @param condition The invariant
+void check(bool condition) {
+    if (not condition) {
+        std::abort();
+    }
+}
+
+}// namespace
+
+/// Decodes the input as image and as bare zlib stream. A stream must decode to the same bytes into an output
+/// that is exactly as large as the decoded data, and fail if the output is any smaller.
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t *bytes, std::size_t size) {
+    auto data = std::span<const std::uint8_t>{ bytes, size };
+
+    if (auto image = rt::Image::decode(data)) {
+        check(image->width > 0 and image->height > 0);
+        check(image->pixels.size() == std::size_t{ image->width } * image->height * 4);
+    }
+
+    std::vector<std::uint8_t> out(1 << 16);
+    auto decoded = rt::ZlibDecoder::decode(data, out);
+    if (decoded) {
+        check(*decoded <= out.size());
+        std::vector<std::uint8_t> exact(*decoded);
+        auto again = rt::ZlibDecoder::decode(data, exact);
+        check(again and *again == *decoded and std::equal(exact.begin(), exact.end(), out.begin()));
+        if (*decoded > 0) {
+            std::vector<std::uint8_t> small(*decoded - 1);
+            check(not rt::ZlibDecoder::decode(data, small));
+        }
+    }
+    return 0;
+}
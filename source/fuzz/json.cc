@@ -0,0 +1,91 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Elias Engelbert Plank
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <cstdint>
+#include <cstdlib>
+#include <string_view>
+
+#include <realtime/json.h>
+#include <realtime/json_document.h>
+#include <realtime/json_stream.h>
+#include <realtime/json_tape.h>
+#include <realtime/json_writer.h>
+
+namespace {
+
+/// Aborts the run so that the fuzzer keeps the input that broke an invariant
+/// @param condition The invariant
+void check(bool condition) {
+    if (not condition) {
+        std::abort();
+    }
+}
+
+/// Accepts every event and keeps nothing
+class NullHandler final : public rt::JsonHandler { };
+
+}// namespace
+
+/// Runs every parser mode over the input and checks that the modes agree with each other. The recursive
+/// parsers share one grammar, the stream parser is stricter and rejects trailing commas.
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t *bytes, std::size_t size) {
+    auto data = std::string_view{ reinterpret_cast<const char *>(bytes), size };
+
+    auto tape = rt::JsonTape::parse(data);
+    auto document = rt::JsonDocument::parse(data);
+    auto json = rt::Json::parse(data);
+    NullHandler handler;
+    auto handled = handler.parse(data);
+    check(tape.has_value() == handled);
+    check(not json or tape);
+
+    // Splitting the input must not change the outcome of the stream parser
+    NullHandler whole_handler;
+    rt::JsonStreamParser whole{ whole_handler };
+    whole.feed(data);
+    auto whole_status = whole.finish();
+
+    NullHandler split_handler;
+    rt::JsonStreamParser split{ split_handler };
+    split.feed(data.substr(0, size / 2));
+    split.feed(data.substr(size / 2));
+    check(split.finish() == whole_status);
+    check(whole_status != rt::JsonStreamParser::Status::DONE or tape);
+
+    if (tape) {
+        // Walking the whole tape touches every entry
+        for (auto value = tape->root().first(); value; value = value.next()) {
+            static_cast<void>(value.size());
+        }
+    }
+    static_cast<void>(document);
+
+    // What is written must parse again into an object of the same size
+    if (json) {
+        auto written = rt::JsonWriter::serialize(*json);
+        auto reparsed = rt::Json::parse(written);
+        check(reparsed and reparsed->size() == json->size());
+    }
+    return 0;
+}
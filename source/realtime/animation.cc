@@ -0,0 +1,637 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Elias Engelbert Plank
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "animation.h"
+#include "cpu.h"
+#include "gltf_accessor.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <tuple>
+
+#if REALTIME_X86
+#include <immintrin.h>
+#endif
+
+namespace rt {
+
+namespace {
+
+constexpr usize LANES = AnimationClip::LANES;
+
+/// The keyframe interval of a timeline that contains the sampled time
+struct Cursor {
+    u32 key;
+    u32 next;
+    f32 factor;
+    f32 delta;
+};
+
+/// The weighted keyframe values whose sum is the sample of all channels of a group. The keyframe values are
+/// the four component vectors at the given offsets, the weights are shared by all lanes. Linear rotations
+/// negate the weight of their second keyframe in every lane whose quaternions are more than half a turn apart.
+struct Terms {
+    u32 count;
+    bool shortest;
+    std::array<f32, LANES> weights;
+    std::array<u32, LANES> values;
+};
+
+/// Locates the keyframe interval of a time, clamping times outside of the timeline to its ends
+/// @param times The keyframe times of the timeline, sorted in ascending order
+/// @param time The time
+/// @return The cursor
+Cursor locate(std::span<const f32> times, f32 time) {
+    auto last = static_cast<u32>(times.size() - 1);
+    if (not(time > times.front())) {
+        return { 0, 0, 0.0f, 0.0f };
+    }
+    if (time >= times.back()) {
+        return { last, last, 0.0f, 0.0f };
+    }
+
+    // The keys around the time are distinct, as the first key after it is strictly later
+    auto next = static_cast<u32>(std::upper_bound(times.begin(), times.end(), time) - times.begin());
+    auto delta = times[next] - times[next - 1];
+    return { next - 1, next, (time - times[next - 1]) / delta, delta };
+}
+
+/// Computes the terms of a group for a keyframe interval
+/// @param group The group
+/// @param cursor The keyframe interval
+/// @return The terms
+Terms terms(const AnimationClip::Group &group, const Cursor &cursor) {
+    using Interpolation = AnimationClip::Interpolation;
+    auto u = cursor.factor;
+    auto key = group.values + 4 * cursor.key;
+    auto next = group.values + 4 * cursor.next;
+    switch (group.interpolation) {
+        case Interpolation::STEP:
+            return { 1, false, { 1.0f }, { key } };
+        case Interpolation::CUBICSPLINE: {
+            // Hermite basis over the in-tangent, value and out-tangent of every keyframe
+            auto u2 = u * u;
+            auto u3 = u2 * u;
+            key = group.values + 12 * cursor.key;
+            next = group.values + 12 * cursor.next;
+            return { 4,
+                     false,
+                     { 2.0f * u3 - 3.0f * u2 + 1.0f, (u3 - 2.0f * u2 + u) * cursor.delta, -2.0f * u3 + 3.0f * u2,
+                       (u3 - u2) * cursor.delta },
+                     { key + 4, key + 8, next + 4, next } };
+        }
+        default:
+            return { 2, group.rotation, { 1.0f - u, u }, { key, next } };
+    }
+}
+
+/// Sums up the terms of a group one channel at a time, normalizing rotations
+/// @param group The group
+/// @param batch The terms
+/// @param values The keyframe values of the clip
+/// @param out The samples
+void blend_scalar(const AnimationClip::Group &group, const Terms &batch, const glm::vec4 *values,
+                  std::array<glm::vec4, LANES> &out) {
+    for (glm::length_t lane = 0; lane < static_cast<glm::length_t>(group.count); lane++) {
+        std::array<f32, LANES> weights = batch.weights;
+
+        // Rotations take the shorter way around, which negating the weight of the second quaternion achieves
+        if (batch.shortest) {
+            const auto *first = values + batch.values[0];
+            const auto *second = values + batch.values[1];
+            auto dot = first[0][lane] * second[0][lane] + first[1][lane] * second[1][lane] +
+                       first[2][lane] * second[2][lane] + first[3][lane] * second[3][lane];
+            weights[1] = dot < 0.0f ? -weights[1] : weights[1];
+        }
+
+        auto &sample = out[static_cast<usize>(lane)];
+        for (glm::length_t component = 0; component < 4; component++) {
+            auto sum = weights[0] * values[batch.values[0] + static_cast<u32>(component)][lane];
+            for (usize term = 1; term < batch.count; term++) {
+                sum += weights[term] * values[batch.values[term] + static_cast<u32>(component)][lane];
+            }
+            sample[component] = sum;
+        }
+
+        // Normalizing the linear blend of two quaternions approximates their spherical interpolation closely
+        auto length = sample.x * sample.x + sample.y * sample.y + sample.z * sample.z + sample.w * sample.w;
+        if (group.rotation and length > 0.0f) {
+            auto root = std::sqrt(length);
+            sample = { sample.x / root, sample.y / root, sample.z / root, sample.w / root };
+        }
+    }
+}
+
+/// Multiplies two matrices, summing up the columns in a fixed order
+/// @param a The left matrix
+/// @param b The right matrix
+/// @return The product
+glm::mat4 multiply_scalar(const glm::mat4 &a, const glm::mat4 &b) {
+    glm::mat4 result{};
+    for (glm::length_t column = 0; column < 4; column++) {
+        result[column] = a[0] * b[column].x + a[1] * b[column].y + a[2] * b[column].z + a[3] * b[column].w;
+    }
+    return result;
+}
+
+/// Normalizes a vector unless it is zero
+/// @param vector The vector
+/// @return The normalized vector
+glm::vec3 normalize_or_zero(glm::vec3 vector) {
+    auto length = vector.x * vector.x + vector.y * vector.y + vector.z * vector.z;
+    if (length > 0.0f) {
+        auto root = std::sqrt(length);
+        return { vector.x / root, vector.y / root, vector.z / root };
+    }
+    return vector;
+}
+
+/// Skins vertices one at a time
+/// @param vertices The vertices
+/// @param palette The joint matrices
+/// @param out The skinned vertices
+void skin_scalar(const SkinnedVertices &vertices, std::span<const glm::mat4> palette, std::span<Mesh::Vertex> out) {
+    for (usize index = 0; index < vertices.bind_pose.size(); index++) {
+        const auto &[joints, weights] = vertices.influences[index];
+        const auto &vertex = vertices.bind_pose[index];
+        glm::mat4 blend{};
+        for (glm::length_t column = 0; column < 4; column++) {
+            blend[column] = palette[joints[0]][column] * weights[0] + palette[joints[1]][column] * weights[1] +
+                            palette[joints[2]][column] * weights[2] + palette[joints[3]][column] * weights[3];
+        }
+
+        auto &result = out[index];
+        result = vertex;
+        const auto &[px, py, pz] = vertex.position;
+        const auto &[nx, ny, nz] = vertex.normal;
+        result.position = glm::vec3{ blend[0] * px + blend[1] * py + blend[2] * pz + blend[3] };
+        result.normal = normalize_or_zero(glm::vec3{ blend[0] * nx + blend[1] * ny + blend[2] * nz });
+    }
+}
+
+#if REALTIME_X86
+
+/// Sums up the terms of all channels of a group at once. Each keyframe value of a group is stored as four
+/// vectors that hold one component of all four channels, so the terms are plain vertical arithmetic and only
+/// the samples are transposed once at the end.
+/// @param group The group
+/// @param batch The terms
+/// @param values The keyframe values of the clip
+/// @param out The samples
+REALTIME_TARGET("sse2")
+void blend_sse2(const AnimationClip::Group &group, const Terms &batch, const glm::vec4 *values,
+                std::array<glm::vec4, LANES> &out) {
+    __m128 weights[LANES];
+    for (usize term = 0; term < batch.count; term++) {
+        weights[term] = _mm_set1_ps(batch.weights[term]);
+    }
+
+    // Rotations take the shorter way around, which flipping the sign of the second weight achieves
+    const auto *first = &values[batch.values[0]].x;
+    if (batch.shortest) {
+        const auto *second = &values[batch.values[1]].x;
+        auto dot = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(first), _mm_loadu_ps(second)),
+                                                    _mm_mul_ps(_mm_loadu_ps(first + 4), _mm_loadu_ps(second + 4))),
+                                         _mm_mul_ps(_mm_loadu_ps(first + 8), _mm_loadu_ps(second + 8))),
+                              _mm_mul_ps(_mm_loadu_ps(first + 12), _mm_loadu_ps(second + 12)));
+        auto negative = _mm_and_ps(_mm_cmplt_ps(dot, _mm_setzero_ps()), _mm_set1_ps(-0.0f));
+        weights[1] = _mm_xor_ps(weights[1], negative);
+    }
+
+    __m128 sums[4];
+    for (usize component = 0; component < 4; component++) {
+        sums[component] = _mm_mul_ps(weights[0], _mm_loadu_ps(first + component * 4));
+    }
+    for (usize term = 1; term < batch.count; term++) {
+        const auto *value = &values[batch.values[term]].x;
+        for (usize component = 0; component < 4; component++) {
+            sums[component] =
+                    _mm_add_ps(sums[component], _mm_mul_ps(weights[term], _mm_loadu_ps(value + component * 4)));
+        }
+    }
+
+    if (group.rotation) {
+        auto length = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(sums[0], sums[0]), _mm_mul_ps(sums[1], sums[1])),
+                                            _mm_mul_ps(sums[2], sums[2])),
+                                 _mm_mul_ps(sums[3], sums[3]));
+        auto normalize = _mm_cmpgt_ps(length, _mm_setzero_ps());
+        auto root = _mm_sqrt_ps(length);
+        for (auto &sum : sums) {
+            sum = _mm_or_ps(_mm_and_ps(normalize, _mm_div_ps(sum, root)), _mm_andnot_ps(normalize, sum));
+        }
+    }
+
+    _MM_TRANSPOSE4_PS(sums[0], sums[1], sums[2], sums[3]);
+    for (usize lane = 0; lane < LANES; lane++) {
+        _mm_storeu_ps(&out[lane].x, sums[lane]);
+    }
+}
+
+/// Multiplies two matrices a column at a time
+/// @param a The left matrix
+/// @param b The right matrix
+/// @param out The product
+REALTIME_TARGET("sse2") void multiply_sse2(const glm::mat4 &a, const glm::mat4 &b, glm::mat4 &out) {
+    const auto *left = &a[0].x;
+    const auto *right = &b[0].x;
+    auto c0 = _mm_loadu_ps(left);
+    auto c1 = _mm_loadu_ps(left + 4);
+    auto c2 = _mm_loadu_ps(left + 8);
+    auto c3 = _mm_loadu_ps(left + 12);
+    for (usize column = 0; column < 4; column++) {
+        auto sum = _mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(right[column * 4])),
+                              _mm_mul_ps(c1, _mm_set1_ps(right[column * 4 + 1])));
+        sum = _mm_add_ps(sum, _mm_mul_ps(c2, _mm_set1_ps(right[column * 4 + 2])));
+        sum = _mm_add_ps(sum, _mm_mul_ps(c3, _mm_set1_ps(right[column * 4 + 3])));
+        _mm_storeu_ps(&out[static_cast<glm::length_t>(column)].x, sum);
+    }
+}
+
+/// Skins vertices, blending the four columns of the joint matrices of a vertex in registers
+/// @param vertices The vertices
+/// @param palette The joint matrices
+/// @param out The skinned vertices
+REALTIME_TARGET("sse2")
+void skin_sse2(const SkinnedVertices &vertices, std::span<const glm::mat4> palette, std::span<Mesh::Vertex> out) {
+    for (usize index = 0; index < vertices.bind_pose.size(); index++) {
+        const auto &[joints, weights] = vertices.influences[index];
+        const auto &vertex = vertices.bind_pose[index];
+        const f32 *matrices[4] = { &palette[joints[0]][0].x, &palette[joints[1]][0].x, &palette[joints[2]][0].x,
+                                   &palette[joints[3]][0].x };
+        auto influence = _mm_loadu_ps(weights.data());
+        __m128 factors[4] = { _mm_shuffle_ps(influence, influence, 0x00), _mm_shuffle_ps(influence, influence, 0x55),
+                              _mm_shuffle_ps(influence, influence, 0xAA), _mm_shuffle_ps(influence, influence, 0xFF) };
+        __m128 blend[4];
+        for (usize column = 0; column < 4; column++) {
+            auto sum = _mm_mul_ps(_mm_loadu_ps(matrices[0] + column * 4), factors[0]);
+            for (usize joint = 1; joint < 4; joint++) {
+                sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(matrices[joint] + column * 4), factors[joint]));
+            }
+            blend[column] = sum;
+        }
+
+        // The position is followed by the colour and the normal by the texture coordinates, so both can be
+        // loaded as four floats
+        auto position = _mm_loadu_ps(&vertex.position.x);
+        auto normal = _mm_loadu_ps(&vertex.normal.x);
+        auto transformed = _mm_add_ps(
+                _mm_add_ps(_mm_add_ps(_mm_mul_ps(blend[0], _mm_shuffle_ps(position, position, 0x00)),
+                                      _mm_mul_ps(blend[1], _mm_shuffle_ps(position, position, 0x55))),
+                           _mm_mul_ps(blend[2], _mm_shuffle_ps(position, position, 0xAA))),
+                blend[3]);
+        auto rotated = _mm_add_ps(_mm_add_ps(_mm_mul_ps(blend[0], _mm_shuffle_ps(normal, normal, 0x00)),
+                                             _mm_mul_ps(blend[1], _mm_shuffle_ps(normal, normal, 0x55))),
+                                  _mm_mul_ps(blend[2], _mm_shuffle_ps(normal, normal, 0xAA)));
+
+        // The squared length of the normal is summed up in the same order as by the scalar backend
+        auto squared = _mm_mul_ps(rotated, rotated);
+        auto length = _mm_add_ss(_mm_add_ss(squared, _mm_shuffle_ps(squared, squared, 0x55)),
+                                 _mm_shuffle_ps(squared, squared, 0xAA));
+        if (_mm_comigt_ss(length, _mm_setzero_ps())) {
+            auto root = _mm_sqrt_ss(length);
+            rotated = _mm_div_ps(rotated, _mm_shuffle_ps(root, root, 0x00));
+        }
+
+        // Storing four floats overwrites the first component of the colour and the texture coordinates,
+        // which are copied afterwards
+        auto &result = out[index];
+        _mm_storeu_ps(&result.position.x, transformed);
+        _mm_storeu_ps(&result.normal.x, rotated);
+        result.color = vertex.color;
+        result.uv = vertex.uv;
+    }
+}
+
+#endif
+
+/// Writes the sample of a channel into the local transform of its node
+/// @param node The node of the channel
+/// @param path The path of the channel
+/// @param sample The sample
+/// @param hierarchy The hierarchy
+void apply(u32 node, AnimationClip::Path path, const glm::vec4 &sample, Hierarchy &hierarchy) {
+    auto &local = hierarchy.locals[node];
+    switch (path) {
+        case AnimationClip::Path::TRANSLATION:
+            local.translation = glm::vec3{ sample };
+            break;
+        case AnimationClip::Path::ROTATION:
+            local.rotation = glm::quat{ sample.w, sample.x, sample.y, sample.z };
+            break;
+        default:
+            local.scale = glm::vec3{ sample };
+            break;
+    }
+}
+
+}// namespace
+
+/// Creates a clip from channels whose keyframe values are stored one channel after another
+AnimationClip AnimationClip::create(std::vector<f32> times, std::vector<Timeline> timelines,
+                                    std::span<const Channel> channels, std::span<const glm::vec4> values) {
+    auto clip = AnimationClip{ std::move(times), std::move(timelines), {}, {}, 0.0f };
+    for (const auto &timeline : clip.timelines) {
+        assert(timeline.count > 0 and timeline.first + timeline.count <= clip.times.size() and
+               "[animation] Timeline is out of bounds");
+        clip.duration = std::max(clip.duration, clip.times[timeline.first + timeline.count - 1]);
+    }
+
+    // Channels that share their timeline, interpolation and whether they are rotations share their terms
+    std::vector<const Channel *> sorted(channels.size());
+    std::transform(channels.begin(), channels.end(), sorted.begin(), [](const Channel &channel) { return &channel; });
+    auto key = [](const Channel *channel) {
+        return std::tuple{ channel->timeline, channel->interpolation, channel->path == Path::ROTATION };
+    };
+    std::stable_sort(sorted.begin(), sorted.end(), [&](const Channel *a, const Channel *b) { return key(a) < key(b); });
+
+    for (usize first = 0; first < sorted.size();) {
+        const auto &leader = *sorted[first];
+        auto &group = clip.groups.emplace_back();
+        group.timeline = leader.timeline;
+        group.interpolation = leader.interpolation;
+        group.rotation = leader.path == Path::ROTATION;
+        group.values = static_cast<u32>(clip.values.size());
+        auto keys = usize{ clip.timelines[leader.timeline].count } *
+                    (leader.interpolation == Interpolation::CUBICSPLINE ? 3 : 1);
+        clip.values.resize(clip.values.size() + keys * 4, glm::vec4{ 0.0f });
+        for (; first < sorted.size() and group.count < LANES and key(sorted[first]) == key(&leader); first++) {
+            const auto &channel = *sorted[first];
+            assert(channel.values + keys <= values.size() and "[animation] Channel values are out of bounds");
+            auto lane = static_cast<glm::length_t>(group.count++);
+            group.nodes[static_cast<usize>(lane)] = channel.node;
+            group.paths[static_cast<usize>(lane)] = channel.path;
+            for (usize slot = 0; slot < keys; slot++) {
+                const auto &value = values[channel.values + slot];
+                for (glm::length_t component = 0; component < 4; component++) {
+                    clip.values[group.values + slot * 4 + static_cast<usize>(component)][lane] = value[component];
+                }
+            }
+        }
+    }
+    return clip;
+}
+
+/// Retrieves the number of channels of all groups
+usize AnimationClip::channel_count() const {
+    usize count = 0;
+    for (const auto &group : groups) {
+        count += group.count;
+    }
+    return count;
+}
+
+/// Retrieves the fastest backend that is supported by the host CPU
+AnimationClip::Backend AnimationClip::best() {
+    return supported(Backend::SSE2) ? Backend::SSE2 : Backend::SCALAR;
+}
+
+/// Checks whether the given backend is supported by the host CPU
+bool AnimationClip::supported(Backend backend) {
+    switch (backend) {
+        case Backend::SSE2:
+            return REALTIME_X86 and cpu_features().sse2;
+        default:
+            return true;
+    }
+}
+
+/// Imports an animation of a glTF document
+std::optional<AnimationClip> AnimationClip::from_gltf(const gltf::Document &document,
+                                                      std::span<const std::span<const u8>> buffer_views,
+                                                      u32 animation, const Hierarchy &hierarchy) {
+    if (animation >= document.animations.size()) {
+        return std::nullopt;
+    }
+    const auto &info = document.animations[animation];
+
+    std::vector<f32> times;
+    std::vector<Timeline> timelines;
+    std::vector<Channel> channels;
+    std::vector<glm::vec4> values;
+    std::vector<u32> inputs(document.accessors.size(), Hierarchy::NONE);
+    for (const auto &channel : info.channels) {
+        if (channel.sampler >= info.samplers.size()) {
+            return std::nullopt;
+        }
+        if (not channel.target.node or channel.target.path == Path::WEIGHTS) {
+            continue;
+        }
+        if (*channel.target.node >= hierarchy.gltf_nodes.size()) {
+            return std::nullopt;
+        }
+        auto node = hierarchy.gltf_nodes[*channel.target.node];
+        if (node == Hierarchy::NONE) {
+            continue;
+        }
+
+        // Samplers with the same input share their timeline
+        const auto &sampler = info.samplers[channel.sampler];
+        if (sampler.input >= inputs.size()) {
+            return std::nullopt;
+        }
+        auto &timeline = inputs[sampler.input];
+        if (timeline == Hierarchy::NONE) {
+            auto input = gltf::AccessorView::create(document, buffer_views, sampler.input);
+            if (not input or input->components != 1 or input->count == 0) {
+                return std::nullopt;
+            }
+            auto first = times.size();
+            times.resize(first + input->count);
+            input->read_floats(times.data() + first, 1, sizeof(f32));
+            auto keys = std::span{ times }.subspan(first);
+            if (not std::all_of(keys.begin(), keys.end(), [](f32 time) { return std::isfinite(time); }) or
+                not std::is_sorted(keys.begin(), keys.end())) {
+                return std::nullopt;
+            }
+            timeline = static_cast<u32>(timelines.size());
+            timelines.push_back({ static_cast<u32>(first), input->count });
+        }
+
+        auto output = gltf::AccessorView::create(document, buffer_views, sampler.output);
+        auto components = channel.target.path == Path::ROTATION ? 4u : 3u;
+        auto cubic = sampler.interpolation == Interpolation::CUBICSPLINE;
+        auto keys = usize{ timelines[timeline].count } * (cubic ? 3 : 1);
+        if (not output or output->components != components or output->count != keys) {
+            return std::nullopt;
+        }
+        auto first = values.size();
+        values.resize(first + keys, glm::vec4{ 0.0f });
+        output->read_floats(&values[first].x, components, sizeof(glm::vec4));
+        channels.push_back({ node, channel.target.path, sampler.interpolation, timeline, static_cast<u32>(first) });
+    }
+    return create(std::move(times), std::move(timelines), channels, values);
+}
+/// Samples all channels at the given time and writes the local transforms of their nodes
+void AnimationClip::sample(f32 time, Hierarchy &hierarchy, Backend backend) const {
+    backend = supported(backend) ? backend : best();
+
+    auto cursor = Cursor{};
+    auto located = Hierarchy::NONE;
+    for (const auto &group : groups) {
+        if (group.timeline != located) {
+            const auto &timeline = timelines[group.timeline];
+            cursor = locate(std::span{ times }.subspan(timeline.first, timeline.count), time);
+            located = group.timeline;
+        }
+        auto batch = terms(group, cursor);
+
+        std::array<glm::vec4, LANES> samples{};
+#if REALTIME_X86
+        if (backend == Backend::SSE2) {
+            blend_sse2(group, batch, values.data(), samples);
+        } else {
+            blend_scalar(group, batch, values.data(), samples);
+        }
+#else
+        blend_scalar(group, batch, values.data(), samples);
+#endif
+        for (usize lane = 0; lane < group.count; lane++) {
+            apply(group.nodes[lane], group.paths[lane], samples[lane], hierarchy);
+        }
+    }
+}
+
+/// Imports a skin of a glTF document
+std::optional<Skin> Skin::from_gltf(const gltf::Document &document, std::span<const std::span<const u8>> buffer_views,
+                                    u32 skin, const Hierarchy &hierarchy) {
+    if (skin >= document.skins.size()) {
+        return std::nullopt;
+    }
+    const auto &info = document.skins[skin];
+
+    auto result = Skin{};
+    for (auto joint : info.joints) {
+        if (joint >= hierarchy.gltf_nodes.size() or hierarchy.gltf_nodes[joint] == Hierarchy::NONE) {
+            return std::nullopt;
+        }
+        result.joints.push_back(hierarchy.gltf_nodes[joint]);
+    }
+
+    result.inverse_bind_matrices.assign(result.joints.size(), glm::mat4{ 1.0f });
+    if (info.inverse_bind_matrices and not result.joints.empty()) {
+        auto matrices = gltf::AccessorView::create(document, buffer_views, *info.inverse_bind_matrices);
+        if (not matrices or matrices->components != 16 or matrices->count < result.joints.size()) {
+            return std::nullopt;
+        }
+        matrices->slice(0, static_cast<u32>(result.joints.size()))
+                .read_floats(&result.inverse_bind_matrices.front()[0].x, 16, sizeof(glm::mat4));
+    }
+    return result;
+}
+
+/// Computes the joint matrices of all joints in one pass
+void Skin::compute_palette(const Hierarchy &hierarchy, u32 node, std::span<glm::mat4> palette,
+                           AnimationClip::Backend backend) const {
+    assert(palette.size() >= joints.size() and "[animation] Palette must hold a matrix per joint");
+    backend = AnimationClip::supported(backend) ? backend : AnimationClip::best();
+
+    // Joints are animated in world space, the mesh is drawn relative to its node
+    auto root = glm::inverse(hierarchy.worlds[node]);
+    for (usize joint = 0; joint < joints.size(); joint++) {
+        const auto &world = hierarchy.worlds[joints[joint]];
+#if REALTIME_X86
+        if (backend == AnimationClip::Backend::SSE2) {
+            glm::mat4 relative;
+            multiply_sse2(root, world, relative);
+            multiply_sse2(relative, inverse_bind_matrices[joint], palette[joint]);
+            continue;
+        }
+#endif
+        palette[joint] = multiply_scalar(multiply_scalar(root, world), inverse_bind_matrices[joint]);
+    }
+}
+
+/// Imports the vertices of every primitive of a glTF mesh
+std::optional<SkinnedVertices> SkinnedVertices::from_gltf(const gltf::Document &document,
+                                                          std::span<const std::span<const u8>> buffer_views,
+                                                          u32 mesh) {
+    if (mesh >= document.meshes.size()) {
+        return std::nullopt;
+    }
+
+    auto result = SkinnedVertices{ {}, {}, {}, 0 };
+    Mesh::Builder builder{};
+    std::vector<f32> joints{};
+    for (const auto &primitive : document.meshes[mesh].primitives) {
+        auto first = builder.vertices.size();
+        if (not builder.append(document, buffer_views, primitive)) {
+            return std::nullopt;
+        }
+        auto count = builder.vertices.size() - first;
+        if (count == 0) {
+            continue;
+        }
+        const auto &attributes = primitive.attributes;
+        if (not attributes.joints_0 or not attributes.weights_0) {
+            return std::nullopt;
+        }
+
+        // Joints are unsigned integers, which floats represent exactly
+        using ComponentType = gltf::Accessor::ComponentType;
+        auto joint_view = gltf::AccessorView::create(document, buffer_views, *attributes.joints_0);
+        auto weight_view = gltf::AccessorView::create(document, buffer_views, *attributes.weights_0);
+        if (not joint_view or joint_view->components != 4 or joint_view->count != count or
+            joint_view->normalized or
+            (joint_view->component_type != ComponentType::UNSIGNED_BYTE and
+             joint_view->component_type != ComponentType::UNSIGNED_SHORT)) {
+            return std::nullopt;
+        }
+        if (not weight_view or weight_view->components != 4 or weight_view->count != count) {
+            return std::nullopt;
+        }
+
+        joints.resize(count * 4);
+        joint_view->read_floats(joints.data(), 4, 4 * sizeof(f32));
+        result.influences.resize(first + count);
+        weight_view->read_floats(result.influences[first].weights.data(), 4, sizeof(Influence));
+        for (usize vertex = 0; vertex < count; vertex++) {
+            auto &influence = result.influences[first + vertex];
+            for (usize joint = 0; joint < 4; joint++) {
+                influence.joints[joint] = static_cast<u16>(joints[vertex * 4 + joint]);
+                result.joint_count = std::max(result.joint_count, influence.joints[joint] + 1u);
+            }
+        }
+    }
+    result.bind_pose = std::move(builder.vertices);
+    result.indices = std::move(builder.indices);
+    return result;
+}
+
+/// Transforms all vertices with the weighted sum of the matrices of their joints
+void SkinnedVertices::skin(std::span<const glm::mat4> palette, std::span<Mesh::Vertex> out,
+                           AnimationClip::Backend backend) const {
+    assert(palette.size() >= joint_count and "[animation] Palette must hold a matrix per joint");
+    assert(out.size() >= bind_pose.size() and "[animation] Destination must hold every vertex");
+    backend = AnimationClip::supported(backend) ? backend : AnimationClip::best();
+#if REALTIME_X86
+    if (backend == AnimationClip::Backend::SSE2) {
+        skin_sse2(*this, palette, out);
+        return;
+    }
+#endif
+    skin_scalar(*this, palette, out);
+}
+
+}// namespace rt
@@ -0,0 +1,197 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Elias Engelbert Plank
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef REALTIME_ANIMATION_H
+#define REALTIME_ANIMATION_H
+
+#include <array>
+#include <span>
+#include <vector>
+
+#include "gltf.h"
+#include "hierarchy.h"
+#include "mesh.h"
+
+namespace rt {
+
+/// A keyframe animation of the local transforms of a hierarchy. Channels with the same keyframe times, the
+/// same interpolation and either all or none of them rotations are packed into groups of four, whose keyframe
+/// values are stored in structure-of-arrays form. The sample of a group is a weighted sum of up to four
+/// keyframes, which covers step, linear and cubic spline interpolation alike, so that a group is sampled with
+/// whole vectors that hold one component of all four channels.
+class AnimationClip {
+public:
+    /// The instruction sets sampling and skinning can be vectorized with
+    enum class Backend {
+        SCALAR,
+        SSE2
+    };
+
+    using Path = gltf::Animation::Channel::Target::Path;
+    using Interpolation = gltf::Animation::Sampler::Interpolation;
+
+    /// The number of channels of a group
+    static constexpr usize LANES = 4;
+
+    /// The keyframe times that are shared by all channels whose samplers have the same input
+    struct Timeline {
+        u32 first;
+        u32 count;
+    };
+
+    /// A channel drives the translation, rotation or scale of a node. Cubic spline channels hold an
+    /// in-tangent, a value and an out-tangent per keyframe, all others a value.
+    struct Channel {
+        u32 node;
+        Path path;
+        Interpolation interpolation;
+        u32 timeline;
+
+        /// The first keyframe value of the channel, in the values that are passed to create
+        u32 values;
+    };
+
+    /// Up to four channels that are sampled at once. Each of their keyframe values takes four vectors in
+    /// the values of the clip, which hold the x, y, z and w components of the four channels. Unused lanes
+    /// are zero.
+    struct Group {
+        u32 timeline;
+        Interpolation interpolation;
+        bool rotation;
+        u32 count;
+        std::array<u32, LANES> nodes;
+        std::array<Path, LANES> paths;
+        u32 values;
+    };
+
+    std::vector<f32> times;
+    std::vector<Timeline> timelines;
+    std::vector<Group> groups;
+    std::vector<glm::vec4> values;
+
+    /// The time of the last keyframe of all timelines
+    f32 duration;
+
+    /// Creates a clip from channels whose keyframe values are stored one channel after another. The channels
+    /// are packed into groups, which are sorted by their timeline, so that the keyframe interval is searched
+    /// once per timeline.
+    /// @param times The keyframe times of all timelines
+    /// @param timelines The timelines
+    /// @param channels The channels
+    /// @param values The keyframe values of all channels, rotations as x, y, z, w and all others with w zero
+    /// @return The clip
+    static AnimationClip create(std::vector<f32> times, std::vector<Timeline> timelines,
+                                std::span<const Channel> channels, std::span<const glm::vec4> values);
+
+    /// Retrieves the number of channels of all groups
+    /// @return The number of channels
+    usize channel_count() const;
+
+    /// Retrieves the fastest backend that is supported by the host CPU
+    /// @return The fastest backend
+    static Backend best();
+
+    /// Checks whether the given backend is supported by the host CPU
+    /// @param backend The backend
+    /// @return A value that indicates whether the backend is supported
+    static bool supported(Backend backend);
+
+    /// Imports an animation of a glTF document. Channels that target morph target weights or nodes outside
+    /// of the hierarchy are skipped.
+    /// @param document The glTF document
+    /// @param buffer_views The data of every buffer view of the document, as resolved by gltf::resolve_views
+    /// @param animation The index of the animation
+    /// @param hierarchy The hierarchy the nodes of the document were imported into
+    /// @return The clip or std::nullopt if any sampler or channel is malformed
+    static std::optional<AnimationClip> from_gltf(const gltf::Document &document,
+                                                  std::span<const std::span<const u8>> buffer_views, u32 animation,
+                                                  const Hierarchy &hierarchy);
+
+    /// Samples all channels at the given time and writes the local transforms of their nodes. Times outside
+    /// of a timeline are clamped to its first or last keyframe. The clip is never modified, so any number of
+    /// hierarchies can be sampled from the same clip concurrently.
+    /// @param time The time in seconds
+    /// @param hierarchy The hierarchy whose nodes are animated
+    /// @param backend The backend, unsupported backends fall back to the fastest supported one
+    void sample(f32 time, Hierarchy &hierarchy, Backend backend = best()) const;
+};
+
+/// The joints of a skin as nodes of a hierarchy, together with their inverse bind matrices
+struct Skin {
+    std::vector<u32> joints;
+    std::vector<glm::mat4> inverse_bind_matrices;
+
+    /// Imports a skin of a glTF document
+    /// @param document The glTF document
+    /// @param buffer_views The data of every buffer view of the document, as resolved by gltf::resolve_views
+    /// @param skin The index of the skin
+    /// @param hierarchy The hierarchy the nodes of the document were imported into
+    /// @return The skin or std::nullopt if any joint is outside of the hierarchy or the matrices are malformed
+    static std::optional<Skin> from_gltf(const gltf::Document &document,
+                                         std::span<const std::span<const u8>> buffer_views, u32 skin,
+                                         const Hierarchy &hierarchy);
+
+    /// Computes the joint matrices of all joints in one pass, they transform vertices from the bind pose into
+    /// the space of the node the skinned mesh is attached to
+    /// @param hierarchy The hierarchy, whose world matrices must be up to date
+    /// @param node The node of the skinned mesh
+    /// @param palette The joint matrices, must hold one matrix per joint
+    /// @param backend The backend, unsupported backends fall back to the fastest supported one
+    void compute_palette(const Hierarchy &hierarchy, u32 node, std::span<glm::mat4> palette,
+                         AnimationClip::Backend backend = AnimationClip::best()) const;
+};
+
+/// The vertices of a skinned mesh in bind pose, each with up to four weighted joints
+struct SkinnedVertices {
+    struct Influence {
+        std::array<u16, 4> joints;
+        std::array<f32, 4> weights;
+    };
+
+    std::vector<Mesh::Vertex> bind_pose;
+    std::vector<Influence> influences;
+    std::vector<u32> indices;
+
+    /// One more than the largest joint of any influence, the least number of joint matrices skinning needs
+    u32 joint_count;
+
+    /// Imports the vertices of every primitive of a glTF mesh, all of which must have joints and weights
+    /// @param document The glTF document
+    /// @param buffer_views The data of every buffer view of the document, as resolved by gltf::resolve_views
+    /// @param mesh The index of the mesh
+    /// @return The vertices or std::nullopt if any primitive is malformed or has no joints or weights
+    static std::optional<SkinnedVertices> from_gltf(const gltf::Document &document,
+                                                    std::span<const std::span<const u8>> buffer_views, u32 mesh);
+
+    /// Transforms all vertices with the weighted sum of the matrices of their joints
+    /// @param palette The joint matrices, must hold at least joint_count matrices
+    /// @param out The skinned vertices, for example the mapped memory of a host-visible vertex buffer
+    /// @param backend The backend, unsupported backends fall back to the fastest supported one
+    void skin(std::span<const glm::mat4> palette, std::span<Mesh::Vertex> out,
+              AnimationClip::Backend backend = AnimationClip::best()) const;
+};
+
+}// namespace rt
+
+#endif// REALTIME_ANIMATION_H
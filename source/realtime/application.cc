@@ -23,6 +23,7 @@
 
 #include <array>
 #include <chrono>
+#include <iterator>
 
 #include "application.h"
 #include "buffer.h"
@@ -57,7 +58,8 @@ struct UniformBuffer {
 Application::Application(Specification specification)
     : window{ std::move(specification) },
       device{ window },
-      renderer{ window, device } {
+      renderer{ window, device },
+      texture_loader{ device, pool } {
     load_entities();
 }
 
@@ -86,11 +88,13 @@ void Application::run() {
         last_time = current_time;
 
         camera.update(renderer.aspect_ratio());
+        texture_loader.update();
         if (auto command_buffer = renderer.begin_frame()) {
             auto frame_index = renderer.frame_index();
             FrameInfo info{ frame_index, frame_time, command_buffer, camera };
 
             // Update
+            hierarchy.update();
             UniformBuffer ubo{};
             ubo.projection_view = camera.projection_view();
             uniform_buffer.write(&ubo, static_cast<s32>(frame_index));
@@ -98,7 +102,7 @@ void Application::run() {
 
             // Render
             renderer.begin_swapchain_render_pass(command_buffer, { 0.48f, 0.65f, 1.0f, 1.0f });
-            render_system.render_entities(info, entities);
+            render_system.render_entities(info, entities, hierarchy);
             renderer.end_swapchain_render_pass(command_buffer);
             renderer.end_frame();
         }
@@ -113,6 +117,40 @@ void Application::load_entities() {
     entity.mesh = Mesh::from_wavefront(device, "assets/stanford-dragon-10k.obj");
     entity.transform.scale = glm::vec3{ 1.0f };
     entity.transform.rotation = { glm::pi<f32>(), 0.0f, 0.0f };
+
+    // The primitives of glTF files are imported on the thread pool, every node with a mesh becomes an entity
+    auto file = GltfFile::read("assets/cube.glb");
+    if (not file) {
+        error(64, "[application] Could not read glTF file assets/cube.glb");
+    }
+    auto meshes = Mesh::import_gltf(device, pool, *file);
+    auto scene = Hierarchy::from_gltf(file->document);
+    if (not scene) {
+        error(64, "[application] Malformed glTF node hierarchy in assets/cube.glb");
+    }
+    hierarchy = std::move(*scene);
+
+    std::vector<std::shared_ptr<Mesh>> shared{ std::make_move_iterator(meshes.begin()),
+                                               std::make_move_iterator(meshes.end()) };
+    for (u32 node = 0; node < hierarchy.size(); node++) {
+        if (not hierarchy.meshes[node] or not shared[*hierarchy.meshes[node]]) {
+            continue;
+        }
+        auto &imported = entities.emplace_back(Entity::create());
+        imported.mesh = shared[*hierarchy.meshes[node]];
+        imported.node = node;
+        imported.transform.translation = { 2.5f, 0.0f, 0.0f };
+        imported.transform.scale = glm::vec3{ 0.5f };
+    }
+
+    // The images are decoded and uploaded in the background, their textures arrive in later frames
+    auto images = std::make_shared<const GltfFile>(std::move(*file));
+    textures.resize(images->document.images.size());
+    for (u32 image = 0; image < textures.size(); image++) {
+        texture_loader.load(images, image, [this, image](std::shared_ptr<Texture> texture) {
+            textures[image] = std::move(texture);
+        });
+    }
 }
 
 }// namespace rt
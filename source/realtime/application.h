@@ -29,7 +29,10 @@
 
 #include "device.h"
 #include "entity.h"
+#include "hierarchy.h"
 #include "renderer.h"
+#include "texture.h"
+#include "thread_pool.h"
 #include "window.h"
 
 namespace rt {
@@ -62,8 +65,14 @@ private:
     Window window;
     Device device;
     Renderer renderer;
+    ThreadPool pool;
+    TextureLoader texture_loader;
 
     std::vector<Entity> entities;
+    Hierarchy hierarchy;
+
+    /// The textures of the images of the glTF scene, which are null until they are loaded
+    std::vector<std::shared_ptr<Texture>> textures;
 };
 
 }// namespace rt
@@ -0,0 +1,134 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Elias Engelbert Plank
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <new>
+#include <utility>
+
+#include "arena.h"
+
+namespace rt {
+
+namespace {
+
+/// Aligns the given value up to the next multiple of the alignment
+/// @param value The value
+/// @param alignment The alignment, must be a power of two
+/// @return The aligned value
+constexpr usize align_up(usize value, usize alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+}// namespace
+
+/// Creates a new arena
+Arena::Arena(usize capacity) : head{ nullptr }, allocated{ 0 } {
+    grow(capacity);
+}
+
+/// Releases all blocks of the arena
+Arena::~Arena() {
+    while (head) {
+        auto *previous = head->previous;
+        ::operator delete(head);
+        head = previous;
+    }
+}
+
+/// An arena cannot be copied, allow move
+Arena::Arena(Arena &&other) noexcept
+    : head{ std::exchange(other.head, nullptr) },
+      allocated{ std::exchange(other.allocated, 0) } { }
+
+/// An arena cannot be copied, allow move
+Arena &Arena::operator=(Arena &&other) noexcept {
+    if (this != &other) {
+        std::swap(head, other.head);
+        std::swap(allocated, other.allocated);
+    }
+    return *this;
+}
+
+/// Allocates uninitialized memory from the arena
+void *Arena::allocate(usize size, usize alignment) {
+    assert(alignment <= alignof(std::max_align_t) and "[arena] Unsupported alignment!");
+    if (not head or align_up(head->used, alignment) + size > head->capacity) {
+        grow(size);
+    }
+
+    auto offset = align_up(head->used, alignment);
+    head->used = offset + size;
+    allocated += size;
+    return payload(head) + offset;
+}
+
+/// Copies the given text into the arena
+std::string_view Arena::copy(std::string_view text) {
+    auto *destination = static_cast<char *>(allocate(text.size(), 1));
+    std::memcpy(destination, text.data(), text.size());
+    return { destination, text.size() };
+}
+
+/// Releases all blocks but the first one and rewinds it
+void Arena::reset() {
+    while (head and head->previous) {
+        auto *previous = head->previous;
+        ::operator delete(head);
+        head = previous;
+    }
+    if (head) {
+        head->used = 0;
+    }
+    allocated = 0;
+}
+
+/// Retrieves the number of bytes handed out by the arena
+usize Arena::size() const {
+    return allocated;
+}
+
+/// Retrieves the number of bytes reserved by the arena
+usize Arena::capacity() const {
+    usize result = 0;
+    for (auto *block = head; block; block = block->previous) {
+        result += block->capacity;
+    }
+    return result;
+}
+
+/// Allocates a new block that can hold at least the given number of bytes
+void Arena::grow(usize size) {
+    auto capacity = std::max(size, head ? head->capacity * 2 : size);
+    auto *block = static_cast<Block *>(::operator new(align_up(sizeof(Block), alignof(std::max_align_t)) + capacity));
+    block->previous = head;
+    block->capacity = capacity;
+    block->used = 0;
+    head = block;
+}
+
+/// Retrieves the payload of a block
+u8 *Arena::payload(Block *block) {
+    return reinterpret_cast<u8 *>(block) + align_up(sizeof(Block), alignof(std::max_align_t));
+}
+
+}// namespace rt
@@ -0,0 +1,109 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Elias Engelbert Plank
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef REALTIME_ARENA_H
+#define REALTIME_ARENA_H
+
+#include <cstddef>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+
+#include "realtime.h"
+
+namespace rt {
+
+/// A bump allocator that hands out memory from a list of blocks. Objects allocated from an arena are
+/// never destroyed individually, all memory is released at once when the arena is reset or destroyed.
+class Arena {
+public:
+    constexpr static usize DEFAULT_CAPACITY = 64 * 1024;
+
+    /// Creates a new arena
+    /// @param capacity The capacity of the first block, further blocks grow geometrically
+    explicit Arena(usize capacity = DEFAULT_CAPACITY);
+
+    /// Releases all blocks of the arena
+    ~Arena();
+
+    /// An arena cannot be copied, allow move
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+    Arena(Arena &&other) noexcept;
+    Arena &operator=(Arena &&other) noexcept;
+
+    /// Allocates uninitialized memory from the arena
+    /// @param size The size of the allocation in bytes
+    /// @param alignment The alignment of the allocation, must be a power of two
+    /// @return A pointer to the allocated memory
+    void *allocate(usize size, usize alignment = alignof(std::max_align_t));
+
+    /// Allocates an uninitialized array of trivially destructible objects from the arena
+    /// @tparam T The type of the objects
+    /// @param count The number of objects
+    /// @return A pointer to the first object
+    template<typename T>
+    T *allocate(usize count = 1) {
+        static_assert(std::is_trivially_destructible_v<T>, "Arena objects are never destroyed!");
+        return static_cast<T *>(allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    /// Copies the given text into the arena
+    /// @param text The text
+    /// @return A view of the copied text that lives as long as the arena
+    std::string_view copy(std::string_view text);
+
+    /// Releases all blocks but the first one and rewinds it
+    void reset();
+
+    /// Retrieves the number of bytes handed out by the arena
+    /// @return The number of bytes handed out by the arena
+    usize size() const;
+
+    /// Retrieves the number of bytes reserved by the arena
+    /// @return The number of bytes reserved by the arena
+    usize capacity() const;
+
+private:
+    struct Block {
+        Block *previous;
+        usize capacity;
+        usize used;
+    };
+
+    /// Allocates a new block that can hold at least the given number of bytes
+    /// @param size The required size in bytes
+    void grow(usize size);
+
+    /// Retrieves the payload of a block
+    /// @param block The block
+    /// @return A pointer to the first payload byte of the block
+    static u8 *payload(Block *block);
+
+    Block *head;
+    usize allocated;
+};
+
+}// namespace rt
+
+#endif// REALTIME_ARENA_H
@@ -0,0 +1,201 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Elias Engelbert Plank
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "base64.h"
+#include "cpu.h"
+
+#include <array>
+
+#if REALTIME_X86
+#include <immintrin.h>
+#endif
+
+namespace rt {
+
+namespace {
+
+/// The value of characters outside of the alphabet, whose highest bit marks them
+constexpr u8 INVALID = 0xFF;
+
+/// The six-bit values of all characters
+constexpr auto VALUES = [] {
+    std::array<u8, 256> table{};
+    table.fill(INVALID);
+    for (u8 index = 0; index < 26; index++) {
+        table['A' + index] = index;
+        table['a' + index] = static_cast<u8>(26 + index);
+    }
+    for (u8 index = 0; index < 10; index++) {
+        table['0' + index] = static_cast<u8>(52 + index);
+    }
+    table['+'] = 62;
+    table['/'] = 63;
+    return table;
+}();
+
+/// Strips the padding from the end of base64 text
+/// @param text The base64 text
+/// @return The text without padding
+std::string_view strip_padding(std::string_view text) {
+    if (text.size() % 4 == 0) {
+        for (auto padding = 0; padding < 2 and text.ends_with('='); padding++) {
+            text.remove_suffix(1);
+        }
+    }
+    return text;
+}
+
+/// Decodes base64 text without padding four characters at a time
+/// @param in The characters
+/// @param length The number of characters
+/// @param out The decoded bytes
+/// @return A value that indicates whether every character is part of the alphabet
+bool decode_scalar(const char *in, usize length, u8 *out) {
+    // Invalid characters are accumulated instead of branching on every character
+    u32 invalid = 0;
+    usize index = 0;
+    for (; index + 4 <= length; index += 4) {
+        u32 a = VALUES[static_cast<u8>(in[index])];
+        u32 b = VALUES[static_cast<u8>(in[index + 1])];
+        u32 c = VALUES[static_cast<u8>(in[index + 2])];
+        u32 d = VALUES[static_cast<u8>(in[index + 3])];
+        invalid |= a | b | c | d;
+        auto bits = a << 18 | b << 12 | c << 6 | d;
+        out[0] = static_cast<u8>(bits >> 16);
+        out[1] = static_cast<u8>(bits >> 8);
+        out[2] = static_cast<u8>(bits);
+        out += 3;
+    }
+
+    // The last two or three characters encode one or two bytes
+    u32 bits = 0;
+    auto remaining = length - index;
+    for (usize offset = 0; offset < remaining; offset++) {
+        u32 value = VALUES[static_cast<u8>(in[index + offset])];
+        invalid |= value;
+        bits |= value << (18 - 6 * offset);
+    }
+    if (remaining >= 2) {
+        out[0] = static_cast<u8>(bits >> 16);
+    }
+    if (remaining == 3) {
+        out[1] = static_cast<u8>(bits >> 8);
+    }
+    return (invalid & 0x80) == 0;
+}
+
+#if REALTIME_X86
+
+/// Decodes sixteen characters at a time. Characters are validated with two lookups by their low and high
+/// nibble whose results share a bit only for characters outside of the alphabet, translated by adding an
+/// offset that is looked up by their high nibble, and the four six-bit values of every 32-bit lane are packed
+/// into three bytes with two multiply-adds.
+/// @param in The characters
+/// @param length The number of characters
+/// @param out The decoded bytes
+/// @param end The end of the decoded bytes, every store writes sixteen bytes of which twelve are decoded
+/// @return The number of decoded characters, which is a multiple of sixteen, or std::nullopt if any character
+///         is not part of the alphabet
+REALTIME_TARGET("ssse3") std::optional<usize> decode_ssse3(const char *in, usize length, u8 *out, const u8 *end) {
+    const auto low_table = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B,
+                                         0x1B, 0x1B, 0x1A);
+    const auto high_table = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10,
+                                          0x10, 0x10, 0x10);
+    const auto offsets = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    const auto nibble = _mm_set1_epi8(0x0F);
+    const auto slash = _mm_set1_epi8('/');
+    const auto pairs = _mm_set1_epi32(0x01400140);
+    const auto quads = _mm_set1_epi32(0x00011000);
+    const auto order = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+
+    usize index = 0;
+    for (; index + 16 <= length and end - out >= 16; index += 16, out += 12) {
+        auto characters = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + index));
+        auto high = _mm_and_si128(_mm_srli_epi32(characters, 4), nibble);
+        auto low = _mm_and_si128(characters, nibble);
+        auto invalid = _mm_and_si128(_mm_shuffle_epi8(low_table, low), _mm_shuffle_epi8(high_table, high));
+        if (_mm_movemask_epi8(_mm_cmpgt_epi8(invalid, _mm_setzero_si128())) != 0) {
+            return std::nullopt;
+        }
+
+        // The slash shares its high nibble with the plus, it is told apart by moving it to the previous offset
+        auto adjusted = _mm_add_epi8(_mm_cmpeq_epi8(characters, slash), high);
+        auto values = _mm_add_epi8(characters, _mm_shuffle_epi8(offsets, adjusted));
+        auto merged = _mm_madd_epi16(_mm_maddubs_epi16(values, pairs), quads);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm_shuffle_epi8(merged, order));
+    }
+    return index;
+}
+
+#endif
+
+}// namespace
+
+/// Retrieves the fastest backend that is supported by the host CPU
+Base64Decoder::Backend Base64Decoder::best() {
+    return supported(Backend::SSSE3) ? Backend::SSSE3 : Backend::SCALAR;
+}
+
+/// Checks whether the given backend is supported by the host CPU
+bool Base64Decoder::supported(Backend backend) {
+    switch (backend) {
+        case Backend::SSSE3:
+            return REALTIME_X86 and cpu_features().ssse3;
+        default:
+            return true;
+    }
+}
+
+/// Computes the number of bytes that base64 text decodes to
+std::optional<usize> Base64Decoder::decoded_size(std::string_view text) {
+    text = strip_padding(text);
+    if (text.size() % 4 == 1) {
+        return std::nullopt;
+    }
+    return text.size() / 4 * 3 + (text.size() % 4 == 0 ? 0 : text.size() % 4 - 1);
+}
+
+/// Decodes base64 text straight into the destination
+bool Base64Decoder::decode(std::string_view text, std::span<u8> out, Backend backend) {
+    auto size = decoded_size(text);
+    if (not size or *size != out.size()) {
+        return false;
+    }
+    text = strip_padding(text);
+    backend = supported(backend) ? backend : best();
+
+    usize decoded = 0;
+#if REALTIME_X86
+    if (backend == Backend::SSSE3) {
+        auto vectorized = decode_ssse3(text.data(), text.size(), out.data(), out.data() + out.size());
+        if (not vectorized) {
+            return false;
+        }
+        decoded = *vectorized;
+    }
+#endif
+    return decode_scalar(text.data() + decoded, text.size() - decoded, out.data() + decoded / 4 * 3);
+}
+
+}// namespace rt
@@ -0,0 +1,70 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Elias Engelbert Plank
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef REALTIME_BASE64_H
+#define REALTIME_BASE64_H
+
+#include <optional>
+#include <span>
+#include <string_view>
+
+#include "utility.h"
+
+namespace rt {
+
+/// A decoder for the standard base64 alphabet, as used by data URIs. Sixteen characters are validated,
+/// translated to their six-bit values and packed into twelve bytes at once.
+class Base64Decoder {
+public:
+    /// The implementations of the decoder
+    enum class Backend {
+        SCALAR,
+        SSSE3
+    };
+
+    /// Retrieves the fastest backend that is supported by the host CPU
+    /// @return The fastest backend
+    static Backend best();
+
+    /// Checks whether the given backend is supported by the host CPU
+    /// @param backend The backend
+    /// @return A value that indicates whether the backend is supported
+    static bool supported(Backend backend);
+
+    /// Computes the number of bytes that base64 text decodes to, the padding at its end is optional
+    /// @param text The base64 text
+    /// @return The number of bytes or std::nullopt if no base64 text has the length of the text
+    static std::optional<usize> decoded_size(std::string_view text);
+
+    /// Decodes base64 text straight into the destination
+    /// @param text The base64 text
+    /// @param out The decoded bytes, must hold exactly decoded_size(text) bytes
+    /// @param backend The backend, unsupported backends fall back to the fastest supported one
+    /// @return A value that indicates whether the text is well-formed, the destination is unspecified otherwise
+    static bool decode(std::string_view text, std::span<u8> out, Backend backend = best());
+};
+
+}// namespace rt
+
+#endif// REALTIME_BASE64_H
@@ -0,0 +1,67 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Elias Engelbert Plank
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "cpu.h"
+
+#if REALTIME_X86 && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace rt {
+
+namespace {
+
+/// Detects the instruction set extensions of the host CPU
+/// @return The instruction set extensions
+CpuFeatures detect_cpu_features() {
+    CpuFeatures features{};
+#if REALTIME_X86 && (defined(__GNUC__) || defined(__clang__))
+    __builtin_cpu_init();
+    features.sse2 = __builtin_cpu_supports("sse2");
+    features.ssse3 = __builtin_cpu_supports("ssse3");
+    features.sse42 = __builtin_cpu_supports("sse4.2");
+    features.avx2 = __builtin_cpu_supports("avx2");
+#elif REALTIME_X86 && defined(_MSC_VER)
+    s32 info[4];
+    __cpuid(info, 1);
+    features.sse2 = info[3] & (1 << 26);
+    features.ssse3 = info[2] & (1 << 9);
+    features.sse42 = info[2] & (1 << 20);
+
+    // AVX state must be enabled by the operating system as well
+    auto os_avx = (info[2] & (1 << 27)) and (info[2] & (1 << 28)) and (_xgetbv(0) & 0x6) == 0x6;
+    __cpuidex(info, 7, 0);
+    features.avx2 = os_avx and (info[1] & (1 << 5));
+#endif
+    return features;
+}
+
+}// namespace
+
+/// Retrieves the instruction set extensions of the host CPU, which are detected once
+const CpuFeatures &cpu_features() {
+    static const auto features = detect_cpu_features();
+    return features;
+}
+
+}// namespace rt
@@ -0,0 +1,59 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Elias Engelbert Plank
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef REALTIME_CPU_H
+#define REALTIME_CPU_H
+
+#include "realtime.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define REALTIME_X86 1
+#else
+#define REALTIME_X86 0
+#endif
+
+/// Enables an instruction set extension for a single function, so that vectorized code paths can be
+/// compiled without raising the baseline of the whole build. MSVC does not need this.
+#if defined(__GNUC__) || defined(__clang__)
+#define REALTIME_TARGET(isa) __attribute__((target(isa)))
+#else
+#define REALTIME_TARGET(isa)
+#endif
+
+namespace rt {
+
+/// The instruction set extensions that are available on the host CPU
+struct CpuFeatures {
+    bool sse2;
+    bool ssse3;
+    bool sse42;
+    bool avx2;
+};
+
+/// Retrieves the instruction set extensions of the host CPU, which are detected once
+/// @return The instruction set extensions
+const CpuFeatures &cpu_features();
+
+}// namespace rt
+
+#endif// REALTIME_CPU_H
@@ -172,6 +172,8 @@ private:
     friend class Renderer;
     friend class RenderSystem;
     friend class GridSystem;
+    friend class Texture;
+    friend class TextureLoader;
     friend struct Buffer;
 
     Window &window;
@@ -25,6 +25,7 @@
 #define REALTIME_ENTITY_H
 
 #include <memory>
+#include <optional>
 
 #include "mesh.h"
 
@@ -70,6 +71,9 @@ public:
     glm::vec3 color{};
     TransformComponent transform;
 
+    /// The node of the entity in the hierarchy, whose world matrix is applied before the transform component
+    std::optional<u32> node;
+
 private:
     /// Creates a new entity
     /// @param id The entity id
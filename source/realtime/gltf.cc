@@ -22,59 +22,538 @@
 // SOFTWARE.
 
 #include "gltf.h"
-#include "json.h"
+#include "base64.h"
+#include "json_binding.h"
 
+#include <algorithm>
+#include <cstring>
 #include <string_view>
 
 namespace rt {
 
+template<>
+struct JsonSchema<gltf::Asset> {
+    static constexpr auto fields = std::tuple{
+        JsonField{ "version", &gltf::Asset::version, true },
+        JsonField{ "generator", &gltf::Asset::generator },
+    };
+};
+
+template<>
+struct JsonSchema<gltf::Buffer> {
+    static constexpr auto fields = std::tuple{
+        JsonField{ "byteLength", &gltf::Buffer::byte_length, true },
+        JsonField{ "uri", &gltf::Buffer::uri },
+        JsonField{ "name", &gltf::Buffer::name },
+    };
+};
+
+template<>
+struct JsonSchema<gltf::BufferView::MeshoptCompression::Mode> {
+    using Mode = gltf::BufferView::MeshoptCompression::Mode;
+    static constexpr std::array names = {
+        JsonName{ "ATTRIBUTES", Mode::ATTRIBUTES },
+        JsonName{ "TRIANGLES", Mode::TRIANGLES },
+        JsonName{ "INDICES", Mode::INDICES },
+    };
+};
+
+template<>
+struct JsonSchema<gltf::BufferView::MeshoptCompression::Filter> {
+    using Filter = gltf::BufferView::MeshoptCompression::Filter;
+    static constexpr std::array names = {
+        JsonName{ "NONE", Filter::NONE },
+        JsonName{ "OCTAHEDRAL", Filter::OCTAHEDRAL },
+        JsonName{ "QUATERNION", Filter::QUATERNION },
+        JsonName{ "EXPONENTIAL", Filter::EXPONENTIAL },
+    };
+};
+
+template<>
+struct JsonSchema<gltf::BufferView::MeshoptCompression> {
+    using MeshoptCompression = gltf::BufferView::MeshoptCompression;
+    static constexpr auto fields = std::tuple{
+        JsonField{ "buffer", &MeshoptCompression::buffer, true },
+        JsonField{ "byteOffset", &MeshoptCompression::byte_offset },
+        JsonField{ "byteLength", &MeshoptCompression::byte_length, true },
+        JsonField{ "byteStride", &MeshoptCompression::byte_stride, true },
+        JsonField{ "count", &MeshoptCompression::count, true },
+        JsonField{ "mode", &MeshoptCompression::mode, true },
+        JsonField{ "filter", &MeshoptCompression::filter },
+    };
+};
+
+template<>
+struct JsonSchema<gltf::BufferView::Extensions> {
+    static constexpr auto fields = std::tuple{
+        JsonField{ "EXT_meshopt_compression", &gltf::BufferView::Extensions::meshopt_compression },
+    };
+};
+
+template<>
+struct JsonSchema<gltf::BufferView> {
+    static constexpr auto fields = std::tuple{
+        JsonField{ "buffer", &gltf::BufferView::buffer, true },
+        JsonField{ "byteOffset", &gltf::BufferView::byte_offset },
+        JsonField{ "byteLength", &gltf::BufferView::byte_length, true },
+        JsonField{ "byteStride", &gltf::BufferView::byte_stride },
+        JsonField{ "target", &gltf::BufferView::target },
+        JsonField{ "name", &gltf::BufferView::name },
+        JsonField{ "extensions", &gltf::BufferView::extensions },
+    };
+};
+
+template<>
+struct JsonSchema<gltf::Accessor::Type> {
+    static constexpr std::array names = {
+        JsonName{ "SCALAR", gltf::Accessor::Type::SCALAR }, JsonName{ "VEC2", gltf::Accessor::Type::VEC2 },
+        JsonName{ "VEC3", gltf::Accessor::Type::VEC3 },     JsonName{ "VEC4", gltf::Accessor::Type::VEC4 },
+        JsonName{ "MAT2", gltf::Accessor::Type::MAT2 },     JsonName{ "MAT3", gltf::Accessor::Type::MAT3 },
+        JsonName{ "MAT4", gltf::Accessor::Type::MAT4 },
+    };
+};
+
+template<>
+struct JsonSchema<gltf::Accessor::Sparse::Indices> {
+    using Indices = gltf::Accessor::Sparse::Indices;
+    static constexpr auto fields = std::tuple{
+        JsonField{ "bufferView", &Indices::buffer_view, true },
+        JsonField{ "byteOffset", &Indices::byte_offset },
+        JsonField{ "componentType", &Indices::component_type, true },
+    };
+};
+
+template<>
+struct JsonSchema<gltf::Accessor::Sparse::Values> {
+    using Values = gltf::Accessor::Sparse::Values;
+    static constexpr auto fields = std::tuple{
+        JsonField{ "bufferView", &Values::buffer_view, true },
+        JsonField{ "byteOffset", &Values::byte_offset },
+    };
+};
+
+template<>
+struct JsonSchema<gltf::Accessor::Sparse> {
+    static constexpr auto fields = std::tuple{
+        JsonField{ "count", &gltf::Accessor::Sparse::count, true },
+        JsonField{ "indices", &gltf::Accessor::Sparse::indices, true },
+        JsonField{ "values", &gltf::Accessor::Sparse::values, true },
+    };
+};
+
+template<>
+struct JsonSchema<gltf::Accessor> {
+    static constexpr auto fields = std::tuple{
+        JsonField{ "bufferView", &gltf::Accessor::buffer_view },
+        JsonField{ "byteOffset", &gltf::Accessor::byte_offset },
+        JsonField{ "componentType", &gltf::Accessor::component_type, true },
+        JsonField{ "normalized", &gltf::Accessor::normalized },
+        JsonField{ "count", &gltf::Accessor::count, true },
+        JsonField{ "type", &gltf::Accessor::type, true },
+        JsonField{ "sparse", &gltf::Accessor::sparse },
+        JsonField{ "max", &gltf::Accessor::max },
+        JsonField{ "min", &gltf::Accessor::min },
+        JsonField{ "name", &gltf::Accessor::name },
+    };
+};
+
+template<>
+struct JsonSchema<gltf::Primitive::Attributes> {
+    static constexpr auto fields = std::tuple{
+        JsonField{ "POSITION", &gltf::Primitive::Attributes::position },
+        JsonField{ "NORMAL", &gltf::Primitive::Attributes::normal },
+        JsonField{ "TANGENT", &gltf::Primitive::Attributes::tangent },
+        JsonField{ "TEXCOORD_0", &gltf::Primitive::Attributes::texcoord_0 },
+        JsonField{ "TEXCOORD_1", &gltf::Primitive::Attributes::texcoord_1 },
+        JsonField{ "COLOR_0", &gltf::Primitive::Attributes::color_0 },
+        JsonField{ "JOINTS_0", &gltf::Primitive::Attributes::joints_0 },
+        JsonField{ "WEIGHTS_0", &gltf::Primitive::Attributes::weights_0 },
+    };
+};
+
+template<>
+struct JsonSchema<gltf::Primitive> {
+    static constexpr auto fields = std::tuple{
+        JsonField{ "attributes", &gltf::Primitive::attributes, true },
+        JsonField{ "targets", &gltf::Primitive::targets },
+        JsonField{ "indices", &gltf::Primitive::indices },
+        JsonField{ "material", &gltf::Primitive::material },
+        JsonField{ "mode", &gltf::Primitive::mode },
+    };
+};
+
+template<>
+struct JsonSchema<gltf::Mesh> {
+    static constexpr auto fields = std::tuple{
+        JsonField{ "primitives", &gltf::Mesh::primitives, true },
+        JsonField{ "weights", &gltf::Mesh::weights },
+        JsonField{ "name", &gltf::Mesh::name },
+    };
+};
+
+template<>
+struct JsonSchema<gltf::Node> {
+    static constexpr auto fields = std::tuple{
+        JsonField{ "children", &gltf::Node::children },
+        JsonField{ "mesh", &gltf::Node::mesh },
+        JsonField{ "skin", &gltf::Node::skin },
+        JsonField{ "matrix", &gltf::Node::matrix },
+        JsonField{ "translation", &gltf::Node::translation },
+        JsonField{ "rotation", &gltf::Node::rotation },
+        JsonField{ "scale", &gltf::Node::scale },
+        JsonField{ "name", &gltf::Node::name },
+    };
+};
+
+template<>
+struct JsonSchema<gltf::Skin> {
+    static constexpr auto fields = std::tuple{
+        JsonField{ "inverseBindMatrices", &gltf::Skin::inverse_bind_matrices },
+        JsonField{ "skeleton", &gltf::Skin::skeleton },
+        JsonField{ "joints", &gltf::Skin::joints, true },
+        JsonField{ "name", &gltf::Skin::name },
+    };
+};
+
+template<>
+struct JsonSchema<gltf::Image> {
+    static constexpr auto fields = std::tuple{
+        JsonField{ "uri", &gltf::Image::uri },
+        JsonField{ "bufferView", &gltf::Image::buffer_view },
+        JsonField{ "mimeType", &gltf::Image::mime_type },
+        JsonField{ "name", &gltf::Image::name },
+    };
+};
+
+template<>
+struct JsonSchema<gltf::Animation::Channel::Target::Path> {
+    using Path = gltf::Animation::Channel::Target::Path;
+    static constexpr std::array names = {
+        JsonName{ "translation", Path::TRANSLATION },
+        JsonName{ "rotation", Path::ROTATION },
+        JsonName{ "scale", Path::SCALE },
+        JsonName{ "weights", Path::WEIGHTS },
+    };
+};
+
+template<>
+struct JsonSchema<gltf::Animation::Channel::Target> {
+    using Target = gltf::Animation::Channel::Target;
+    static constexpr auto fields = std::tuple{
+        JsonField{ "node", &Target::node },
+        JsonField{ "path", &Target::path, true },
+    };
+};
+
+template<>
+struct JsonSchema<gltf::Animation::Channel> {
+    static constexpr auto fields = std::tuple{
+        JsonField{ "sampler", &gltf::Animation::Channel::sampler, true },
+        JsonField{ "target", &gltf::Animation::Channel::target, true },
+    };
+};
+
+template<>
+struct JsonSchema<gltf::Animation::Sampler::Interpolation> {
+    using Interpolation = gltf::Animation::Sampler::Interpolation;
+    static constexpr std::array names = {
+        JsonName{ "LINEAR", Interpolation::LINEAR },
+        JsonName{ "STEP", Interpolation::STEP },
+        JsonName{ "CUBICSPLINE", Interpolation::CUBICSPLINE },
+    };
+};
+
+template<>
+struct JsonSchema<gltf::Animation::Sampler> {
+    static constexpr auto fields = std::tuple{
+        JsonField{ "input", &gltf::Animation::Sampler::input, true },
+        JsonField{ "output", &gltf::Animation::Sampler::output, true },
+        JsonField{ "interpolation", &gltf::Animation::Sampler::interpolation },
+    };
+};
+
+template<>
+struct JsonSchema<gltf::Animation> {
+    static constexpr auto fields = std::tuple{
+        JsonField{ "channels", &gltf::Animation::channels, true },
+        JsonField{ "samplers", &gltf::Animation::samplers, true },
+        JsonField{ "name", &gltf::Animation::name },
+    };
+};
+
+template<>
+struct JsonSchema<gltf::Scene> {
+    static constexpr auto fields = std::tuple{
+        JsonField{ "nodes", &gltf::Scene::nodes },
+        JsonField{ "name", &gltf::Scene::name },
+    };
+};
+
+template<>
+struct JsonSchema<gltf::Document> {
+    static constexpr auto fields = std::tuple{
+        JsonField{ "asset", &gltf::Document::asset, true },
+        JsonField{ "buffers", &gltf::Document::buffers },
+        JsonField{ "bufferViews", &gltf::Document::buffer_views },
+        JsonField{ "accessors", &gltf::Document::accessors },
+        JsonField{ "meshes", &gltf::Document::meshes },
+        JsonField{ "nodes", &gltf::Document::nodes },
+        JsonField{ "skins", &gltf::Document::skins },
+        JsonField{ "animations", &gltf::Document::animations },
+        JsonField{ "images", &gltf::Document::images },
+        JsonField{ "scenes", &gltf::Document::scenes },
+        JsonField{ "scene", &gltf::Document::scene },
+    };
+};
+
 namespace {
 
 /// Consumes the given struct from a binary buffer
 /// @param buffer The binary buffer
 /// @return An optional struct if the struct fits into the buffer
 template<typename T>
-std::optional<T> consume(std::string_view &buffer) {
+std::optional<T> consume(std::span<const u8> &buffer) {
     if (sizeof(T) > buffer.size()) {
         return std::nullopt;
     }
-    auto *obj = reinterpret_cast<const T *>(buffer.data());
-    buffer.remove_prefix(sizeof(T));
-    return *obj;
+    T result;
+    std::memcpy(&result, buffer.data(), sizeof(T));
+    buffer = buffer.subspan(sizeof(T));
+    return result;
 }
 
 constexpr u32 GLB_HEADER_MAGIC = 0x46546C67;
 constexpr u32 GLB_VERSION_SUPPORTED = 2;
+constexpr usize GLB_CHUNK_ALIGNMENT = 4;
+
+/// Decodes the percent-encoded characters of a relative URI
+/// @param uri The URI
+/// @return The decoded URI or std::nullopt if any percent sign is not followed by two hexadecimal digits
+std::optional<std::string> percent_decode(std::string_view uri) {
+    auto digit = [](char character) -> std::optional<u8> {
+        if (character >= '0' and character <= '9') {
+            return static_cast<u8>(character - '0');
+        }
+        if (character >= 'a' and character <= 'f') {
+            return static_cast<u8>(character - 'a' + 10);
+        }
+        if (character >= 'A' and character <= 'F') {
+            return static_cast<u8>(character - 'A' + 10);
+        }
+        return std::nullopt;
+    };
+
+    std::string result{};
+    result.reserve(uri.size());
+    for (usize index = 0; index < uri.size(); index++) {
+        if (uri[index] != '%') {
+            result.push_back(uri[index]);
+            continue;
+        }
+        auto high = index + 1 < uri.size() ? digit(uri[index + 1]) : std::nullopt;
+        auto low = index + 2 < uri.size() ? digit(uri[index + 2]) : std::nullopt;
+        if (not high or not low) {
+            return std::nullopt;
+        }
+        result.push_back(static_cast<char>(*high << 4 | *low));
+        index += 2;
+    }
+    return result;
+}
+
+/// Resolves the data of a buffer from its URI, which is either a base64 data URI or a path relative to the
+/// glTF file
+/// @param uri The URI
+/// @param directory The directory of the glTF file
+/// @param storage The storage of the mapped and decoded data
+/// @return The data or std::nullopt if the URI is malformed, has another scheme or cannot be read
+std::optional<std::span<const u8>> resolve_uri(std::string_view uri, const fs::path &directory,
+                                               GltfFile::Storage &storage) {
+    // The media type of data URIs is irrelevant, only their encoding matters
+    constexpr std::string_view DATA_SCHEME = "data:";
+    constexpr std::string_view BASE64_ENCODING = ";base64";
+    if (uri.starts_with(DATA_SCHEME)) {
+        auto comma = uri.find(',');
+        if (comma == std::string_view::npos or not uri.substr(0, comma).ends_with(BASE64_ENCODING)) {
+            return std::nullopt;
+        }
+        auto text = uri.substr(comma + 1);
+        auto size = Base64Decoder::decoded_size(text);
+        if (not size) {
+            return std::nullopt;
+        }
+        auto &decoded = storage.decoded.emplace_back(*size);
+        if (not Base64Decoder::decode(text, decoded)) {
+            return std::nullopt;
+        }
+        return decoded;
+    }
+
+    // Relative URIs have no scheme, so a colon before the first slash marks an unsupported one
+    auto colon = uri.find(':');
+    if (colon != std::string_view::npos and colon < uri.find('/')) {
+        return std::nullopt;
+    }
+    auto relative = percent_decode(uri);
+    if (not relative) {
+        return std::nullopt;
+    }
+    auto file = MappedFile::open(directory / fs::path{ std::u8string{ relative->begin(), relative->end() } });
+    if (not file) {
+        return std::nullopt;
+    }
+    const auto &mapping = storage.mappings.emplace_back(std::make_shared<const MappedFile>(std::move(*file)));
+    return mapping->bytes();
+}
 
 }// namespace
 
+/// Decodes the JSON of a glTF document
+std::optional<gltf::Document> gltf::Document::parse(std::string_view data) {
+    return JsonBinding::decode<Document>(data);
+}
+
+/// Retrieves the JSON chunk
+std::string_view GlbFile::json() const {
+    const auto &data = chunks.front().data;
+    return { reinterpret_cast<const char *>(data.data()), data.size() };
+}
+
+/// Retrieves the binary chunk
+std::span<const u8> GlbFile::binary() const {
+    if (chunks.size() > 1 and chunks[1].type == Chunk::Type::BINARY) {
+        return chunks[1].data;
+    }
+    return {};
+}
 
 /// Tries to read a GLB file from disk
 std::optional<GlbFile> GlbFile::read(const fs::path &path) {
-    auto content = read_file(path, std::ios::binary);
-    if (not content) {
+    auto file = MappedFile::open(path);
+    if (not file) {
         return std::nullopt;
     }
+    return read(std::make_shared<const MappedFile>(std::move(*file)));
+}
 
-    // The buffer where we seek around
-    auto buffer = std::string_view{ *content };
+/// Tries to read a GLB file from a mapping
+std::optional<GlbFile> GlbFile::read(std::shared_ptr<const MappedFile> mapping) {
+    // The buffer where we seek around, bounded by the length the header declares
+    auto buffer = mapping->bytes();
     auto header = consume<Header>(buffer);
-    if (not header or header->magic != GLB_HEADER_MAGIC or header->version > GLB_VERSION_SUPPORTED) {
+    if (not header or header->magic != GLB_HEADER_MAGIC or header->version != GLB_VERSION_SUPPORTED or
+        header->length < sizeof(Header) or header->length > mapping->size()) {
         return std::nullopt;
     }
+    buffer = buffer.first(header->length - sizeof(Header));
+
+    // The JSON chunk comes first and the binary chunk, if any, second. Chunks of unknown types are kept,
+    // but must be bounded like all others.
+    std::vector<Chunk> chunks{};
+    while (not buffer.empty()) {
+        auto info = consume<Chunk::Info>(buffer);
+        if (not info or info->length > buffer.size()) {
+            return std::nullopt;
+        }
+        auto first = chunks.empty();
+        auto second = chunks.size() == 1;
+        if (first != (info->type == Chunk::Type::JSON) or (info->type == Chunk::Type::BINARY and not second)) {
+            return std::nullopt;
+        }
+        chunks.push_back({ info->type, buffer.first(info->length) });
 
-    auto chunk = consume<Chunk::Info>(buffer);
-    if (not chunk or chunk->type != Chunk::Type::JSON) {
+        // Chunks are padded to four bytes, a missing padding after the last one is tolerated
+        auto padded = (static_cast<usize>(info->length) + GLB_CHUNK_ALIGNMENT - 1) & ~(GLB_CHUNK_ALIGNMENT - 1);
+        buffer = buffer.subspan(std::min(padded, buffer.size()));
+    }
+    if (chunks.empty()) {
         return std::nullopt;
     }
 
-    auto view = std::string_view{ buffer.data(), chunk->length };
-    auto json = Json::parse(view);
-    if (not json) {
+    auto glb = GlbFile{ *header, std::move(chunks), {}, std::move(mapping) };
+    auto document = gltf::Document::parse(glb.json());
+    if (not document) {
         return std::nullopt;
     }
 
-    return std::nullopt;
+    // The first buffer refers to the binary chunk if it has no URI, which must be large enough for it
+    if (not document->buffers.empty() and not document->buffers.front().uri and
+        document->buffers.front().byte_length > glb.binary().size()) {
+        return std::nullopt;
+    }
+    glb.document = std::move(*document);
+    return glb;
+}
+
+/// Tries to read a glTF file from disk
+std::optional<GltfFile> GltfFile::read(const fs::path &path) {
+    auto file = MappedFile::open(path);
+    if (not file) {
+        return std::nullopt;
+    }
+    auto mapping = std::make_shared<const MappedFile>(std::move(*file));
+
+    auto result = GltfFile{};
+    auto storage = Storage{ { mapping }, {} };
+    auto bytes = mapping->bytes();
+    auto binary = std::optional<std::span<const u8>>{};
+    if (bytes.size() >= sizeof(u32) and consume<u32>(bytes) == GLB_HEADER_MAGIC) {
+        auto glb = GlbFile::read(mapping);
+        if (not glb) {
+            return std::nullopt;
+        }
+        result.document = std::move(glb->document);
+        binary = glb->binary();
+    } else {
+        auto document = gltf::Document::parse(mapping->view());
+        if (not document) {
+            return std::nullopt;
+        }
+        result.document = std::move(*document);
+    }
+
+    result.directory = path.parent_path();
+
+    // The first buffer of a binary container without URI refers to the binary chunk. Other buffers without URI
+    // hold no data, like the fallback buffers of EXT_meshopt_compression, so every view into them fails to
+    // resolve unless it is compressed.
+    for (usize index = 0; index < result.document.buffers.size(); index++) {
+        const auto &buffer = result.document.buffers[index];
+        auto data = std::optional<std::span<const u8>>{};
+        if (buffer.uri) {
+            data = resolve_uri(*buffer.uri, result.directory, storage);
+        } else if (index == 0 and binary) {
+            data = binary;
+        } else {
+            result.buffers.emplace_back();
+            continue;
+        }
+        if (not data or data->size() < buffer.byte_length) {
+            return std::nullopt;
+        }
+        result.buffers.push_back(data->first(buffer.byte_length));
+    }
+    result.storage = std::make_shared<const Storage>(std::move(storage));
+    return result;
+}
+
+/// Resolves the encoded data of an image
+std::optional<std::span<const u8>> GltfFile::image_data(u32 image, Storage &storage) const {
+    if (image >= document.images.size()) {
+        return std::nullopt;
+    }
+    const auto &info = document.images[image];
+    if (info.uri) {
+        return resolve_uri(*info.uri, directory, storage);
+    }
+    if (not info.buffer_view or *info.buffer_view >= document.buffer_views.size()) {
+        return std::nullopt;
+    }
+    const auto &view = document.buffer_views[*info.buffer_view];
+    if (view.buffer >= buffers.size() or u64{ view.byte_offset } + view.byte_length > buffers[view.buffer].size()) {
+        return std::nullopt;
+    }
+    return buffers[view.buffer].subspan(view.byte_offset, view.byte_length);
 }
 
-}// namespace rt
\ No newline at end of file
+}// namespace rt
@@ -21,10 +21,254 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#ifndef REALTIME_GLTF_H
+#define REALTIME_GLTF_H
+
+#include <array>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "mapped_file.h"
 #include "utility.h"
 
 namespace rt {
 
+namespace gltf {
+
+struct Asset {
+    std::string version;
+    std::string generator;
+};
+
+struct Buffer {
+    u32 byte_length;
+    std::optional<std::string> uri;
+    std::string name;
+};
+
+struct BufferView {
+    /// The compressed source of a buffer view with EXT_meshopt_compression, the buffer view itself refers to
+    /// a fallback buffer that usually holds no data
+    struct MeshoptCompression {
+        enum class Mode {
+            ATTRIBUTES,
+            TRIANGLES,
+            INDICES
+        };
+
+        enum class Filter {
+            NONE,
+            OCTAHEDRAL,
+            QUATERNION,
+            EXPONENTIAL
+        };
+
+        u32 buffer;
+        u32 byte_offset;
+        u32 byte_length;
+        u32 byte_stride;
+        u32 count;
+        Mode mode;
+        Filter filter = Filter::NONE;
+    };
+
+    struct Extensions {
+        std::optional<MeshoptCompression> meshopt_compression;
+    };
+
+    u32 buffer;
+    u32 byte_offset;
+    u32 byte_length;
+    std::optional<u32> byte_stride;
+    std::optional<u32> target;
+    std::string name;
+    Extensions extensions;
+};
+
+struct Accessor {
+    enum class ComponentType : u32 {
+        BYTE = 5120,
+        UNSIGNED_BYTE = 5121,
+        SHORT = 5122,
+        UNSIGNED_SHORT = 5123,
+        UNSIGNED_INT = 5125,
+        FLOAT = 5126
+    };
+
+    enum class Type {
+        SCALAR,
+        VEC2,
+        VEC3,
+        VEC4,
+        MAT2,
+        MAT3,
+        MAT4
+    };
+
+    /// The elements of a sparse accessor that replace the elements of its buffer view, or of all zeros if it
+    /// has none. The indices are strictly increasing, the values tightly packed.
+    struct Sparse {
+        struct Indices {
+            u32 buffer_view;
+            u32 byte_offset;
+            ComponentType component_type;
+        };
+
+        struct Values {
+            u32 buffer_view;
+            u32 byte_offset;
+        };
+
+        u32 count;
+        Indices indices;
+        Values values;
+    };
+
+    std::optional<u32> buffer_view;
+    u32 byte_offset;
+    ComponentType component_type;
+    bool normalized;
+    u32 count;
+    Type type;
+    std::optional<Sparse> sparse;
+    std::vector<f64> max;
+    std::vector<f64> min;
+    std::string name;
+};
+
+struct Primitive {
+    enum class Mode : u32 {
+        POINTS = 0,
+        LINES = 1,
+        LINE_LOOP = 2,
+        LINE_STRIP = 3,
+        TRIANGLES = 4,
+        TRIANGLE_STRIP = 5,
+        TRIANGLE_FAN = 6
+    };
+
+    /// The accessor indices of the vertex attributes
+    struct Attributes {
+        std::optional<u32> position;
+        std::optional<u32> normal;
+        std::optional<u32> tangent;
+        std::optional<u32> texcoord_0;
+        std::optional<u32> texcoord_1;
+        std::optional<u32> color_0;
+        std::optional<u32> joints_0;
+        std::optional<u32> weights_0;
+    };
+
+    Attributes attributes;
+
+    /// The morph targets, whose attributes hold displacements of the vertex attributes
+    std::vector<Attributes> targets;
+    std::optional<u32> indices;
+    std::optional<u32> material;
+    Mode mode = Mode::TRIANGLES;
+};
+
+struct Mesh {
+    std::vector<Primitive> primitives;
+    std::vector<f32> weights;
+    std::string name;
+};
+
+/// A node of the scene graph, whose local transform is either a matrix or translation, rotation and scale
+struct Node {
+    std::vector<u32> children;
+    std::optional<u32> mesh;
+    std::optional<u32> skin;
+    std::optional<std::array<f32, 16>> matrix;
+    std::array<f32, 3> translation{};
+    std::array<f32, 4> rotation{ 0.0f, 0.0f, 0.0f, 1.0f };
+    std::array<f32, 3> scale{ 1.0f, 1.0f, 1.0f };
+    std::string name;
+};
+
+/// The joints of a skin, whose inverse bind matrices are identities if absent
+struct Skin {
+    std::optional<u32> inverse_bind_matrices;
+    std::optional<u32> skeleton;
+    std::vector<u32> joints;
+    std::string name;
+};
+
+struct Animation {
+    struct Channel {
+        struct Target {
+            enum class Path {
+                TRANSLATION,
+                ROTATION,
+                SCALE,
+                WEIGHTS
+            };
+
+            std::optional<u32> node;
+            Path path;
+        };
+
+        u32 sampler;
+        Target target;
+    };
+
+    /// The keyframe times of a sampler are its input, the keyframe values its output
+    struct Sampler {
+        enum class Interpolation {
+            LINEAR,
+            STEP,
+            CUBICSPLINE
+        };
+
+        u32 input;
+        u32 output;
+        Interpolation interpolation = Interpolation::LINEAR;
+    };
+
+    std::vector<Channel> channels;
+    std::vector<Sampler> samplers;
+    std::string name;
+};
+
+/// An encoded image, stored either at a URI or in a buffer view together with its MIME type
+struct Image {
+    std::optional<std::string> uri;
+    std::optional<u32> buffer_view;
+    std::string mime_type;
+    std::string name;
+};
+
+struct Scene {
+    std::vector<u32> nodes;
+    std::string name;
+};
+
+/// The parts of a glTF document that are needed to import meshes and their scene graph
+struct Document {
+    Asset asset;
+    std::vector<Buffer> buffers;
+    std::vector<BufferView> buffer_views;
+    std::vector<Accessor> accessors;
+    std::vector<Mesh> meshes;
+    std::vector<Node> nodes;
+    std::vector<Skin> skins;
+    std::vector<Animation> animations;
+    std::vector<Image> images;
+    std::vector<Scene> scenes;
+    std::optional<u32> scene;
+
+    /// Decodes the JSON of a glTF document, skipping everything that is not needed
+    /// @param data The stringified JSON data
+    /// @return An optional glTF document
+    static std::optional<Document> parse(std::string_view data);
+};
+
+}// namespace gltf
+
+/// A binary glTF container that is memory-mapped instead of read. The header and every chunk are bounds
+/// checked once when reading, afterwards the chunks are spans into the mapping, so the binary payload is
+/// never copied. Copies of the file share the mapping.
 struct GlbFile {
     struct Header {
         u32 magic;
@@ -42,15 +286,68 @@ struct GlbFile {
             u32 length;
             Type type;
         };
+
+        Type type;
+        std::span<const u8> data;
     };
 
     Header header;
     std::vector<Chunk> chunks;
+    gltf::Document document;
+    std::shared_ptr<const MappedFile> mapping;
+
+    /// Retrieves the JSON chunk, which is always the first chunk
+    /// @return The JSON text
+    std::string_view json() const;
+
+    /// Retrieves the binary chunk, which holds the buffer without URI
+    /// @return The binary payload, empty if the file has no binary chunk
+    std::span<const u8> binary() const;
 
     /// Tries to read a GLB file from disk
     /// @param path The path of the GLB file
     /// @return An optional GLB file
     static std::optional<GlbFile> read(const fs::path &path);
+
+    /// Tries to read a GLB file from a mapping
+    /// @param mapping The mapping of the GLB file
+    /// @return An optional GLB file
+    static std::optional<GlbFile> read(std::shared_ptr<const MappedFile> mapping);
+};
+
+/// A glTF asset together with the data of all of its buffers, read from a binary container or from a JSON
+/// file. Buffers with a relative URI are memory-mapped and buffers with a base64 data URI are decoded straight
+/// into their storage once, so no buffer is ever copied. Copies of the file share the data.
+struct GltfFile {
+    /// The mappings and decoded data the buffers refer to
+    struct Storage {
+        std::vector<std::shared_ptr<const MappedFile>> mappings;
+        std::vector<std::vector<u8>> decoded;
+    };
+
+    gltf::Document document;
+
+    /// The data of every buffer, indexed like the buffers of the document and trimmed to their byte length
+    std::vector<std::span<const u8>> buffers;
+    std::shared_ptr<const Storage> storage;
+
+    /// The directory that relative URIs are resolved against
+    fs::path directory;
+
+    /// Resolves the encoded data of an image. Images in buffer views refer to the buffers, images at a URI
+    /// are mapped or decoded into the given storage, so images can be resolved lazily on any thread.
+    /// @param image The index of the image
+    /// @param storage The storage of the mapped and decoded data
+    /// @return The encoded data or std::nullopt if the image is malformed or cannot be read
+    std::optional<std::span<const u8>> image_data(u32 image, Storage &storage) const;
+
+    /// Tries to read a glTF file from disk. Files that start with the magic of binary containers are read as
+    /// such, all others as JSON. External buffers are resolved relative to the directory of the file.
+    /// @param path The path of the glTF or GLB file
+    /// @return An optional glTF file
+    static std::optional<GltfFile> read(const fs::path &path);
 };
 
 }// namespace rt
+
+#endif// REALTIME_GLTF_H
@@ -0,0 +1,685 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Elias Engelbert Plank
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "gltf_accessor.h"
+#include "cpu.h"
+#include "gltf_meshopt.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <limits>
+
+#if REALTIME_X86
+#include <immintrin.h>
+#endif
+
+namespace rt {
+
+namespace gltf {
+
+namespace {
+
+/// The number of elements that are gathered, converted and scattered at once
+constexpr usize BLOCK_SIZE = 256;
+
+/// The largest number of components of an element, a 4x4 matrix
+constexpr usize MAX_COMPONENTS = 16;
+
+/// Loads a component of the given type from possibly unaligned memory
+/// @tparam T The component type
+/// @param bytes The bytes of the component
+/// @return The component
+template<typename T>
+T load(const u8 *bytes) {
+    T result;
+    std::memcpy(&result, bytes, sizeof(T));
+    return result;
+}
+
+/// Retrieves the factor that maps a normalized integer component to [0, 1] or [-1, 1]
+/// @tparam T The component type
+/// @return The factor
+template<typename T>
+constexpr f32 normalization() {
+    return 1.0f / static_cast<f32>(std::numeric_limits<T>::max());
+}
+
+/// Converts contiguous components to floats one at a time
+/// @tparam T The component type
+/// @param in The components
+/// @param count The number of components
+/// @param out The floats
+/// @param normalized Whether the components are normalized integers
+template<typename T>
+void convert_scalar(const u8 *in, usize count, f32 *out, bool normalized) {
+    if constexpr (std::is_same_v<T, f32>) {
+        std::memcpy(out, in, count * sizeof(f32));
+    } else {
+        auto scale = normalized ? normalization<T>() : 1.0f;
+        for (usize index = 0; index < count; index++) {
+            auto value = static_cast<f32>(load<T>(in + index * sizeof(T))) * scale;
+            // The most negative value of a signed normalized integer is clamped to -1
+            out[index] = std::is_signed_v<T> and normalized ? std::max(value, -1.0f) : value;
+        }
+    }
+}
+
+/// Widens strided indices to 32 bits, rebasing and range checking them
+/// @tparam T The index type
+/// @param in The first index
+/// @param stride The distance between indices in bytes
+/// @param count The number of indices
+/// @param out The widened indices
+/// @param base The value that is added to every index
+/// @param limit The exclusive upper bound of every index before rebasing
+/// @return A value that indicates whether every index is below the limit
+template<typename T>
+bool widen_scalar(const u8 *in, usize stride, usize count, u32 *out, u32 base, u32 limit) {
+    // The largest index is tracked instead of branching on every index, so the loop stays branch free
+    u32 largest = 0;
+    for (usize index = 0; index < count; index++) {
+        u32 value = load<T>(in + index * stride);
+        largest = std::max(largest, value);
+        out[index] = value + base;
+    }
+    return count == 0 or largest < limit;
+}
+
+#if REALTIME_X86
+
+/// Converts four 32-bit integers to floats and stores them
+/// @param integers The integers
+/// @param out The floats
+/// @param scale The factor that is applied to every float
+/// @param clamp Whether the floats are clamped to -1 from below
+REALTIME_TARGET("sse2") void store_floats(__m128i integers, f32 *out, __m128 scale, bool clamp) {
+    auto floats = _mm_mul_ps(_mm_cvtepi32_ps(integers), scale);
+    _mm_storeu_ps(out, clamp ? _mm_max_ps(floats, _mm_set1_ps(-1.0f)) : floats);
+}
+
+/// Converts contiguous 8-bit components to floats sixteen at a time
+/// @tparam T The component type, u8 or s8
+/// @param in The components
+/// @param count The number of components
+/// @param out The floats
+/// @param normalized Whether the components are normalized integers
+template<typename T>
+REALTIME_TARGET("sse2") void convert_bytes_sse2(const u8 *in, usize count, f32 *out, bool normalized) {
+    auto scale = _mm_set1_ps(normalized ? normalization<T>() : 1.0f);
+    auto clamp = std::is_signed_v<T> and normalized;
+    usize index = 0;
+    for (; index + 16 <= count; index += 16) {
+        auto bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + index));
+        __m128i low, high;
+        if constexpr (std::is_signed_v<T>) {
+            // Duplicating every byte into both halves of a word and shifting arithmetically sign-extends it
+            low = _mm_srai_epi16(_mm_unpacklo_epi8(bytes, bytes), 8);
+            high = _mm_srai_epi16(_mm_unpackhi_epi8(bytes, bytes), 8);
+            store_floats(_mm_srai_epi32(_mm_unpacklo_epi16(low, low), 16), out + index, scale, clamp);
+            store_floats(_mm_srai_epi32(_mm_unpackhi_epi16(low, low), 16), out + index + 4, scale, clamp);
+            store_floats(_mm_srai_epi32(_mm_unpacklo_epi16(high, high), 16), out + index + 8, scale, clamp);
+            store_floats(_mm_srai_epi32(_mm_unpackhi_epi16(high, high), 16), out + index + 12, scale, clamp);
+        } else {
+            auto zero = _mm_setzero_si128();
+            low = _mm_unpacklo_epi8(bytes, zero);
+            high = _mm_unpackhi_epi8(bytes, zero);
+            store_floats(_mm_unpacklo_epi16(low, zero), out + index, scale, clamp);
+            store_floats(_mm_unpackhi_epi16(low, zero), out + index + 4, scale, clamp);
+            store_floats(_mm_unpacklo_epi16(high, zero), out + index + 8, scale, clamp);
+            store_floats(_mm_unpackhi_epi16(high, zero), out + index + 12, scale, clamp);
+        }
+    }
+    convert_scalar<T>(in + index, count - index, out + index, normalized);
+}
+
+/// Converts contiguous 16-bit components to floats eight at a time
+/// @tparam T The component type, u16 or s16
+/// @param in The components
+/// @param count The number of components
+/// @param out The floats
+/// @param normalized Whether the components are normalized integers
+template<typename T>
+REALTIME_TARGET("sse2") void convert_words_sse2(const u8 *in, usize count, f32 *out, bool normalized) {
+    auto scale = _mm_set1_ps(normalized ? normalization<T>() : 1.0f);
+    auto clamp = std::is_signed_v<T> and normalized;
+    usize index = 0;
+    for (; index + 8 <= count; index += 8) {
+        auto words = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + index * sizeof(T)));
+        if constexpr (std::is_signed_v<T>) {
+            store_floats(_mm_srai_epi32(_mm_unpacklo_epi16(words, words), 16), out + index, scale, clamp);
+            store_floats(_mm_srai_epi32(_mm_unpackhi_epi16(words, words), 16), out + index + 4, scale, clamp);
+        } else {
+            auto zero = _mm_setzero_si128();
+            store_floats(_mm_unpacklo_epi16(words, zero), out + index, scale, clamp);
+            store_floats(_mm_unpackhi_epi16(words, zero), out + index + 4, scale, clamp);
+        }
+    }
+    convert_scalar<T>(in + index * sizeof(T), count - index, out + index, normalized);
+}
+
+/// Widens contiguous 16-bit indices to 32 bits eight at a time, rebasing and range checking them
+/// @param in The indices
+/// @param count The number of indices, at least one
+/// @param out The widened indices
+/// @param base The value that is added to every index
+/// @param limit The exclusive upper bound of every index before rebasing
+/// @return A value that indicates whether every index is below the limit
+REALTIME_TARGET("sse2") bool widen_words_sse2(const u8 *in, usize count, u32 *out, u32 base, u32 limit) {
+    // Saturating subtraction of the largest valid index leaves a nonzero word for every index out of range
+    auto zero = _mm_setzero_si128();
+    auto offset = _mm_set1_epi32(static_cast<s32>(base));
+    auto largest = _mm_set1_epi16(static_cast<s16>(std::min<u32>(limit - 1, std::numeric_limits<u16>::max())));
+    auto exceeded = _mm_setzero_si128();
+    usize index = 0;
+    for (; index + 8 <= count; index += 8) {
+        auto words = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + index * sizeof(u16)));
+        exceeded = _mm_or_si128(exceeded, _mm_subs_epu16(words, largest));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + index),
+                         _mm_add_epi32(_mm_unpacklo_epi16(words, zero), offset));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + index + 4),
+                         _mm_add_epi32(_mm_unpackhi_epi16(words, zero), offset));
+    }
+    auto valid = limit > 0 and _mm_movemask_epi8(_mm_cmpeq_epi8(exceeded, zero)) == 0xFFFF;
+    return widen_scalar<u16>(in + index * sizeof(u16), sizeof(u16), count - index, out + index, base, limit) and
+           valid;
+}
+
+#endif
+
+/// Copies float elements from one strided layout into another, the fixed size lets the compiler move every
+/// element with a few unaligned loads and stores instead of a call to memcpy
+/// @tparam N The number of floats that are copied per element
+/// @param in The first source element
+/// @param in_stride The distance between source elements in bytes
+/// @param count The number of elements
+/// @param out The first destination element
+/// @param out_stride The distance between destination elements in bytes
+template<usize N>
+void copy_floats(const u8 *in, usize in_stride, usize count, u8 *out, usize out_stride) {
+    for (usize index = 0; index < count; index++) {
+        std::memcpy(out + index * out_stride, in + index * in_stride, N * sizeof(f32));
+    }
+}
+
+/// Converts contiguous components of the given type to floats
+/// @param type The component type
+/// @param in The components
+/// @param count The number of components
+/// @param out The floats
+/// @param normalized Whether the components are normalized integers
+/// @param backend The backend, which must be supported
+void convert(Accessor::ComponentType type, const u8 *in, usize count, f32 *out, bool normalized,
+             AccessorView::Backend backend) {
+    [[maybe_unused]] auto sse2 = backend == AccessorView::Backend::SSE2;
+    switch (type) {
+        case Accessor::ComponentType::BYTE:
+#if REALTIME_X86
+            if (sse2) {
+                return convert_bytes_sse2<s8>(in, count, out, normalized);
+            }
+#endif
+            return convert_scalar<s8>(in, count, out, normalized);
+        case Accessor::ComponentType::UNSIGNED_BYTE:
+#if REALTIME_X86
+            if (sse2) {
+                return convert_bytes_sse2<u8>(in, count, out, normalized);
+            }
+#endif
+            return convert_scalar<u8>(in, count, out, normalized);
+        case Accessor::ComponentType::SHORT:
+#if REALTIME_X86
+            if (sse2) {
+                return convert_words_sse2<s16>(in, count, out, normalized);
+            }
+#endif
+            return convert_scalar<s16>(in, count, out, normalized);
+        case Accessor::ComponentType::UNSIGNED_SHORT:
+#if REALTIME_X86
+            if (sse2) {
+                return convert_words_sse2<u16>(in, count, out, normalized);
+            }
+#endif
+            return convert_scalar<u16>(in, count, out, normalized);
+        case Accessor::ComponentType::UNSIGNED_INT:
+            return convert_scalar<u32>(in, count, out, normalized);
+        case Accessor::ComponentType::FLOAT:
+            return convert_scalar<f32>(in, count, out, normalized);
+    }
+}
+
+/// Loads an unsigned index of the given type
+/// @param type The component type of the index, which must be unsigned and no float
+/// @param indices The first byte of the tightly packed indices
+/// @param index The position of the index
+/// @return The index
+u32 load_index(Accessor::ComponentType type, const u8 *indices, usize index) {
+    switch (type) {
+        case Accessor::ComponentType::UNSIGNED_BYTE:
+            return indices[index];
+        case Accessor::ComponentType::UNSIGNED_SHORT:
+            return load<u16>(indices + index * sizeof(u16));
+        default:
+            return load<u32>(indices + index * sizeof(u32));
+    }
+}
+
+/// Resolves the sparse elements of an accessor, making sure that they lie within their buffer views and that
+/// their indices are strictly increasing and refer to elements of the accessor
+/// @param document The glTF document
+/// @param views The data of every buffer view of the document
+/// @param info The accessor
+/// @param element The size of an element in bytes
+/// @return The sparse elements or std::nullopt if they are malformed or out of bounds
+std::optional<AccessorView::Sparse> resolve_sparse(const Document &document,
+                                                   std::span<const std::span<const u8>> views, const Accessor &info,
+                                                   usize element) {
+    const auto &sparse = *info.sparse;
+    auto type = sparse.indices.component_type;
+    if (sparse.count == 0 or sparse.count > info.count or
+        (type != Accessor::ComponentType::UNSIGNED_BYTE and type != Accessor::ComponentType::UNSIGNED_SHORT and
+         type != Accessor::ComponentType::UNSIGNED_INT)) {
+        return std::nullopt;
+    }
+    auto view_count = std::min(document.buffer_views.size(), views.size());
+    if (sparse.indices.buffer_view >= view_count or sparse.values.buffer_view >= view_count) {
+        return std::nullopt;
+    }
+
+    auto indices = views[sparse.indices.buffer_view];
+    auto values = views[sparse.values.buffer_view];
+    if (u64{ sparse.indices.byte_offset } + u64{ sparse.count } * component_size(type) > indices.size() or
+        u64{ sparse.values.byte_offset } + u64{ sparse.count } * element > values.size()) {
+        return std::nullopt;
+    }
+
+    auto result = AccessorView::Sparse{ sparse.count, indices.data() + sparse.indices.byte_offset, type,
+                                        values.data() + sparse.values.byte_offset, 0 };
+    u32 previous = 0;
+    for (u32 index = 0; index < sparse.count; index++) {
+        auto current = load_index(type, result.indices, index);
+        if (current >= info.count or (index > 0 and current <= previous)) {
+            return std::nullopt;
+        }
+        previous = current;
+    }
+    return result;
+}
+
+}// namespace
+
+/// Retrieves the number of components of an accessor type
+usize component_count(Accessor::Type type) {
+    switch (type) {
+        case Accessor::Type::SCALAR:
+            return 1;
+        case Accessor::Type::VEC2:
+            return 2;
+        case Accessor::Type::VEC3:
+            return 3;
+        case Accessor::Type::VEC4:
+        case Accessor::Type::MAT2:
+            return 4;
+        case Accessor::Type::MAT3:
+            return 9;
+        case Accessor::Type::MAT4:
+            return 16;
+    }
+    return 0;
+}
+
+/// Retrieves the size of a component type
+usize component_size(Accessor::ComponentType type) {
+    switch (type) {
+        case Accessor::ComponentType::BYTE:
+        case Accessor::ComponentType::UNSIGNED_BYTE:
+            return 1;
+        case Accessor::ComponentType::SHORT:
+        case Accessor::ComponentType::UNSIGNED_SHORT:
+            return 2;
+        case Accessor::ComponentType::UNSIGNED_INT:
+        case Accessor::ComponentType::FLOAT:
+            return 4;
+    }
+    return 0;
+}
+
+/// Resolves the data of every buffer view of a document, decoding compressed ones into the given storage
+std::optional<std::vector<std::span<const u8>>> resolve_views(const Document &document,
+                                                              std::span<const std::span<const u8>> buffers,
+                                                              std::vector<std::vector<u8>> &storage) {
+    std::vector<std::span<const u8>> views{};
+    views.reserve(document.buffer_views.size());
+    for (const auto &buffer_view : document.buffer_views) {
+        const auto &compression = buffer_view.extensions.meshopt_compression;
+        auto buffer = compression ? compression->buffer : buffer_view.buffer;
+        auto offset = compression ? compression->byte_offset : buffer_view.byte_offset;
+        auto length = compression ? compression->byte_length : buffer_view.byte_length;
+        if (buffer >= buffers.size() or u64{ offset } + length > buffers[buffer].size()) {
+            return std::nullopt;
+        }
+        auto data = buffers[buffer].subspan(offset, length);
+        if (not compression) {
+            views.push_back(data);
+            continue;
+        }
+
+        // The buffer of a compressed buffer view is a fallback that usually holds no data at all, so the decoded
+        // data replaces it entirely. Data that is too short to fill it is rejected before its memory is allocated.
+        if (u64{ compression->count } * compression->byte_stride != buffer_view.byte_length or
+            buffer_view.byte_length > u64{ length } * MeshoptDecoder::MAX_EXPANSION) {
+            return std::nullopt;
+        }
+        auto &decoded = storage.emplace_back(buffer_view.byte_length);
+        if (not MeshoptDecoder::decode(*compression, data, decoded)) {
+            return std::nullopt;
+        }
+        views.emplace_back(decoded);
+    }
+    return views;
+}
+
+/// Creates a view of an accessor
+std::optional<AccessorView> AccessorView::create(const Document &document, std::span<const std::span<const u8>> views,
+                                                 u32 accessor) {
+    if (accessor >= document.accessors.size()) {
+        return std::nullopt;
+    }
+    const auto &info = document.accessors[accessor];
+    auto components = component_count(info.type);
+    auto size = component_size(info.component_type);
+    if (components == 0 or size == 0) {
+        return std::nullopt;
+    }
+
+    auto element = components * size;
+    auto view = AccessorView{ nullptr, info.count, element, info.component_type, components, info.normalized };
+    if (info.sparse) {
+        view.sparse = resolve_sparse(document, views, info, element);
+        if (not view.sparse) {
+            return std::nullopt;
+        }
+    }
+    if (not info.buffer_view) {
+        return view;
+    }
+
+    // All bounds are checked in 64 bits, so that no sum of 32-bit offsets and lengths can overflow
+    if (*info.buffer_view >= document.buffer_views.size() or *info.buffer_view >= views.size()) {
+        return std::nullopt;
+    }
+    const auto &buffer_view = document.buffer_views[*info.buffer_view];
+    auto data = views[*info.buffer_view];
+
+    view.stride = buffer_view.byte_stride.value_or(static_cast<u32>(element));
+    if (view.stride < element) {
+        return std::nullopt;
+    }
+    if (info.count > 0 and
+        u64{ info.byte_offset } + u64{ view.stride } * (info.count - 1) + element > data.size()) {
+        return std::nullopt;
+    }
+    view.data = data.data() + info.byte_offset;
+    return view;
+}
+
+/// Retrieves the fastest backend that is supported by the host CPU
+AccessorView::Backend AccessorView::best() {
+    return supported(Backend::SSE2) ? Backend::SSE2 : Backend::SCALAR;
+}
+
+/// Checks whether the given backend is supported by the host CPU
+bool AccessorView::supported(Backend backend) {
+    switch (backend) {
+        case Backend::SSE2:
+            return REALTIME_X86 and cpu_features().sse2;
+        default:
+            return true;
+    }
+}
+
+/// Creates a view of a range of the elements
+AccessorView AccessorView::slice(u32 first, u32 count) const {
+    auto view = *this;
+    view.count = count;
+    if (data != nullptr) {
+        view.data += usize{ first } * stride;
+    }
+    if (not sparse) {
+        return view;
+    }
+
+    // The sparse elements of the range are found by two binary searches over the increasing indices
+    auto begin = u64{ sparse->base } + first;
+    auto end = begin + count;
+    auto bound = [this](u64 index) {
+        u32 low = 0;
+        u32 high = sparse->count;
+        while (low < high) {
+            auto middle = low + (high - low) / 2;
+            if (load_index(sparse->index_type, sparse->indices, middle) < index) {
+                low = middle + 1;
+            } else {
+                high = middle;
+            }
+        }
+        return low;
+    };
+    auto low = bound(begin);
+    auto high = bound(end);
+    if (low == high) {
+        view.sparse.reset();
+        return view;
+    }
+    view.sparse->count = high - low;
+    view.sparse->indices += usize{ low } * component_size(sparse->index_type);
+    view.sparse->values += usize{ low } * components * component_size(component_type);
+    view.sparse->base = static_cast<u32>(begin);
+    return view;
+}
+
+/// Creates a view of the sparse values
+AccessorView AccessorView::sparse_values() const {
+    if (not sparse) {
+        return { nullptr, 0, stride, component_type, components, normalized };
+    }
+    auto element = components * component_size(component_type);
+    return { sparse->values, sparse->count, element, component_type, components, normalized };
+}
+
+/// Widens the indices of the sparse elements to 32 bits
+void AccessorView::read_sparse_indices(u32 *out, Backend backend) const {
+    if (not sparse) {
+        return;
+    }
+
+    // Rebasing wraps around, which subtracts the index of the first element of the view
+    auto indices = AccessorView{ sparse->indices, sparse->count, component_size(sparse->index_type),
+                                 sparse->index_type, 1, false };
+    indices.read_indices(out, 0u - sparse->base, std::numeric_limits<u32>::max(), backend);
+}
+
+/// Converts the elements to floats
+void AccessorView::read_floats(f32 *out, usize count, usize stride, Backend backend) const {
+    auto *destination = reinterpret_cast<u8 *>(out);
+    if (sparse) {
+        auto dense = *this;
+        dense.sparse.reset();
+        dense.read_floats(out, count, stride, backend);
+
+        // The sparse elements are converted a block at a time and scattered over the base data
+        assert(count <= MAX_COMPONENTS and "[gltf] Sparse elements have at most 16 components");
+        auto values = sparse_values();
+        u32 indices[BLOCK_SIZE];
+        f32 converted[BLOCK_SIZE * MAX_COMPONENTS];
+        for (u32 first = 0; first < sparse->count; first += BLOCK_SIZE) {
+            auto elements = std::min<u32>(BLOCK_SIZE, sparse->count - first);
+            auto block = *this;
+            block.sparse->count = elements;
+            block.sparse->indices += usize{ first } * component_size(sparse->index_type);
+            block.read_sparse_indices(indices, backend);
+            values.slice(first, elements).read_floats(converted, count, count * sizeof(f32), backend);
+            for (u32 index = 0; index < elements; index++) {
+                std::memcpy(destination + usize{ indices[index] } * stride, converted + index * count,
+                            count * sizeof(f32));
+            }
+        }
+        return;
+    }
+    if (data == nullptr) {
+        for (u32 index = 0; index < this->count; index++) {
+            std::memset(destination + index * stride, 0, count * sizeof(f32));
+        }
+        return;
+    }
+
+    auto size = component_size(component_type);
+    auto element = components * size;
+    auto copied = std::min(count, components);
+    backend = supported(backend) ? backend : best();
+
+    // Tightly packed elements that are read as they are need neither gathering nor scattering
+    if (this->stride == element and stride == count * sizeof(f32) and count == components) {
+        convert(component_type, data, usize{ this->count } * components, out, normalized, backend);
+        return;
+    }
+
+    // Floats need no conversion, so they are copied from element to element directly
+    if (component_type == Accessor::ComponentType::FLOAT and copied == count) {
+        switch (count) {
+            case 1:
+                return copy_floats<1>(data, this->stride, this->count, destination, stride);
+            case 2:
+                return copy_floats<2>(data, this->stride, this->count, destination, stride);
+            case 3:
+                return copy_floats<3>(data, this->stride, this->count, destination, stride);
+            case 4:
+                return copy_floats<4>(data, this->stride, this->count, destination, stride);
+            default:
+                break;
+        }
+    }
+
+    u8 gathered[BLOCK_SIZE * MAX_COMPONENTS * sizeof(u32)];
+    f32 converted[BLOCK_SIZE * MAX_COMPONENTS];
+    for (usize first = 0; first < this->count; first += BLOCK_SIZE) {
+        auto elements = std::min<usize>(BLOCK_SIZE, this->count - first);
+        const auto *source = data + first * this->stride;
+        if (this->stride != element) {
+            for (usize index = 0; index < elements; index++) {
+                std::memcpy(gathered + index * element, source + index * this->stride, element);
+            }
+            source = gathered;
+        }
+        convert(component_type, source, elements * components, converted, normalized, backend);
+
+        auto *target = destination + first * stride;
+        auto *in = reinterpret_cast<const u8 *>(converted);
+        auto in_stride = components * sizeof(f32);
+        switch (copied) {
+            case 1:
+                copy_floats<1>(in, in_stride, elements, target, stride);
+                break;
+            case 2:
+                copy_floats<2>(in, in_stride, elements, target, stride);
+                break;
+            case 3:
+                copy_floats<3>(in, in_stride, elements, target, stride);
+                break;
+            case 4:
+                copy_floats<4>(in, in_stride, elements, target, stride);
+                break;
+            default:
+                for (usize index = 0; index < elements; index++) {
+                    std::memcpy(target + index * stride, in + index * in_stride, copied * sizeof(f32));
+                }
+                break;
+        }
+        if (count > copied) {
+            for (usize index = 0; index < elements; index++) {
+                std::memset(target + index * stride + copied * sizeof(f32), 0, (count - copied) * sizeof(f32));
+            }
+        }
+    }
+}
+
+/// Widens the elements of an unsigned scalar accessor to 32 bits
+bool AccessorView::read_indices(u32 *out, u32 base, u32 limit, Backend backend) const {
+    if (components != 1 or component_type == Accessor::ComponentType::BYTE or
+        component_type == Accessor::ComponentType::SHORT or component_type == Accessor::ComponentType::FLOAT) {
+        return false;
+    }
+    if (count == 0) {
+        return true;
+    }
+    if (sparse) {
+        auto dense = *this;
+        dense.sparse.reset();
+        if (not dense.read_indices(out, base, limit, backend)) {
+            return false;
+        }
+
+        // Sparse indices are widened a block at a time and scattered over the base data
+        auto values = sparse_values();
+        u32 positions[BLOCK_SIZE];
+        u32 widened[BLOCK_SIZE];
+        for (u32 first = 0; first < sparse->count; first += BLOCK_SIZE) {
+            auto elements = std::min<u32>(BLOCK_SIZE, sparse->count - first);
+            auto block = *this;
+            block.sparse->count = elements;
+            block.sparse->indices += usize{ first } * component_size(sparse->index_type);
+            block.read_sparse_indices(positions, backend);
+            if (not values.slice(first, elements).read_indices(widened, base, limit, backend)) {
+                return false;
+            }
+            for (u32 index = 0; index < elements; index++) {
+                out[positions[index]] = widened[index];
+            }
+        }
+        return true;
+    }
+    if (data == nullptr) {
+        std::fill_n(out, count, base);
+        return limit > 0;
+    }
+
+    auto size = component_size(component_type);
+    switch (component_type) {
+        case Accessor::ComponentType::UNSIGNED_SHORT:
+#if REALTIME_X86
+            if (stride == size and backend == Backend::SSE2 and supported(backend)) {
+                return widen_words_sse2(data, count, out, base, limit);
+            }
+#endif
+            return widen_scalar<u16>(data, stride, count, out, base, limit);
+        case Accessor::ComponentType::UNSIGNED_INT:
+            return widen_scalar<u32>(data, stride, count, out, base, limit);
+        default:
+            return widen_scalar<u8>(data, stride, count, out, base, limit);
+    }
+}
+
+}// namespace gltf
+
+}// namespace rt
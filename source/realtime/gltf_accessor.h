@@ -0,0 +1,152 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Elias Engelbert Plank
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef REALTIME_GLTF_ACCESSOR_H
+#define REALTIME_GLTF_ACCESSOR_H
+
+#include <limits>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "gltf.h"
+
+namespace rt {
+
+namespace gltf {
+
+/// Retrieves the number of components of an accessor type
+/// @param type The accessor type
+/// @return The number of components
+usize component_count(Accessor::Type type);
+
+/// Retrieves the size of a component type
+/// @param type The component type
+/// @return The size in bytes
+usize component_size(Accessor::ComponentType type);
+
+/// Resolves the data of every buffer view of a document, making sure that it lies within its buffer. Buffer
+/// views that are compressed with EXT_meshopt_compression are decoded into the given storage.
+/// @param document The glTF document
+/// @param buffers The data of every buffer of the document, indexed like its buffers
+/// @param storage The storage of the decoded buffer views, which must outlive the resolved data
+/// @return The data of every buffer view or std::nullopt if any buffer view is malformed or out of bounds
+std::optional<std::vector<std::span<const u8>>> resolve_views(const Document &document,
+                                                              std::span<const std::span<const u8>> buffers,
+                                                              std::vector<std::vector<u8>> &storage);
+
+/// A bounds-checked view of the elements of an accessor inside of the buffers of an asset. Elements are
+/// decoded a block at a time: the components of the block are gathered from the possibly interleaved buffer
+/// view, converted to their destination type with vectorized loops and scattered into the destination.
+struct AccessorView {
+    /// The instruction sets the conversion loops can be vectorized with
+    enum class Backend {
+        SCALAR,
+        SSE2
+    };
+
+    /// The elements of a sparse accessor that replace elements of the view. Sparse elements are never expanded
+    /// into the base data, they are scattered into the destination after the base data has been written.
+    struct Sparse {
+        u32 count;
+
+        /// The first of the strictly increasing indices, which are tightly packed
+        const u8 *indices;
+        Accessor::ComponentType index_type;
+
+        /// The first byte of the values, which are tightly packed elements
+        const u8 *values;
+
+        /// The index of the first element of the view within the accessor, which is subtracted from every index
+        u32 base;
+    };
+
+    /// The first byte of the first element, nullptr if the accessor has no buffer view and is all zeros
+    const u8 *data;
+    u32 count;
+    usize stride;
+    Accessor::ComponentType component_type;
+    usize components;
+    bool normalized;
+    std::optional<Sparse> sparse{};
+
+    /// Creates a view of an accessor, making sure that all of its elements lie within its buffer view
+    /// @param document The glTF document
+    /// @param views The data of every buffer view of the document, as resolved by resolve_views
+    /// @param accessor The index of the accessor
+    /// @return The view or std::nullopt if the accessor is malformed or out of bounds
+    static std::optional<AccessorView> create(const Document &document, std::span<const std::span<const u8>> views,
+                                              u32 accessor);
+
+    /// Retrieves the fastest backend that is supported by the host CPU
+    /// @return The fastest backend
+    static Backend best();
+
+    /// Checks whether the given backend is supported by the host CPU
+    /// @param backend The backend
+    /// @return A value that indicates whether the backend is supported
+    static bool supported(Backend backend);
+
+    /// Creates a view of a range of the elements, whose sparse elements are restricted to the range
+    /// @param first The first element
+    /// @param count The number of elements, first + count must not exceed the number of elements of the view
+    /// @return The view
+    AccessorView slice(u32 first, u32 count) const;
+
+    /// Creates a view of the sparse values, as if they were the elements of a dense accessor
+    /// @return The view, which has no elements if the view is not sparse
+    AccessorView sparse_values() const;
+
+    /// Widens the indices of the sparse elements to 32 bits, relative to the first element of the view
+    /// @param out The destination, must hold an index per sparse element
+    /// @param backend The backend, unsupported backends fall back to the fastest supported one
+    void read_sparse_indices(u32 *out, Backend backend = best()) const;
+
+    /// Converts the elements to floats, normalized integers are mapped to [0, 1] or [-1, 1] as the glTF
+    /// specification demands, other integers are converted as they are
+    /// @param out The first float of the first destination element
+    /// @param count The number of floats that are written per element, missing components are set to zero
+    ///              and surplus components are dropped
+    /// @param stride The distance between destination elements in bytes
+    /// @param backend The backend, unsupported backends fall back to the fastest supported one
+    void read_floats(f32 *out, usize count, usize stride, Backend backend = best()) const;
+
+    /// Widens the elements of an unsigned scalar accessor to 32 bits, rebasing them onto the vertices of
+    /// earlier primitives and checking them against the vertices of their own primitive in the same pass, so
+    /// that the destination, which may be mapped device memory, is never read back
+    /// @param out The destination, must hold an index per element
+    /// @param base The value that is added to every index
+    /// @param limit The exclusive upper bound of every index before rebasing, usually the number of vertices
+    /// @param backend The backend, unsupported backends fall back to the fastest supported one
+    /// @return A value that indicates whether the accessor holds unsigned scalars that are all below the limit,
+    ///         the destination is unspecified otherwise
+    bool read_indices(u32 *out, u32 base = 0, u32 limit = std::numeric_limits<u32>::max(),
+                      Backend backend = best()) const;
+};
+
+}// namespace gltf
+
+}// namespace rt
+
+#endif// REALTIME_GLTF_ACCESSOR_H
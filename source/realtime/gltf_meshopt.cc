@@ -0,0 +1,680 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Elias Engelbert Plank
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "gltf_meshopt.h"
+#include "cpu.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+
+#if REALTIME_X86
+#include <immintrin.h>
+#endif
+
+namespace rt {
+
+namespace gltf {
+
+namespace {
+
+constexpr u8 ATTRIBUTES_HEADER = 0xA0;
+constexpr u8 TRIANGLES_HEADER = 0xE0;
+constexpr u8 INDICES_HEADER = 0xD0;
+
+/// The largest number of bytes and elements of an attribute block
+constexpr usize BLOCK_BYTES = 8192;
+constexpr usize BLOCK_ELEMENTS = 256;
+
+/// The number of values in a group of packed bytes
+constexpr usize GROUP_SIZE = 16;
+
+/// The smallest size of the tail of an attribute stream, which ends with the baseline element
+constexpr usize TAIL_SIZE = 32;
+
+/// The size of the table of the most common triangle codes at the end of a triangle stream
+constexpr usize TRIANGLE_TABLE_SIZE = 16;
+
+/// Loads a value from possibly unaligned memory
+/// @tparam T The type of the value
+/// @param bytes The bytes of the value
+/// @return The value
+template<typename T>
+T load(const u8 *bytes) {
+    T result;
+    std::memcpy(&result, bytes, sizeof(T));
+    return result;
+}
+
+/// Stores a value to possibly unaligned memory
+/// @tparam T The type of the value
+/// @param bytes The bytes of the value
+/// @param value The value
+template<typename T>
+void store(u8 *bytes, T value) {
+    std::memcpy(bytes, &value, sizeof(T));
+}
+
+/// Reverses the zigzag encoding of a byte delta
+/// @param value The encoded delta
+/// @return The delta
+u8 unzigzag(u8 value) {
+    return static_cast<u8>((value >> 1) ^ (0u - (value & 1u)));
+}
+
+/// Decodes a group of sixteen values that are packed with the given mode. Packed values with all bits set
+/// are escapes, the actual value follows in the bytes after the packed ones.
+/// @param data The packed group
+/// @param end The end of the data that may be read
+/// @param out The sixteen values
+/// @param mode 0 for zeros, 1 for 2-bit, 2 for 4-bit and 3 for 8-bit values
+/// @return The data after the group, nullptr if the group exceeds the data
+const u8 *decode_group_scalar(const u8 *data, const u8 *end, u8 *out, u32 mode) {
+    switch (mode) {
+        case 0:
+            std::memset(out, 0, GROUP_SIZE);
+            return data;
+        case 3:
+            if (static_cast<usize>(end - data) < GROUP_SIZE) {
+                return nullptr;
+            }
+            std::memcpy(out, data, GROUP_SIZE);
+            return data + GROUP_SIZE;
+        default: {
+            auto bits = mode * 2;
+            auto packed = GROUP_SIZE * bits / 8;
+            if (static_cast<usize>(end - data) < packed) {
+                return nullptr;
+            }
+            auto escape = (1u << bits) - 1;
+            const auto *escapes = data + packed;
+            for (usize index = 0; index < GROUP_SIZE; index++) {
+                // The first value lives in the most significant bits
+                auto shift = 8 - bits - (index * bits) % 8;
+                auto value = (data[index * bits / 8] >> shift) & escape;
+                if (value == escape) {
+                    if (escapes == end) {
+                        return nullptr;
+                    }
+                    value = *escapes++;
+                }
+                out[index] = static_cast<u8>(value);
+            }
+            return escapes;
+        }
+    }
+}
+
+/// Reconstructs the elements of a block from their transposed deltas one byte at a time
+/// @param bytes The deltas, a run of aligned bytes per byte position
+/// @param aligned The number of deltas per byte position, a multiple of the group size
+/// @param count The number of elements
+/// @param stride The size of an element
+/// @param last The previous element, updated to the last element of the block
+/// @param out The elements
+void reconstruct_scalar(const u8 *bytes, usize aligned, usize count, usize stride, u8 *last, u8 *out) {
+    for (usize byte = 0; byte < stride; byte++) {
+        auto value = last[byte];
+        for (usize element = 0; element < count; element++) {
+            value = static_cast<u8>(value + unzigzag(bytes[byte * aligned + element]));
+            out[element * stride + byte] = value;
+        }
+        last[byte] = value;
+    }
+}
+
+#if REALTIME_X86
+
+/// The shuffles that move the escaped values of eight packed values into place, indexed by the mask of
+/// escapes, and the number of escapes of every mask
+struct EscapeTable {
+    u8 shuffles[256][8];
+    u8 counts[256];
+};
+
+/// Computes the escape table
+/// @return The escape table
+constexpr EscapeTable escape_table() {
+    EscapeTable table{};
+    for (u32 mask = 0; mask < 256; mask++) {
+        u8 count = 0;
+        for (u32 index = 0; index < 8; index++) {
+            // Shuffle indices with the high bit set produce zero
+            auto escaped = (mask >> index) & 1u;
+            table.shuffles[mask][index] = escaped ? count : 0x80;
+            count = static_cast<u8>(count + escaped);
+        }
+        table.counts[mask] = count;
+    }
+    return table;
+}
+
+constexpr auto ESCAPE_TABLE = escape_table();
+
+/// Replaces the escaped values of a group with the bytes that follow the packed values
+/// @param values The unpacked values
+/// @param escape The value of an escape
+/// @param escapes The bytes that follow the packed values
+/// @param out The sixteen values
+/// @return The number of bytes of escapes
+REALTIME_TARGET("ssse3") usize resolve_escapes(__m128i values, __m128i escape, const u8 *escapes, u8 *out) {
+    auto escaped = _mm_cmpeq_epi8(values, escape);
+    auto mask = static_cast<u32>(_mm_movemask_epi8(escaped));
+    auto low = mask & 0xFF;
+    auto high = mask >> 8;
+
+    // The escapes of the upper eight values follow those of the lower eight
+    auto low_shuffle = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(ESCAPE_TABLE.shuffles[low]));
+    auto high_shuffle = _mm_add_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(ESCAPE_TABLE.shuffles[high])),
+                                     _mm_set1_epi8(static_cast<s8>(ESCAPE_TABLE.counts[low])));
+    auto shuffle = _mm_unpacklo_epi64(low_shuffle, high_shuffle);
+    auto rest = _mm_loadu_si128(reinterpret_cast<const __m128i *>(escapes));
+    auto result = _mm_or_si128(_mm_shuffle_epi8(rest, shuffle), _mm_andnot_si128(escaped, values));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out), result);
+    return ESCAPE_TABLE.counts[low] + ESCAPE_TABLE.counts[high];
+}
+
+/// Decodes a group of sixteen packed values, unpacking all of them at once and resolving escapes with a shuffle.
+/// The group is read as whole vectors, which relies on the tail of the stream behind the end of the data.
+/// @param data The packed group
+/// @param end The end of the data that may be read, followed by at least 32 bytes of tail
+/// @param out The sixteen values
+/// @param mode 0 for zeros, 1 for 2-bit, 2 for 4-bit and 3 for 8-bit values
+/// @return The data after the group, nullptr if the group exceeds the data
+REALTIME_TARGET("ssse3") const u8 *decode_group_ssse3(const u8 *data, const u8 *end, u8 *out, u32 mode) {
+    usize size;
+    switch (mode) {
+        case 0:
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm_setzero_si128());
+            return data;
+        case 1: {
+            // Interleaving every byte with a shifted copy of itself twice spreads four 2-bit values over four bytes
+            auto packed = _mm_cvtsi32_si128(load<s32>(data));
+            auto pairs = _mm_unpacklo_epi8(_mm_srli_epi16(packed, 4), packed);
+            auto quads = _mm_unpacklo_epi8(_mm_srli_epi16(pairs, 2), pairs);
+            auto values = _mm_and_si128(quads, _mm_set1_epi8(3));
+            size = 4 + resolve_escapes(values, _mm_set1_epi8(3), data + 4, out);
+            break;
+        }
+        case 2: {
+            auto packed = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(data));
+            auto pairs = _mm_unpacklo_epi8(_mm_srli_epi16(packed, 4), packed);
+            auto values = _mm_and_si128(pairs, _mm_set1_epi8(15));
+            size = 8 + resolve_escapes(values, _mm_set1_epi8(15), data + 8, out);
+            break;
+        }
+        default:
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out),
+                             _mm_loadu_si128(reinterpret_cast<const __m128i *>(data)));
+            size = GROUP_SIZE;
+            break;
+    }
+    return static_cast<usize>(end - data) < size ? nullptr : data + size;
+}
+
+/// Reverses the zigzag encoding of sixteen byte deltas
+/// @param values The encoded deltas
+/// @return The deltas
+REALTIME_TARGET("sse2") __m128i unzigzag_sse2(__m128i values) {
+    auto halves = _mm_and_si128(_mm_srli_epi16(values, 1), _mm_set1_epi8(0x7F));
+    auto signs = _mm_sub_epi8(_mm_setzero_si128(), _mm_and_si128(values, _mm_set1_epi8(1)));
+    return _mm_xor_si128(halves, signs);
+}
+
+/// Reconstructs the elements of a block from their transposed deltas four bytes and sixteen elements at a time.
+/// The deltas of four byte positions are transposed into four vectors of four elements each, which turns the
+/// running sum over elements into a prefix sum over the lanes of a vector.
+/// @param bytes The deltas, a run of aligned bytes per byte position
+/// @param aligned The number of deltas per byte position, a multiple of the group size
+/// @param count The number of elements
+/// @param stride The size of an element, a multiple of four
+/// @param last The previous element, updated to the last element of the block
+/// @param out The elements
+REALTIME_TARGET("sse2")
+void reconstruct_sse2(const u8 *bytes, usize aligned, usize count, usize stride, u8 *last, u8 *out) {
+    for (usize byte = 0; byte < stride; byte += 4) {
+        auto previous = _mm_set1_epi32(load<s32>(last + byte));
+        for (usize first = 0; first < count; first += GROUP_SIZE) {
+            __m128i deltas[4];
+            for (usize row = 0; row < 4; row++) {
+                auto *row_bytes = bytes + (byte + row) * aligned + first;
+                deltas[row] = unzigzag_sse2(_mm_loadu_si128(reinterpret_cast<const __m128i *>(row_bytes)));
+            }
+            auto low01 = _mm_unpacklo_epi8(deltas[0], deltas[1]);
+            auto high01 = _mm_unpackhi_epi8(deltas[0], deltas[1]);
+            auto low23 = _mm_unpacklo_epi8(deltas[2], deltas[3]);
+            auto high23 = _mm_unpackhi_epi8(deltas[2], deltas[3]);
+            __m128i elements[4] = {
+                _mm_unpacklo_epi16(low01, low23),
+                _mm_unpackhi_epi16(low01, low23),
+                _mm_unpacklo_epi16(high01, high23),
+                _mm_unpackhi_epi16(high01, high23),
+            };
+
+            for (usize quad = 0; quad < 4; quad++) {
+                auto sums = _mm_add_epi8(elements[quad], _mm_slli_si128(elements[quad], 4));
+                sums = _mm_add_epi8(sums, _mm_slli_si128(sums, 8));
+                sums = _mm_add_epi8(sums, previous);
+                previous = _mm_shuffle_epi32(sums, 0xFF);
+                for (usize lane = 0; lane < 4; lane++) {
+                    auto element = first + quad * 4 + lane;
+                    if (element < count) {
+                        store(out + element * stride + byte, _mm_cvtsi128_si32(sums));
+                    }
+                    sums = _mm_srli_si128(sums, 4);
+                }
+            }
+        }
+    }
+
+    // The padding elements of the last group must not leak into the next block
+    std::memcpy(last, out + (count - 1) * stride, stride);
+}
+
+#endif
+
+/// Decodes an attribute stream
+/// @param data The compressed data
+/// @param out The elements
+/// @param count The number of elements
+/// @param stride The size of an element
+/// @param backend The backend, which must be supported
+/// @return A value that indicates whether the data is well-formed
+bool decode_attributes(std::span<const u8> data, u8 *out, usize count, usize stride, MeshoptDecoder::Backend backend) {
+    if (stride == 0 or stride % 4 != 0 or stride > BLOCK_ELEMENTS) {
+        return false;
+    }
+    auto tail = std::max(stride, TAIL_SIZE);
+    if (data.size() < 1 + tail or data[0] != ATTRIBUTES_HEADER) {
+        return false;
+    }
+
+    [[maybe_unused]] auto ssse3 = backend == MeshoptDecoder::Backend::SSSE3;
+    auto decode_group = [ssse3](const u8 *group, const u8 *end, u8 *values, u32 mode) {
+#if REALTIME_X86
+        if (ssse3) {
+            return decode_group_ssse3(group, end, values, mode);
+        }
+#endif
+        return decode_group_scalar(group, end, values, mode);
+    };
+
+    // The first element is encoded relative to the baseline at the very end of the stream
+    u8 last[BLOCK_ELEMENTS];
+    std::memcpy(last, data.data() + data.size() - stride, stride);
+
+    u8 bytes[BLOCK_BYTES];
+    auto block_size = std::min((BLOCK_BYTES / stride) & ~(GROUP_SIZE - 1), BLOCK_ELEMENTS);
+    const auto *cursor = data.data() + 1;
+    const auto *end = data.data() + data.size() - tail;
+    for (usize first = 0; first < count; first += block_size) {
+        auto elements = std::min(block_size, count - first);
+        auto aligned = (elements + GROUP_SIZE - 1) & ~(GROUP_SIZE - 1);
+
+        // Every byte position starts with two bits of mode per group
+        auto header_size = (aligned / GROUP_SIZE + 3) / 4;
+        for (usize byte = 0; byte < stride; byte++) {
+            if (static_cast<usize>(end - cursor) < header_size) {
+                return false;
+            }
+            const auto *header = cursor;
+            cursor += header_size;
+            for (usize group = 0; group < aligned / GROUP_SIZE; group++) {
+                auto mode = (header[group / 4] >> ((group % 4) * 2)) & 3u;
+                cursor = decode_group(cursor, end, bytes + byte * aligned + group * GROUP_SIZE, mode);
+                if (cursor == nullptr) {
+                    return false;
+                }
+            }
+        }
+
+#if REALTIME_X86
+        if (ssse3) {
+            reconstruct_sse2(bytes, aligned, elements, stride, last, out + first * stride);
+            continue;
+        }
+#endif
+        reconstruct_scalar(bytes, aligned, elements, stride, last, out + first * stride);
+    }
+    return cursor == end;
+}
+
+/// Decodes a variable-length integer of up to five bytes, seven bits at a time
+/// @param data The data, advanced past the integer
+/// @return The integer
+u32 decode_varint(const u8 *&data) {
+    u32 result = 0;
+    for (u32 shift = 0; shift < 35; shift += 7) {
+        auto byte = *data++;
+        result |= static_cast<u32>(byte & 0x7F) << shift;
+        if (byte < 0x80) {
+            break;
+        }
+    }
+    return result;
+}
+
+/// Decodes a zigzag-encoded index delta
+/// @param data The data, advanced past the delta
+/// @param last The previous index
+/// @return The index
+u32 decode_delta(const u8 *&data, u32 last) {
+    auto value = decode_varint(data);
+    return last + ((value >> 1) ^ (0u - (value & 1u)));
+}
+
+/// Writes an index
+/// @param out The indices
+/// @param index The position of the index
+/// @param stride The size of an index, 2 or 4
+/// @param value The index
+void write_index(u8 *out, usize index, usize stride, u32 value) {
+    if (stride == 2) {
+        store(out + index * 2, static_cast<u16>(value));
+    } else {
+        store(out + index * 4, value);
+    }
+}
+
+/// Decodes a triangle stream. Every triangle is a code byte that refers to a recent edge and vertex through two
+/// FIFOs of sixteen entries, or to new or explicitly encoded vertices. The FIFOs must be updated exactly as
+/// the encoder updated them.
+/// @param data The compressed data
+/// @param out The indices
+/// @param count The number of indices, a multiple of three
+/// @param stride The size of an index, 2 or 4
+/// @return A value that indicates whether the data is well-formed
+bool decode_triangles(std::span<const u8> data, u8 *out, usize count, usize stride) {
+    if (count % 3 != 0 or (stride != 2 and stride != 4)) {
+        return false;
+    }
+    if (data.size() < 1 + count / 3 + TRIANGLE_TABLE_SIZE or (data[0] & 0xF0) != TRIANGLES_HEADER or
+        (data[0] & 0x0F) > 1) {
+        return false;
+    }
+    auto version = data[0] & 0x0F;
+
+    u32 edges[16][2];
+    u32 vertices[16];
+    std::memset(edges, 0xFF, sizeof(edges));
+    std::memset(vertices, 0xFF, sizeof(vertices));
+    usize edge_offset = 0;
+    usize vertex_offset = 0;
+    u32 next = 0;
+    u32 last = 0;
+
+    // Version 1 encodes a delta of -1 or 1 from the last explicit vertex with the codes 13 and 14
+    u32 cached_limit = version >= 1 ? 13 : 15;
+
+    auto push_edge = [&](u32 a, u32 b) {
+        edges[edge_offset][0] = a;
+        edges[edge_offset][1] = b;
+        edge_offset = (edge_offset + 1) & 15;
+    };
+    auto push_vertex = [&](u32 vertex, bool advance = true) {
+        vertices[vertex_offset] = vertex;
+        vertex_offset = (vertex_offset + advance) & 15;
+    };
+
+    const auto *code = data.data() + 1;
+    const auto *cursor = code + count / 3;
+    const auto *end = data.data() + data.size() - TRIANGLE_TABLE_SIZE;
+    const auto *table = end;
+    for (usize index = 0; index < count; index += 3) {
+        // A triangle reads at most sixteen bytes, which the table after the end guarantees
+        if (cursor > end) {
+            return false;
+        }
+
+        auto triangle = *code++;
+        if (triangle < 0xF0) {
+            auto edge = triangle >> 4;
+            auto a = edges[(edge_offset - 1 - edge) & 15][0];
+            auto b = edges[(edge_offset - 1 - edge) & 15][1];
+            u32 cached = triangle & 15;
+            u32 c;
+            if (cached < cached_limit) {
+                c = cached == 0 ? next++ : vertices[(vertex_offset - 1 - cached) & 15];
+                push_vertex(c, cached == 0);
+            } else {
+                c = last = cached != 15 ? last + (cached == 13 ? u32(-1) : 1u) : decode_delta(cursor, last);
+                push_vertex(c);
+            }
+            write_index(out, index, stride, a);
+            write_index(out, index + 1, stride, b);
+            write_index(out, index + 2, stride, c);
+            push_edge(c, b);
+            push_edge(a, c);
+            continue;
+        }
+
+        // The codes below 0xFE refer to the table, the others are followed by their own auxiliary byte
+        u8 auxiliary = triangle < 0xFE ? table[triangle & 15] : *cursor++;
+        u32 cached_b = auxiliary >> 4;
+        u32 cached_c = auxiliary & 15;
+        auto explicit_a = triangle == 0xFF;
+        if (triangle >= 0xFE and auxiliary == 0) {
+            next = 0;
+        }
+
+        // All new vertices are numbered before any explicit vertex is decoded, as the encoder does
+        u32 a = explicit_a ? 0 : next++;
+        u32 b = cached_b == 0 ? next++ : vertices[(vertex_offset - cached_b) & 15];
+        u32 c = cached_c == 0 ? next++ : vertices[(vertex_offset - cached_c) & 15];
+        if (triangle >= 0xFE) {
+            if (explicit_a) {
+                a = last = decode_delta(cursor, last);
+            }
+            if (cached_b == 15) {
+                b = last = decode_delta(cursor, last);
+            }
+            if (cached_c == 15) {
+                c = last = decode_delta(cursor, last);
+            }
+        }
+        write_index(out, index, stride, a);
+        write_index(out, index + 1, stride, b);
+        write_index(out, index + 2, stride, c);
+        push_vertex(a);
+        push_vertex(b, cached_b == 0 or (triangle >= 0xFE and cached_b == 15));
+        push_vertex(c, cached_c == 0 or (triangle >= 0xFE and cached_c == 15));
+        push_edge(b, a);
+        push_edge(c, b);
+        push_edge(a, c);
+    }
+    return cursor == end;
+}
+
+/// Decodes an index sequence, every index is a delta from one of two previous indices
+/// @param data The compressed data
+/// @param out The indices
+/// @param count The number of indices
+/// @param stride The size of an index, 2 or 4
+/// @return A value that indicates whether the data is well-formed
+bool decode_indices(std::span<const u8> data, u8 *out, usize count, usize stride) {
+    constexpr usize SEQUENCE_TAIL_SIZE = 4;
+    if (stride != 2 and stride != 4) {
+        return false;
+    }
+    if (data.size() < 1 + count + SEQUENCE_TAIL_SIZE or (data[0] & 0xF0) != INDICES_HEADER or
+        (data[0] & 0x0F) > 1) {
+        return false;
+    }
+
+    u32 last[2] = {};
+    const auto *cursor = data.data() + 1;
+    const auto *end = data.data() + data.size() - SEQUENCE_TAIL_SIZE;
+    for (usize index = 0; index < count; index++) {
+        // An index reads at most five bytes, which the tail after the end guarantees
+        if (cursor >= end) {
+            return false;
+        }
+        auto value = decode_varint(cursor);
+        auto baseline = value & 1;
+        value >>= 1;
+        last[baseline] += (value >> 1) ^ (0u - (value & 1u));
+        write_index(out, index, stride, last[baseline]);
+    }
+    return cursor == end;
+}
+
+/// Rounds a float to the nearest integer, away from zero on ties
+/// @param value The float
+/// @return The integer
+s32 round_signed(f32 value) {
+    return static_cast<s32>(value + (value >= 0.0f ? 0.5f : -0.5f));
+}
+
+/// Reconstructs unit vectors from their octahedral encoding, the third component holds the encoding of one
+/// @tparam T The component type, s8 or s16
+/// @param out The elements of four components
+/// @param count The number of elements
+template<typename T>
+void filter_octahedral(u8 *out, usize count) {
+    constexpr auto MAX = static_cast<f32>((1 << (sizeof(T) * 8 - 1)) - 1);
+    for (usize element = 0; element < count; element++) {
+        auto *components = out + element * 4 * sizeof(T);
+        auto x = static_cast<f32>(load<T>(components));
+        auto y = static_cast<f32>(load<T>(components + sizeof(T)));
+        auto z = static_cast<f32>(load<T>(components + 2 * sizeof(T))) - std::fabs(x) - std::fabs(y);
+
+        // The lower hemisphere is folded over the diagonals
+        auto fold = std::min(z, 0.0f);
+        x += x >= 0.0f ? fold : -fold;
+        y += y >= 0.0f ? fold : -fold;
+
+        auto scale = MAX / std::sqrt(x * x + y * y + z * z);
+        store(components, static_cast<T>(round_signed(x * scale)));
+        store(components + sizeof(T), static_cast<T>(round_signed(y * scale)));
+        store(components + 2 * sizeof(T), static_cast<T>(round_signed(z * scale)));
+    }
+}
+
+/// Reconstructs unit quaternions from their three smallest components, the fourth component holds the index
+/// of the largest component in its lowest two bits and the scale of the others in the remaining ones
+/// @param out The elements of four 16-bit components
+/// @param count The number of elements
+void filter_quaternion(u8 *out, usize count) {
+    const auto scale = 1.0f / std::sqrt(2.0f);
+    for (usize element = 0; element < count; element++) {
+        auto *components = out + element * 4 * sizeof(s16);
+        auto encoded = load<s16>(components + 3 * sizeof(s16));
+        auto factor = scale / static_cast<f32>(encoded | 3);
+        auto x = static_cast<f32>(load<s16>(components)) * factor;
+        auto y = static_cast<f32>(load<s16>(components + sizeof(s16))) * factor;
+        auto z = static_cast<f32>(load<s16>(components + 2 * sizeof(s16))) * factor;
+        auto w = std::sqrt(std::max(1.0f - x * x - y * y - z * z, 0.0f));
+
+        auto largest = static_cast<usize>(encoded & 3);
+        store(components + ((largest + 1) & 3) * sizeof(s16), static_cast<s16>(round_signed(x * 32767.0f)));
+        store(components + ((largest + 2) & 3) * sizeof(s16), static_cast<s16>(round_signed(y * 32767.0f)));
+        store(components + ((largest + 3) & 3) * sizeof(s16), static_cast<s16>(round_signed(z * 32767.0f)));
+        store(components + largest * sizeof(s16), static_cast<s16>(static_cast<s32>(w * 32767.0f + 0.5f)));
+    }
+}
+
+/// Reconstructs floats from a 24-bit signed mantissa and an 8-bit signed exponent
+/// @param out The floats
+/// @param count The number of floats
+void filter_exponential(u8 *out, usize count) {
+    for (usize index = 0; index < count; index++) {
+        auto value = load<u32>(out + index * 4);
+        auto mantissa = static_cast<s32>(value << 8) >> 8;
+        auto exponent = static_cast<s32>(value) >> 24;
+
+        // Multiplying with a power of two built from the exponent bits avoids ldexp
+        auto power = std::bit_cast<f32>(static_cast<u32>(exponent + 127) << 23);
+        store(out + index * 4, power * static_cast<f32>(mantissa));
+    }
+}
+
+}// namespace
+
+/// Retrieves the fastest backend that is supported by the host CPU
+MeshoptDecoder::Backend MeshoptDecoder::best() {
+    return supported(Backend::SSSE3) ? Backend::SSSE3 : Backend::SCALAR;
+}
+
+/// Checks whether the given backend is supported by the host CPU
+bool MeshoptDecoder::supported(Backend backend) {
+    switch (backend) {
+        case Backend::SSSE3:
+            return REALTIME_X86 and cpu_features().ssse3;
+        default:
+            return true;
+    }
+}
+
+/// Decodes a compressed buffer view and applies its filter
+bool MeshoptDecoder::decode(const Compression &compression, std::span<const u8> data, std::span<u8> out,
+                            Backend backend) {
+    auto count = usize{ compression.count };
+    auto stride = usize{ compression.byte_stride };
+    if (out.size() < count * stride) {
+        return false;
+    }
+    backend = supported(backend) ? backend : best();
+
+    switch (compression.mode) {
+        case Compression::Mode::ATTRIBUTES:
+            if (not decode_attributes(data, out.data(), count, stride, backend)) {
+                return false;
+            }
+            break;
+        case Compression::Mode::TRIANGLES:
+            return compression.filter == Compression::Filter::NONE and
+                   decode_triangles(data, out.data(), count, stride);
+        case Compression::Mode::INDICES:
+            return compression.filter == Compression::Filter::NONE and decode_indices(data, out.data(), count, stride);
+    }
+
+    switch (compression.filter) {
+        case Compression::Filter::OCTAHEDRAL:
+            if (stride == 4) {
+                filter_octahedral<s8>(out.data(), count);
+                return true;
+            }
+            if (stride == 8) {
+                filter_octahedral<s16>(out.data(), count);
+                return true;
+            }
+            return false;
+        case Compression::Filter::QUATERNION:
+            if (stride != 8) {
+                return false;
+            }
+            filter_quaternion(out.data(), count);
+            return true;
+        case Compression::Filter::EXPONENTIAL:
+            filter_exponential(out.data(), count * stride / 4);
+            return true;
+        default:
+            return true;
+    }
+}
+
+}// namespace gltf
+
+}// namespace rt
@@ -0,0 +1,76 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Elias Engelbert Plank
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef REALTIME_GLTF_MESHOPT_H
+#define REALTIME_GLTF_MESHOPT_H
+
+#include <span>
+
+#include "gltf.h"
+
+namespace rt {
+
+namespace gltf {
+
+/// A decoder for buffer views that are compressed with EXT_meshopt_compression. Attributes are stored as
+/// zigzag-encoded byte deltas between consecutive elements, transposed so that every byte position of a block
+/// of elements is packed into groups of sixteen 0, 2, 4 or 8-bit values. Triangles are stored as edge and
+/// vertex FIFO references, index sequences as variable-length deltas.
+class MeshoptDecoder {
+public:
+    /// The implementations of the attribute decoder
+    enum class Backend {
+        SCALAR,
+        SSSE3
+    };
+
+    using Compression = BufferView::MeshoptCompression;
+
+    /// The largest factor by which compressed data can expand, a header byte of four groups of sixteen zeros
+    static constexpr usize MAX_EXPANSION = 64;
+
+    /// Retrieves the fastest backend that is supported by the host CPU
+    /// @return The fastest backend
+    static Backend best();
+
+    /// Checks whether the given backend is supported by the host CPU
+    /// @param backend The backend
+    /// @return A value that indicates whether the backend is supported
+    static bool supported(Backend backend);
+
+    /// Decodes a compressed buffer view and applies its filter
+    /// @param compression The compression of the buffer view
+    /// @param data The compressed data, the byte_length bytes at byte_offset of the compressed buffer
+    /// @param out The decoded data, must hold count elements of byte_stride bytes
+    /// @param backend The backend, unsupported backends fall back to the fastest supported one
+    /// @return A value that indicates whether the data is well-formed for the compression
+    static bool decode(const Compression &compression, std::span<const u8> data, std::span<u8> out,
+                       Backend backend = best());
+};
+
+}// namespace gltf
+
+}// namespace rt
+
+#endif// REALTIME_GLTF_MESHOPT_H
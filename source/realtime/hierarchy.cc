@@ -0,0 +1,169 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Elias Engelbert Plank
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "hierarchy.h"
+
+#include <cassert>
+
+namespace rt {
+
+namespace {
+
+/// Decomposes the local transform of a glTF node, whose matrix must not contain any shear
+/// @param node The glTF node
+/// @return The local transform
+NodeTransform decompose(const gltf::Node &node) {
+    if (not node.matrix) {
+        const auto &[tx, ty, tz] = node.translation;
+        const auto &[rx, ry, rz, rw] = node.rotation;
+        const auto &[sx, sy, sz] = node.scale;
+        return { { tx, ty, tz }, glm::normalize(glm::quat{ rw, rx, ry, rz }), { sx, sy, sz } };
+    }
+
+    // glTF matrices are column-major like the ones of glm
+    glm::mat4 matrix{};
+    for (usize column = 0; column < 4; column++) {
+        for (usize row = 0; row < 4; row++) {
+            matrix[column][row] = (*node.matrix)[column * 4 + row];
+        }
+    }
+
+    auto result = NodeTransform{};
+    result.translation = glm::vec3{ matrix[3] };
+    auto rotation = glm::mat3{ matrix };
+    result.scale = { glm::length(rotation[0]), glm::length(rotation[1]), glm::length(rotation[2]) };
+
+    // A mirroring matrix is represented by a negative scale
+    if (glm::determinant(rotation) < 0.0f) {
+        result.scale.x = -result.scale.x;
+    }
+    for (glm::length_t axis = 0; axis < 3; axis++) {
+        if (result.scale[axis] != 0.0f) {
+            rotation[axis] /= result.scale[axis];
+        }
+    }
+    result.rotation = glm::normalize(glm::quat_cast(rotation));
+    return result;
+}
+
+}// namespace
+
+/// Composes the transform
+glm::mat4 NodeTransform::matrix() const {
+    // Scaling the columns of the rotation is cheaper than multiplying three matrices
+    auto rotation_matrix = glm::mat3_cast(rotation);
+    return { glm::vec4{ rotation_matrix[0] * scale.x, 0.0f }, glm::vec4{ rotation_matrix[1] * scale.y, 0.0f },
+             glm::vec4{ rotation_matrix[2] * scale.z, 0.0f }, glm::vec4{ translation, 1.0f } };
+}
+
+/// Appends a node, whose parent must already be part of the hierarchy
+u32 Hierarchy::add(u32 parent, const NodeTransform &local, std::optional<u32> mesh) {
+    assert((parent == NONE or parent < parents.size()) and "[hierarchy] Parent must precede its children");
+    auto index = static_cast<u32>(parents.size());
+    parents.push_back(parent);
+    locals.push_back(local);
+    worlds.emplace_back(1.0f);
+    meshes.push_back(mesh);
+    return index;
+}
+
+/// Imports the nodes of a glTF scene breadth-first
+std::optional<Hierarchy> Hierarchy::from_gltf(const gltf::Document &document, std::optional<u32> scene) {
+    const auto &nodes = document.nodes;
+
+    // glTF nodes form a forest, so no node may be the child of more than one node
+    std::vector<bool> has_parent(nodes.size());
+    for (const auto &node : nodes) {
+        for (auto child : node.children) {
+            if (child >= nodes.size() or has_parent[child]) {
+                return std::nullopt;
+            }
+            has_parent[child] = true;
+        }
+    }
+
+    std::vector<u32> roots{};
+    if (document.scenes.empty()) {
+        for (u32 node = 0; node < nodes.size(); node++) {
+            if (not has_parent[node]) {
+                roots.push_back(node);
+            }
+        }
+    } else {
+        auto index = scene.value_or(document.scene.value_or(0));
+        if (index >= document.scenes.size()) {
+            return std::nullopt;
+        }
+        roots = document.scenes[index].nodes;
+    }
+
+    auto result = Hierarchy{};
+    result.gltf_nodes.assign(nodes.size(), NONE);
+    std::vector<u32> sources{};
+    auto visit = [&](u32 parent, u32 source) {
+        // A node that is visited twice is part of a cycle or listed twice as a root
+        if (source >= nodes.size() or result.gltf_nodes[source] != NONE or
+            (parent == NONE and has_parent[source])) {
+            return false;
+        }
+        const auto &node = nodes[source];
+        if (node.mesh and *node.mesh >= document.meshes.size()) {
+            return false;
+        }
+        result.gltf_nodes[source] = result.add(parent, decompose(node), node.mesh);
+        sources.push_back(source);
+        return true;
+    };
+    for (auto root : roots) {
+        if (not visit(NONE, root)) {
+            return std::nullopt;
+        }
+    }
+
+    // The hierarchy itself is the queue of the breadth-first traversal
+    for (u32 parent = 0; parent < result.size(); parent++) {
+        for (auto child : nodes[sources[parent]].children) {
+            if (not visit(parent, child)) {
+                return std::nullopt;
+            }
+        }
+    }
+    result.update();
+    return result;
+}
+
+/// Computes the world matrices of all nodes in a single sweep
+void Hierarchy::update() {
+    for (usize node = 0; node < parents.size(); node++) {
+        auto local = locals[node].matrix();
+        worlds[node] = parents[node] == NONE ? local : worlds[parents[node]] * local;
+    }
+}
+
+/// Retrieves the number of nodes
+usize Hierarchy::size() const {
+    return parents.size();
+}
+
+}// namespace rt
@@ -0,0 +1,92 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Elias Engelbert Plank
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef REALTIME_HIERARCHY_H
+#define REALTIME_HIERARCHY_H
+
+#include <limits>
+#include <optional>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "gltf.h"
+
+namespace rt {
+
+/// The local transform of a node, kept decomposed so that animations can replace any of its parts
+struct NodeTransform {
+    glm::vec3 translation{ 0.0f };
+    glm::quat rotation{ 1.0f, 0.0f, 0.0f, 0.0f };
+    glm::vec3 scale{ 1.0f };
+
+    /// Composes the transform, which corresponds to translation * rotation * scale
+    /// @return The transform
+    glm::mat4 matrix() const;
+};
+
+/// A node hierarchy that is stored as flat arrays, sorted so that every parent precedes all of its children.
+/// Updating the world matrices is a single linear sweep over the arrays without recursion or pointer chasing,
+/// as the world matrix of a node only depends on the one of its parent, which the sweep has already computed.
+class Hierarchy {
+public:
+    /// The parent of root nodes, and the node of glTF nodes that are not part of the hierarchy
+    static constexpr u32 NONE = std::numeric_limits<u32>::max();
+
+    /// Appends a node, whose parent must already be part of the hierarchy
+    /// @param parent The index of the parent or NONE for a root node
+    /// @param local The local transform
+    /// @param mesh The index of the mesh of the node, if any
+    /// @return The index of the node
+    u32 add(u32 parent, const NodeTransform &local, std::optional<u32> mesh = std::nullopt);
+
+    /// Imports the nodes of a glTF scene breadth-first, so that parents precede their children
+    /// @param document The glTF document
+    /// @param scene The index of the scene, the default scene of the document if absent. Documents without
+    ///              scenes import all nodes that are no child of another node.
+    /// @return The hierarchy or std::nullopt if the scene is missing, any node is malformed or the nodes do not
+    ///         form a forest
+    static std::optional<Hierarchy> from_gltf(const gltf::Document &document,
+                                              std::optional<u32> scene = std::nullopt);
+
+    /// Computes the world matrices of all nodes in a single sweep
+    void update();
+
+    /// Retrieves the number of nodes
+    /// @return The number of nodes
+    usize size() const;
+
+    std::vector<u32> parents;
+    std::vector<NodeTransform> locals;
+    std::vector<glm::mat4> worlds;
+    std::vector<std::optional<u32>> meshes;
+
+    /// The node every glTF node was imported as, NONE for glTF nodes outside of the imported scene
+    std::vector<u32> gltf_nodes;
+};
+
+}// namespace rt
+
+#endif// REALTIME_HIERARCHY_H
@@ -0,0 +1,367 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Elias Engelbert Plank
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "image.h"
+#include "zlib.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <cstring>
+#include <string_view>
+
+namespace rt {
+
+namespace {
+
+constexpr std::array<u8, 8> PNG_SIGNATURE = { 137, 80, 78, 71, 13, 10, 26, 10 };
+
+/// The largest number of pixels an image may have, which bounds the memory a malformed header can claim
+constexpr u64 MAX_PIXELS = u64{ 1 } << 28;
+
+/// The largest factor by which DEFLATE can expand its input, a length of 258 bytes coded in two bits
+constexpr usize MAX_EXPANSION = 258 * 8 / 2;
+
+enum class ColorType : u8 {
+    GRAY = 0,
+    RGB = 2,
+    PALETTE = 3,
+    GRAY_ALPHA = 4,
+    RGBA = 6
+};
+
+/// The layout of the samples of a PNG image
+struct Header {
+    u32 width;
+    u32 height;
+    u32 depth;
+    ColorType color_type;
+    u32 channels;
+};
+
+/// The palette entries and transparency of a PNG image
+struct Palette {
+    /// The colours of indexed images, entries past the palette are opaque black
+    std::array<std::array<u8, 4>, 256> entries;
+
+    /// The sample values of the transparent colour of grayscale and RGB images
+    std::optional<std::array<u16, 3>> key;
+};
+
+/// Loads a big-endian 32-bit integer
+/// @param data The bytes of the integer
+/// @return The integer
+u32 load_big_endian(const u8 *data) {
+    return u32{ data[0] } << 24 | u32{ data[1] } << 16 | u32{ data[2] } << 8 | u32{ data[3] };
+}
+
+/// Reads the header chunk and validates the combination of colour type and bit depth
+/// @param chunk The data of the header chunk
+/// @return The header or std::nullopt if it is malformed, interlaced or too large
+std::optional<Header> read_header(std::span<const u8> chunk) {
+    if (chunk.size() != 13) {
+        return std::nullopt;
+    }
+    auto header = Header{ load_big_endian(chunk.data()), load_big_endian(chunk.data() + 4), chunk[8],
+                          static_cast<ColorType>(chunk[9]), 0 };
+    auto depth = header.depth;
+    switch (header.color_type) {
+        case ColorType::GRAY:
+            header.channels = 1;
+            if (depth != 1 and depth != 2 and depth != 4 and depth != 8 and depth != 16) {
+                return std::nullopt;
+            }
+            break;
+        case ColorType::PALETTE:
+            header.channels = 1;
+            if (depth != 1 and depth != 2 and depth != 4 and depth != 8) {
+                return std::nullopt;
+            }
+            break;
+        case ColorType::RGB:
+        case ColorType::GRAY_ALPHA:
+        case ColorType::RGBA:
+            header.channels = header.color_type == ColorType::RGB ? 3 : header.color_type == ColorType::RGBA ? 4 : 2;
+            if (depth != 8 and depth != 16) {
+                return std::nullopt;
+            }
+            break;
+        default:
+            return std::nullopt;
+    }
+
+    // Compression, filter and interlace method, of which only the first ones are supported
+    if (chunk[10] != 0 or chunk[11] != 0 or chunk[12] != 0) {
+        return std::nullopt;
+    }
+    if (header.width == 0 or header.height == 0 or u64{ header.width } * header.height > MAX_PIXELS) {
+        return std::nullopt;
+    }
+    return header;
+}
+
+/// Predicts a byte from its left, upper and upper left neighbours
+/// @param left The left neighbour
+/// @param up The upper neighbour
+/// @param up_left The upper left neighbour
+/// @return The neighbour that is closest to their gradient
+u8 paeth(s32 left, s32 up, s32 up_left) {
+    auto estimate = left + up - up_left;
+    auto distance_left = std::abs(estimate - left);
+    auto distance_up = std::abs(estimate - up);
+    auto distance_up_left = std::abs(estimate - up_left);
+    if (distance_left <= distance_up and distance_left <= distance_up_left) {
+        return static_cast<u8>(left);
+    }
+    return static_cast<u8>(distance_up <= distance_up_left ? up : up_left);
+}
+
+/// Reverses the filters of all scanlines in place, every scanline is preceded by its filter type
+/// @param raw The filtered scanlines
+/// @param stride The number of bytes of a scanline without its filter type
+/// @param height The number of scanlines
+/// @param pixel_size The number of bytes of a pixel, at least one
+/// @return A value that indicates whether every filter type is valid
+bool unfilter(std::span<u8> raw, usize stride, usize height, usize pixel_size) {
+    // The scanline above the first one is all zeros
+    std::vector<u8> zeros(stride);
+    for (usize y = 0; y < height; y++) {
+        auto *row = raw.data() + y * (stride + 1);
+        auto *current = row + 1;
+        const auto *prior = y == 0 ? zeros.data() : current - (stride + 1);
+        switch (row[0]) {
+            case 0:
+                break;
+            case 1:
+                for (usize index = pixel_size; index < stride; index++) {
+                    current[index] = static_cast<u8>(current[index] + current[index - pixel_size]);
+                }
+                break;
+            case 2:
+                for (usize index = 0; index < stride; index++) {
+                    current[index] = static_cast<u8>(current[index] + prior[index]);
+                }
+                break;
+            case 3:
+                for (usize index = 0; index < stride; index++) {
+                    u32 left = index >= pixel_size ? current[index - pixel_size] : 0;
+                    current[index] = static_cast<u8>(current[index] + ((left + prior[index]) >> 1));
+                }
+                break;
+            case 4:
+                for (usize index = 0; index < stride; index++) {
+                    auto left = index >= pixel_size ? current[index - pixel_size] : 0;
+                    auto up_left = index >= pixel_size ? prior[index - pixel_size] : 0;
+                    current[index] = static_cast<u8>(current[index] + paeth(left, prior[index], up_left));
+                }
+                break;
+            default:
+                return false;
+        }
+    }
+    return true;
+}
+
+/// Expands the samples of a scanline to four 8-bit channels per pixel
+/// @param header The header
+/// @param palette The palette and transparency
+/// @param row The unfiltered scanline
+/// @param out The pixels
+void expand(const Header &header, const Palette &palette, const u8 *row, u8 *out) {
+    auto width = header.width;
+    auto depth = header.depth;
+    if (header.color_type == ColorType::RGBA and depth == 8) {
+        std::memcpy(out, row, usize{ width } * 4);
+        return;
+    }
+
+    // Samples are packed into bytes starting with the most significant bits, or stored big-endian
+    auto sample = [row, depth, channels = header.channels](u32 x, u32 channel) -> u32 {
+        auto index = x * channels + channel;
+        if (depth == 8) {
+            return row[index];
+        }
+        if (depth == 16) {
+            return u32{ row[index * 2] } << 8 | row[index * 2 + 1];
+        }
+        auto bit = index * depth;
+        return row[bit / 8] >> (8 - depth - bit % 8) & ((1u << depth) - 1);
+    };
+    auto to_byte = [depth](u32 value) -> u8 {
+        if (depth == 16) {
+            return static_cast<u8>(value >> 8);
+        }
+        return static_cast<u8>(value * 255 / ((1u << depth) - 1));
+    };
+
+    for (u32 x = 0; x < width; x++, out += 4) {
+        switch (header.color_type) {
+            case ColorType::GRAY: {
+                auto gray = sample(x, 0);
+                out[0] = out[1] = out[2] = to_byte(gray);
+                out[3] = palette.key and (*palette.key)[0] == gray ? 0 : 255;
+                break;
+            }
+            case ColorType::RGB: {
+                auto red = sample(x, 0);
+                auto green = sample(x, 1);
+                auto blue = sample(x, 2);
+                out[0] = to_byte(red);
+                out[1] = to_byte(green);
+                out[2] = to_byte(blue);
+                auto transparent = palette.key and (*palette.key)[0] == red and (*palette.key)[1] == green and
+                                   (*palette.key)[2] == blue;
+                out[3] = transparent ? 0 : 255;
+                break;
+            }
+            case ColorType::PALETTE:
+                std::memcpy(out, palette.entries[sample(x, 0)].data(), 4);
+                break;
+            case ColorType::GRAY_ALPHA:
+                out[0] = out[1] = out[2] = to_byte(sample(x, 0));
+                out[3] = to_byte(sample(x, 1));
+                break;
+            case ColorType::RGBA:
+                for (u32 channel = 0; channel < 4; channel++) {
+                    out[channel] = to_byte(sample(x, channel));
+                }
+                break;
+        }
+    }
+}
+
+/// Decodes a PNG image
+/// @param data The chunks of the image after its signature
+/// @return The image or std::nullopt if it is malformed or interlaced
+std::optional<Image> decode_png(std::span<const u8> data) {
+    std::optional<Header> header{};
+    Palette palette{};
+    for (auto &entry : palette.entries) {
+        entry = { 0, 0, 0, 255 };
+    }
+    usize palette_size = 0;
+    std::vector<std::span<const u8>> compressed{};
+
+    // Chunks are length, type, data and checksum, the header comes first and the end chunk last
+    for (auto end = false; not end;) {
+        if (data.size() < 12) {
+            return std::nullopt;
+        }
+        auto length = load_big_endian(data.data());
+        auto type = std::string_view{ reinterpret_cast<const char *>(data.data() + 4), 4 };
+        if (length > data.size() - 12) {
+            return std::nullopt;
+        }
+        auto chunk = data.subspan(8, length);
+        data = data.subspan(12 + length);
+
+        if (type == "IHDR") {
+            if (header) {
+                return std::nullopt;
+            }
+            header = read_header(chunk);
+            if (not header) {
+                return std::nullopt;
+            }
+        } else if (not header) {
+            return std::nullopt;
+        } else if (type == "PLTE") {
+            if (length % 3 != 0 or length == 0 or length / 3 > palette.entries.size()) {
+                return std::nullopt;
+            }
+            palette_size = length / 3;
+            for (usize entry = 0; entry < palette_size; entry++) {
+                std::memcpy(palette.entries[entry].data(), chunk.data() + entry * 3, 3);
+            }
+        } else if (type == "tRNS") {
+            // The alpha of palette entries, or a single transparent colour of images without alpha channel
+            if (header->color_type == ColorType::PALETTE) {
+                if (length > palette.entries.size()) {
+                    return std::nullopt;
+                }
+                for (usize entry = 0; entry < length; entry++) {
+                    palette.entries[entry][3] = chunk[entry];
+                }
+            } else if (header->color_type == ColorType::GRAY or header->color_type == ColorType::RGB) {
+                if (length != header->channels * 2) {
+                    return std::nullopt;
+                }
+                palette.key.emplace();
+                for (u32 channel = 0; channel < header->channels; channel++) {
+                    (*palette.key)[channel] = static_cast<u16>(chunk[channel * 2] << 8 | chunk[channel * 2 + 1]);
+                }
+            }
+        } else if (type == "IDAT") {
+            compressed.push_back(chunk);
+        } else if (type == "IEND") {
+            end = true;
+        } else if ((type[0] & 32) == 0) {
+            // Unknown chunks may only be skipped if they are ancillary, which a lowercase first letter marks
+            return std::nullopt;
+        }
+    }
+    if (not header or compressed.empty() or (header->color_type == ColorType::PALETTE and palette_size == 0)) {
+        return std::nullopt;
+    }
+
+    // The data chunks form a single zlib stream, which is only joined if it is split
+    std::vector<u8> joined{};
+    auto stream = compressed.front();
+    if (compressed.size() > 1) {
+        for (auto chunk : compressed) {
+            joined.insert(joined.end(), chunk.begin(), chunk.end());
+        }
+        stream = joined;
+    }
+
+    auto bits = usize{ header->channels } * header->depth;
+    auto stride = (usize{ header->width } * bits + 7) / 8;
+    // A short stream can not fill a large image, which is rejected before its memory is allocated
+    auto raw_size = (stride + 1) * header->height;
+    if (raw_size > stream.size() * MAX_EXPANSION) {
+        return std::nullopt;
+    }
+    std::vector<u8> raw(raw_size);
+    auto size = ZlibDecoder::decode(stream, raw);
+    if (not size or *size != raw.size() or not unfilter(raw, stride, header->height, std::max<usize>(bits / 8, 1))) {
+        return std::nullopt;
+    }
+
+    auto image = Image{ header->width, header->height, std::vector<u8>(usize{ header->width } * header->height * 4) };
+    for (usize y = 0; y < header->height; y++) {
+        expand(*header, palette, raw.data() + y * (stride + 1) + 1, image.pixels.data() + y * header->width * 4);
+    }
+    return image;
+}
+
+}// namespace
+
+/// Decodes an encoded image, whose format is determined by its signature
+std::optional<Image> Image::decode(std::span<const u8> data) {
+    if (data.size() >= PNG_SIGNATURE.size() and std::equal(PNG_SIGNATURE.begin(), PNG_SIGNATURE.end(), data.begin())) {
+        return decode_png(data.subspan(PNG_SIGNATURE.size()));
+    }
+    return std::nullopt;
+}
+
+}// namespace rt
@@ -0,0 +1,51 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Elias Engelbert Plank
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef REALTIME_IMAGE_H
+#define REALTIME_IMAGE_H
+
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "utility.h"
+
+namespace rt {
+
+/// A decoded image with four 8-bit channels per pixel and tightly packed rows, as they are copied into a
+/// R8G8B8A8 texture
+struct Image {
+    u32 width;
+    u32 height;
+    std::vector<u8> pixels;
+
+    /// Decodes an encoded image, whose format is determined by its signature. Only non-interlaced PNG images
+    /// are supported, with every colour type and bit depth. Channels with 16 bits are truncated to 8 bits.
+    /// @param data The encoded image
+    /// @return The image or std::nullopt if the data is malformed or in an unsupported format
+    static std::optional<Image> decode(std::span<const u8> data);
+};
+
+}// namespace rt
+
+#endif// REALTIME_IMAGE_H
@@ -21,11 +21,23 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
 #include <charconv>
-#include <unordered_set>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
 
+#include "cpu.h"
 #include "json.h"
 
+#if REALTIME_X86
+#include <immintrin.h>
+#endif
+
 namespace rt {
 
 /// Parses a JSON object from a string
@@ -54,29 +66,162 @@ Json::Value &Json::get(std::string_view key) {
     return get(k);
 }
 
+/// Looks up the value of the given key without inserting it
+const Json::Value *Json::find(const Key &key) const {
+    // Walks the bucket of the key directly, since small maps are otherwise scanned linearly by comparing
+    // every key, which is slower than hashing once for string keys
+    if (fields.empty()) {
+        return nullptr;
+    }
+    auto bucket = fields.bucket(key);
+    for (auto it = fields.cbegin(bucket); it != fields.cend(bucket); ++it) {
+        if (it->first == key) {
+            return &it->second;
+        }
+    }
+    return nullptr;
+}
+
+/// Inserts or replaces the value of the given key without copying either of them
+void Json::set(Key &&key, Value &&value) {
+    fields.insert_or_assign(std::move(key), std::move(value));
+}
+
+/// Retrieves the const begin iterator of the object
+Json::ConstIterator Json::cbegin() const {
+    return fields.cbegin();
+}
+
+/// Retrieves the const end iterator of the object
+Json::ConstIterator Json::cend() const {
+    return fields.cend();
+}
+
+/// Retrieves the number of members of the object
+usize Json::size() const {
+    return fields.size();
+}
+
+static_assert(sizeof(Json::Value) == sizeof(u64), "[json] Values must be boxed into eight bytes!");
+
+/// Creates a JSON nil value
+Json::Value::Value() : bits{ box(Tag::NIL, u64{ 0 }) } { }
+
+/// Copies a value, duplicating its out-of-line storage
+Json::Value::Value(const Value &other) : bits{ duplicate(other) } { }
+
+/// Copies a value, duplicating its out-of-line storage
+Json::Value &Json::Value::operator=(const Value &other) {
+    if (this != &other) {
+        auto copy = duplicate(other);
+        release();
+        bits = copy;
+    }
+    return *this;
+}
+
+/// Moves a value, leaving nil behind
+Json::Value::Value(Value &&other) noexcept : bits{ std::exchange(other.bits, box(Tag::NIL, u64{ 0 })) } { }
+
+/// Moves a value, leaving nil behind
+Json::Value &Json::Value::operator=(Value &&other) noexcept {
+    if (this != &other) {
+        release();
+        bits = std::exchange(other.bits, box(Tag::NIL, u64{ 0 }));
+    }
+    return *this;
+}
+
+/// Releases the out-of-line storage of the value
+Json::Value::~Value() {
+    release();
+}
+
 /// Creates a JSON string value
-Json::Value::Value(const String &string) : value{ string } { }
+Json::Value::Value(const String &string) : bits{ box(Tag::STRING, new String{ string }) } { }
 
-/// Creates a JSON number value
-Json::Value::Value(Number number) : value{ number } { }
+/// Creates a JSON string value by taking over the string
+Json::Value::Value(String &&string) : bits{ box(Tag::STRING, new String{ std::move(string) }) } { }
+
+/// Creates a JSON number value, every NaN is stored as the canonical quiet NaN
+Json::Value::Value(Number number) : bits{ std::isnan(number) ? CANONICAL_NAN : std::bit_cast<u64>(number) } { }
 
 /// Creates a JSON bool value
-Json::Value::Value(Bool boolean) : value{ boolean } { }
+Json::Value::Value(Bool boolean) : bits{ box(Tag::BOOL, u64{ boolean }) } { }
 
 /// Creates a JSON nil value
-Json::Value::Value(Null nil) : value{ nil } { }
+Json::Value::Value(Null) : bits{ box(Tag::NIL, u64{ 0 }) } { }
 
 /// Creates a JSON object value
-Json::Value::Value(const Json &json) : value{ json } { }
+Json::Value::Value(const Json &json) : bits{ box(Tag::OBJECT, new Json{ json }) } { }
+
+/// Creates a JSON object value by taking over the members of the object
+Json::Value::Value(Json &&json) : bits{ box(Tag::OBJECT, new Json{ std::move(json) }) } { }
 
 /// Creates a JSON array value
-Json::Value::Value(const Array &array) : value{ array } { }
+Json::Value::Value(const Array &array) : bits{ box(Tag::ARRAY, new Array{ array }) } { }
+
+/// Creates a JSON array value by taking over the elements of the array
+Json::Value::Value(Array &&array) : bits{ box(Tag::ARRAY, new Array{ std::move(array) }) } { }
+
+/// Boxes a payload with the given tag
+u64 Json::Value::box(Tag tag, u64 payload) {
+    return ((BOX | static_cast<u64>(tag)) << TAG_SHIFT) | (payload & PAYLOAD_MASK);
+}
+
+/// Boxes a pointer to out-of-line storage with the given tag
+u64 Json::Value::box(Tag tag, const void *pointer) {
+    auto address = reinterpret_cast<std::uintptr_t>(pointer);
+    assert((address & ~PAYLOAD_MASK) == 0 and "[json] Pointer does not fit into the payload of a value!");
+    return box(tag, static_cast<u64>(address));
+}
+
+/// Retrieves the pointer to the out-of-line storage of a string, object or array
+void *Json::Value::pointer() const {
+    return reinterpret_cast<void *>(static_cast<std::uintptr_t>(bits & PAYLOAD_MASK));
+}
+
+/// Duplicates the out-of-line storage of the given value
+u64 Json::Value::duplicate(const Value &other) {
+    switch (other.tag()) {
+        case Tag::STRING:
+            return box(Tag::STRING, new String{ *static_cast<const String *>(other.pointer()) });
+        case Tag::OBJECT:
+            return box(Tag::OBJECT, new Json{ *static_cast<const Json *>(other.pointer()) });
+        case Tag::ARRAY:
+            return box(Tag::ARRAY, new Array{ *static_cast<const Array *>(other.pointer()) });
+        default:
+            return other.bits;
+    }
+}
+
+/// Releases the out-of-line storage of the value
+void Json::Value::release() {
+    switch (tag()) {
+        case Tag::STRING:
+            delete static_cast<String *>(pointer());
+            break;
+        case Tag::OBJECT:
+            delete static_cast<Json *>(pointer());
+            break;
+        case Tag::ARRAY:
+            delete static_cast<Array *>(pointer());
+            break;
+        default:
+            break;
+    }
+}
 
 /// Retrieves the value at the specified index
 Json::Value &Json::Array::operator[](usize index) {
     return fields[index];
 }
 
+/// Reserves storage for the given number of elements
+void Json::Array::reserve(usize capacity) {
+    fields.reserve(capacity);
+}
+
 /// Adds a value to the array
 void Json::Array::add(Value &&value) {
     fields.emplace_back(std::move(value));
@@ -127,6 +272,11 @@ Json::Array::ConstReverseIterator Json::Array::crend() const {
     return fields.crend();
 }
 
+/// Retrieves the number of elements of the array
+usize Json::Array::size() const {
+    return fields.size();
+}
+
 namespace detail {
 
 namespace {
@@ -135,10 +285,26 @@ namespace {
 /// @param c The provided character
 /// @return A value that indicates whether the provided character is a trivial control character
 bool trivial_control_character(char c) {
-    static const std::unordered_set known = {
-        '"', '\\', '/', 'b', 'f', 'n', 'r', 't',
-    };
-    return known.contains(c);
+    switch (c) {
+        case '"':
+        case '\\':
+        case '/':
+        case 'b':
+        case 'f':
+        case 'n':
+        case 'r':
+        case 't':
+            return true;
+        default:
+            return false;
+    }
+}
+
+/// Checks whether the provided character is a decimal digit
+/// @param c The provided character
+/// @return A value that indicates whether the provided character is a decimal digit
+bool is_digit(char c) {
+    return c >= '0' and c <= '9';
 }
 
 /// Checks whether the given text consists only of hex digits
@@ -154,7 +320,19 @@ bool is_hex(std::string_view text) {
 /// @return An optional stringified string
 std::optional<Json::String> stringify(std::string_view view) {
     Json::String result;
+    result.reserve(view.size());
     while (!view.empty()) {
+        // Widen runs of plain ASCII characters in bulk
+        auto literal = std::ranges::find_if(view, [](char c) { return c == '\\' or (c & 0x80); });
+        if (literal != view.begin()) {
+            auto count = static_cast<usize>(literal - view.begin());
+            auto offset = result.size();
+            result.resize(offset + count);
+            std::copy(view.begin(), literal, result.begin() + static_cast<std::ptrdiff_t>(offset));
+            view.remove_prefix(count);
+            continue;
+        }
+
         if (view.front() == '\\') {
             view.remove_prefix(1);
             switch (view.front()) {
@@ -166,6 +344,10 @@ std::optional<Json::String> stringify(std::string_view view) {
                     result += '\\';
                     view.remove_prefix(1);
                     break;
+                case '/':
+                    result += '/';
+                    view.remove_prefix(1);
+                    break;
                 case 'b':
                     result += '\b';
                     view.remove_prefix(1);
@@ -188,236 +370,589 @@ std::optional<Json::String> stringify(std::string_view view) {
                     break;
                 case 'u': {
                     view.remove_prefix(1);
-                    if (auto number = codepoint_from_view(view.substr(0, 4))) {
-                        result += static_cast<Json::String::value_type>(*number);
-                        view.remove_prefix(4);
-                    } else {
+                    auto number = codepoint_from_view(view.substr(0, 4));
+                    if (not number) {
                         return std::nullopt;
                     }
+                    view.remove_prefix(4);
+
+                    // Combine UTF-16 surrogate pairs into a single codepoint
+                    if (*number >= 0xD800 and *number < 0xDC00 and view.starts_with("\\u")) {
+                        auto low = codepoint_from_view(view.substr(2, 4));
+                        if (low and *low >= 0xDC00 and *low < 0xE000) {
+                            number = 0x10000 + ((*number - 0xD800) << 10) + (*low - 0xDC00);
+                            view.remove_prefix(6);
+                        }
+                    }
+                    result += static_cast<Json::String::value_type>(*number);
                     break;
                 }
                 default:
                     return std::nullopt;
             }
+        } else if (auto codepoint = utf8_decode(view)) {
+            result += static_cast<Json::String::value_type>(*codepoint);
         } else {
-            result += view.front();
+            // Not valid UTF-8, keep the raw byte
+            result += static_cast<Json::String::value_type>(static_cast<u8>(view.front()));
             view.remove_prefix(1);
         }
     }
     return result;
 }
 
+/// The character classes of a block of input, one bit per byte
+struct BlockMasks {
+    u64 quote;
+    u64 backslash;
+    u64 op;
+    u64 whitespace;
+};
+
+constexpr usize BLOCK_SIZE = 64;
+static_assert(JsonIndexer::WINDOW_SIZE % BLOCK_SIZE == 0, "[json] Windows must consist of whole blocks!");
+
+enum CharacterClass : u8 {
+    CLASS_QUOTE = 1 << 0,
+    CLASS_BACKSLASH = 1 << 1,
+    CLASS_OP = 1 << 2,
+    CLASS_WHITESPACE = 1 << 3
+};
+
+constexpr auto CHARACTER_CLASSES = [] {
+    std::array<u8, 256> table{};
+    table['"'] = CLASS_QUOTE;
+    table['\\'] = CLASS_BACKSLASH;
+    for (auto c : { '{', '}', '[', ']', ':', ',' }) {
+        table[static_cast<u8>(c)] = CLASS_OP;
+    }
+    for (auto c : { ' ', '\t', '\n', '\r' }) {
+        table[static_cast<u8>(c)] = CLASS_WHITESPACE;
+    }
+    return table;
+}();
+
+/// Classifies a block of input one byte at a time
+/// @param block The block, must hold BLOCK_SIZE bytes
+/// @return The character classes of the block
+BlockMasks classify_scalar(const char *block) {
+    BlockMasks masks{};
+    for (usize index = 0; index < BLOCK_SIZE; index++) {
+        u64 klass = CHARACTER_CLASSES[static_cast<u8>(block[index])];
+        masks.quote |= (klass & 1) << index;
+        masks.backslash |= ((klass >> 1) & 1) << index;
+        masks.op |= ((klass >> 2) & 1) << index;
+        masks.whitespace |= ((klass >> 3) & 1) << index;
+    }
+    return masks;
+}
+
+#if REALTIME_X86
+
+/// Classifies a block of input 16 bytes at a time
+/// @param block The block, must hold BLOCK_SIZE bytes
+/// @return The character classes of the block
+REALTIME_TARGET("sse2") BlockMasks classify_sse2(const char *block) {
+    BlockMasks masks{};
+    for (usize offset = 0; offset < BLOCK_SIZE; offset += 16) {
+        auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + offset));
+        auto quote = _mm_cmpeq_epi8(chunk, _mm_set1_epi8('"'));
+        auto backslash = _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\\'));
+
+        // '[' and ']' differ from '{' and '}' only in bit 5
+        auto folded = _mm_or_si128(chunk, _mm_set1_epi8(0x20));
+        auto brace = _mm_or_si128(_mm_cmpeq_epi8(folded, _mm_set1_epi8('{')),
+                                  _mm_cmpeq_epi8(folded, _mm_set1_epi8('}')));
+        auto op = _mm_or_si128(brace, _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(':')),
+                                                   _mm_cmpeq_epi8(chunk, _mm_set1_epi8(','))));
+        auto whitespace = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(' ')),
+                                                    _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\t'))),
+                                       _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\n')),
+                                                    _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\r'))));
+
+        masks.quote |= u64{ static_cast<u16>(_mm_movemask_epi8(quote)) } << offset;
+        masks.backslash |= u64{ static_cast<u16>(_mm_movemask_epi8(backslash)) } << offset;
+        masks.op |= u64{ static_cast<u16>(_mm_movemask_epi8(op)) } << offset;
+        masks.whitespace |= u64{ static_cast<u16>(_mm_movemask_epi8(whitespace)) } << offset;
+    }
+    return masks;
+}
+
+/// Classifies a block of input 32 bytes at a time
+/// @param block The block, must hold BLOCK_SIZE bytes
+/// @return The character classes of the block
+REALTIME_TARGET("avx2") BlockMasks classify_avx2(const char *block) {
+    BlockMasks masks{};
+    for (usize offset = 0; offset < BLOCK_SIZE; offset += 32) {
+        auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block + offset));
+        auto quote = _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('"'));
+        auto backslash = _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\\'));
+
+        // '[' and ']' differ from '{' and '}' only in bit 5
+        auto folded = _mm256_or_si256(chunk, _mm256_set1_epi8(0x20));
+        auto brace = _mm256_or_si256(_mm256_cmpeq_epi8(folded, _mm256_set1_epi8('{')),
+                                     _mm256_cmpeq_epi8(folded, _mm256_set1_epi8('}')));
+        auto op = _mm256_or_si256(brace, _mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(':')),
+                                                         _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(','))));
+        auto whitespace = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(' ')),
+                                                          _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\t'))),
+                                          _mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\n')),
+                                                          _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\r'))));
+
+        masks.quote |= u64{ static_cast<u32>(_mm256_movemask_epi8(quote)) } << offset;
+        masks.backslash |= u64{ static_cast<u32>(_mm256_movemask_epi8(backslash)) } << offset;
+        masks.op |= u64{ static_cast<u32>(_mm256_movemask_epi8(op)) } << offset;
+        masks.whitespace |= u64{ static_cast<u32>(_mm256_movemask_epi8(whitespace)) } << offset;
+    }
+    return masks;
+}
+
+#endif
+
+/// Computes the inclusive prefix xor of the bits, which turns quote positions into string regions
+/// @param bits The bits
+/// @return The prefix xor
+constexpr u64 prefix_xor(u64 bits) {
+    bits ^= bits << 1;
+    bits ^= bits << 2;
+    bits ^= bits << 4;
+    bits ^= bits << 8;
+    bits ^= bits << 16;
+    bits ^= bits << 32;
+    return bits;
+}
+
 constexpr auto TOKEN_INVALID = JsonLexer::Token{ JsonLexer::TokenType::INVALID, "" };
+constexpr auto TOKEN_END = JsonLexer::Token{ JsonLexer::TokenType::END, "" };
 
 }// namespace
 
-/// Creates a new lexer
-JsonLexer::JsonLexer(std::string_view data) : data{ data }, error{ false } { }
+/// Decodes the escape sequences of a JSON string lexeme into UTF-8
+std::optional<usize> unescape(std::string_view view, char *out) {
+    auto *begin = out;
+    while (not view.empty()) {
+        auto escape = view.find('\\');
+        auto literal = view.substr(0, escape);
+        std::memcpy(out, literal.data(), literal.size());
+        out += literal.size();
+        if (escape == std::string_view::npos) {
+            break;
+        }
 
-/// Tokenizes the data
-std::vector<JsonLexer::Token> JsonLexer::tokenize() {
-    std::vector<Token> result{};
+        view.remove_prefix(escape + 1);
+        if (view.empty()) {
+            return std::nullopt;
+        }
+        switch (view.front()) {
+            case '"':
+            case '\\':
+            case '/':
+                *out++ = view.front();
+                break;
+            case 'b':
+                *out++ = '\b';
+                break;
+            case 'f':
+                *out++ = '\f';
+                break;
+            case 'n':
+                *out++ = '\n';
+                break;
+            case 'r':
+                *out++ = '\r';
+                break;
+            case 't':
+                *out++ = '\t';
+                break;
+            case 'u': {
+                auto codepoint = codepoint_from_view(view.substr(1, 4));
+                if (not codepoint or view.size() < 5) {
+                    return std::nullopt;
+                }
+                view.remove_prefix(4);
 
-    while (not end() and not error) {
-        switch (current()) {
-            case '{':
-                result.emplace_back(TokenType::LEFT_BRACE, current_text());
-                advance();
-                continue;
-            case '}':
-                result.emplace_back(TokenType::RIGHT_BRACE, current_text());
-                advance();
-                continue;
-            case '[':
-                result.emplace_back(TokenType::LEFT_BRACKET, current_text());
-                advance();
-                continue;
-            case ']':
-                result.emplace_back(TokenType::RIGHT_BRACKET, current_text());
-                advance();
-                continue;
-            case ':':
-                result.emplace_back(TokenType::COLON, current_text());
-                advance();
-                continue;
-            case ',':
-                result.emplace_back(TokenType::COMMA, current_text());
-                advance();
-                continue;
-            default:
+                // Combine UTF-16 surrogate pairs into a single codepoint
+                if (*codepoint >= 0xD800 and *codepoint < 0xDC00 and view.substr(1, 2) == "\\u") {
+                    if (auto low = codepoint_from_view(view.substr(3, 4)); low and *low >= 0xDC00 and *low < 0xE000) {
+                        codepoint = 0x10000 + ((*codepoint - 0xD800) << 10) + (*low - 0xDC00);
+                        view.remove_prefix(6);
+                    }
+                }
+                out += utf8_encode(*codepoint, out);
                 break;
+            }
+            default:
+                return std::nullopt;
         }
+        view.remove_prefix(1);
+    }
+    return static_cast<usize>(out - begin);
+}
 
-        if (std::isspace(current())) {
-            advance();
-        } else if (auto tr = consume("true")) {
-            result.emplace_back(TokenType::TRUE, *tr);
-        } else if (auto fal = consume("false")) {
-            result.emplace_back(TokenType::FALSE, *fal);
-        } else if (auto nil = consume("null")) {
-            result.emplace_back(TokenType::NIL, *nil);
-        } else if (auto num = number()) {
-            result.emplace_back(TokenType::NUMBER, *num);
-        } else if (auto str = string()) {
-            result.emplace_back(TokenType::STRING, *str);
-        } else {
-            error = true;
+/// Measures the JSON number at the front of the text
+usize number_length(std::string_view text) {
+    auto digit = [text](usize at) { return at < text.size() and is_digit(text[at]); };
+    auto digits = [&digit](usize at) {
+        while (digit(at)) {
+            at++;
         }
+        return at;
+    };
+
+    usize length = not text.empty() and text.front() == '-' ? 1 : 0;
+    if (not digit(length)) {
+        return 0;
     }
+    length = digits(length);
 
-    if (not error) {
-        result.emplace_back(TokenType::END, "");
-        return result;
+    if (length < text.size() and text[length] == '.') {
+        if (not digit(length + 1)) {
+            return 0;
+        }
+        length = digits(length + 1);
     }
-    return {};
+    if (length < text.size() and (text[length] == 'e' or text[length] == 'E')) {
+        length++;
+        if (length < text.size() and (text[length] == '+' or text[length] == '-')) {
+            length++;
+        }
+        if (not digit(length)) {
+            return 0;
+        }
+        length = digits(length);
+    }
+    return length;
 }
 
-/// Tokenizes stringified JSON data
-std::vector<JsonLexer::Token> JsonLexer::tokenize(std::string_view data) {
-    auto lex = JsonLexer{ data };
-    return lex.tokenize();
+/// Retrieves the fastest backend that is supported by the host CPU
+JsonIndexer::Backend JsonIndexer::best() {
+    if (supported(Backend::AVX2)) {
+        return Backend::AVX2;
+    }
+    if (supported(Backend::SSE2)) {
+        return Backend::SSE2;
+    }
+    return Backend::SCALAR;
 }
 
-/// Tries to parse a number from the current data string
-std::optional<std::string_view> JsonLexer::number() {
-    auto c = current();
-    auto sign = c == '-';
-    if (not std::isdigit(c) and not sign) {
+/// Checks whether the given backend is supported by the host CPU
+bool JsonIndexer::supported(Backend backend) {
+    switch (backend) {
+        case Backend::SSE2:
+            return REALTIME_X86 and cpu_features().sse2;
+        case Backend::AVX2:
+            return REALTIME_X86 and cpu_features().avx2;
+        default:
+            return true;
+    }
+}
+
+/// Indexes the data, unsupported backends fall back to the fastest supported one
+std::optional<std::vector<u32>> JsonIndexer::index(std::string_view data, Backend backend) {
+    if (data.size() > MAX_SIZE) {
         return std::nullopt;
     }
+    std::vector<u32> positions{};
+    positions.reserve(data.size() / 4);
 
-    auto *begin = current_ptr();
-    if (sign) {
-        advance();
+    auto indexer = JsonIndexer{ data, backend };
+    while (not indexer.done()) {
+        indexer.next(positions);
+    }
+    if (indexer.in_string()) {
+        return std::nullopt;
     }
+    return positions;
+}
 
-    while (std::isdigit(current())) {
-        advance();
+/// Creates a new indexer, unsupported backends fall back to the fastest supported one
+JsonIndexer::JsonIndexer(std::string_view data, Backend backend)
+    : data{ data },
+      backend{ supported(backend) ? backend : best() },
+      offset{ 0 },
+      previous_escaped{ 0 },
+      previous_in_string{ 0 },
+      previous_scalar{ 0 } { }
+
+/// Appends the structural positions of the next window of the data
+void JsonIndexer::next(std::vector<u32> &positions) {
+    assert(data.size() <= MAX_SIZE and "[json] Data is too large to be indexed!");
+    auto end = std::min(offset + WINDOW_SIZE, data.size());
+    for (; offset + BLOCK_SIZE <= end; offset += BLOCK_SIZE) {
+        scan(data.data() + offset, positions);
+    }
+    if (offset < end) {
+        // Pad the last block with whitespace
+        std::array<char, BLOCK_SIZE> tail{};
+        tail.fill(' ');
+        std::memcpy(tail.data(), data.data() + offset, end - offset);
+        scan(tail.data(), positions);
+        offset = end;
     }
+}
 
-    if (current() == '.') {
-        if (not std::isdigit(next())) {
-            error = true;
-            return std::nullopt;
-        }
-        advance(2);
-        while (std::isdigit(current())) {
-            advance();
-        }
+/// Checks whether the whole data has been indexed
+bool JsonIndexer::done() const {
+    return offset == data.size();
+}
+
+/// Checks whether the data indexed so far ends inside of a string
+bool JsonIndexer::in_string() const {
+    return previous_in_string != 0;
+}
+
+/// Appends the structural positions of the block at the current offset
+void JsonIndexer::scan(const char *block, std::vector<u32> &positions) {
+    BlockMasks masks;
+    switch (backend) {
+#if REALTIME_X86
+        case Backend::SSE2:
+            masks = classify_sse2(block);
+            break;
+        case Backend::AVX2:
+            masks = classify_avx2(block);
+            break;
+#endif
+        default:
+            masks = classify_scalar(block);
+            break;
     }
-    if (auto exp = current(); exp == 'e' or exp == 'E') {
-        advance();
-        if (auto sgn = current(); sgn == '+' or sgn == '-' or std::isdigit(sgn)) {
-            advance();
-            while (std::isdigit(current())) {
-                advance();
-            }
-        } else {
-            // malformed
-            error = true;
-            return std::nullopt;
+
+    // Escape sequences are rare, so resolve them one backslash at a time
+    auto escaped = previous_escaped;
+    auto backslash = masks.backslash & ~previous_escaped;
+    previous_escaped = 0;
+    while (backslash) {
+        auto bit = std::countr_zero(backslash);
+        if (bit == 63) {
+            previous_escaped = 1;
+            break;
         }
+        escaped |= u64{ 1 } << (bit + 1);
+        backslash &= ~(u64{ 3 } << bit);
+    }
+
+    // The opening quote is part of the string region, the closing quote is not
+    auto quote = masks.quote & ~escaped;
+    auto in_string = prefix_xor(quote) ^ previous_in_string;
+    previous_in_string = 0 - (in_string >> 63);
+
+    // Numbers and literals start wherever a run of other characters starts
+    auto scalar = ~(masks.op | masks.whitespace | quote);
+    auto scalar_start = scalar & ~((scalar << 1) | previous_scalar);
+    previous_scalar = scalar >> 63;
+
+    auto structural = ((masks.op | scalar_start) & ~in_string) | quote;
+    auto count = positions.size();
+    positions.resize(count + static_cast<usize>(std::popcount(structural)));
+    for (; structural; structural &= structural - 1) {
+        positions[count++] = static_cast<u32>(offset + static_cast<usize>(std::countr_zero(structural)));
     }
-    return std::string_view{ begin, current_ptr() };
 }
 
-/// Tries to parse a string from the current data string
-std::optional<std::string_view> JsonLexer::string() {
-    if (current() != '"') {
-        return std::nullopt;
+/// Creates a new lexer that indexes the data with the fastest backend of the host CPU
+JsonLexer::JsonLexer(std::string_view data) : JsonLexer{ data, JsonIndexer::best() } { }
+
+/// Creates a new lexer
+JsonLexer::JsonLexer(std::string_view data, JsonIndexer::Backend backend)
+    : data{ data },
+      indexer{ data, backend },
+      index{},
+      cursor{ 0 },
+      error{ data.size() > JsonIndexer::MAX_SIZE } {
+    index.reserve(std::min(data.size(), JsonIndexer::WINDOW_SIZE) / 4);
+}
+
+/// Lexes the next token on demand by jumping to the next structural position
+JsonLexer::Token JsonLexer::lex() {
+    if (not fill()) {
+        return error ? TOKEN_INVALID : TOKEN_END;
     }
-    advance();
-    auto *begin = current_ptr();
-    while (current() != '"') {
-        if (current() == '\\') {
-            advance();
-            if (auto c = current(); trivial_control_character(c)) {
-                advance();
-            } else if (c == 'u') {
-                advance();
-                if (not is_hex(current_text(4))) {
-                    error = true;
-                    return std::nullopt;
-                }
-                advance(4);
-            } else {
-                error = true;
-                return std::nullopt;
+
+    auto position = index[cursor++];
+    auto single = [this, position](TokenType type) { return Token{ type, data.substr(position, 1) }; };
+
+    std::optional<std::string_view> lexeme;
+    switch (data[position]) {
+        case '{':
+            return single(TokenType::LEFT_BRACE);
+        case '}':
+            return single(TokenType::RIGHT_BRACE);
+        case '[':
+            return single(TokenType::LEFT_BRACKET);
+        case ']':
+            return single(TokenType::RIGHT_BRACKET);
+        case ':':
+            return single(TokenType::COLON);
+        case ',':
+            return single(TokenType::COMMA);
+        case '"':
+            if ((lexeme = string(position))) {
+                return { TokenType::STRING, *lexeme };
             }
-        } else {
-            advance();
-        }
+            break;
+        case 't':
+            if ((lexeme = literal(position, "true"))) {
+                return { TokenType::TRUE, *lexeme };
+            }
+            break;
+        case 'f':
+            if ((lexeme = literal(position, "false"))) {
+                return { TokenType::FALSE, *lexeme };
+            }
+            break;
+        case 'n':
+            if ((lexeme = literal(position, "null"))) {
+                return { TokenType::NIL, *lexeme };
+            }
+            break;
+        default:
+            if ((lexeme = number(position))) {
+                return { TokenType::NUMBER, *lexeme };
+            }
+            break;
     }
-    auto *end = current_ptr();
-    advance();
-    return std::string_view{ begin, end };
+
+    error = true;
+    return TOKEN_INVALID;
 }
 
-/// Advances the cursor by 'count' places
-void JsonLexer::advance(u64 count) {
-    data.remove_prefix(count);
+/// Skips the remainder of the object or array whose opening token was lexed last
+bool JsonLexer::skip() {
+    for (usize depth = 1; fill();) {
+        switch (data[index[cursor++]]) {
+            case '{':
+            case '[':
+                depth++;
+                break;
+            case '}':
+            case ']':
+                if (--depth == 0) {
+                    return true;
+                }
+                break;
+            case '"':
+                // Every string occupies two positions, skip the closing quote as well
+                if (fill()) {
+                    cursor++;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+    error = true;
+    return false;
 }
 
-/// Tries to consume a text, returns the lexeme if successful
-std::optional<std::string_view> JsonLexer::consume(std::string_view text) {
-    auto len = text.length();
-    if (data.length() < len) {
+/// Tokenizes the data
+std::vector<JsonLexer::Token> JsonLexer::tokenize() {
+    if (error) {
         return {};
     }
-    if (auto sub = data.substr(0, len); sub == text) {
-        advance(len);
-        return sub;
+    std::vector<Token> result{};
+    result.reserve(data.size() / 4);
+    for (auto token = lex();; token = lex()) {
+        if (token.type == TokenType::INVALID) {
+            return {};
+        }
+        result.push_back(token);
+        if (token.type == TokenType::END) {
+            return result;
+        }
     }
-    return {};
 }
 
-/// Retrieves the current char or '\0' if the cursor reached the end
-char JsonLexer::current() const {
-    return not end() ? data.front() : '\0';
+/// Tokenizes stringified JSON data
+std::vector<JsonLexer::Token> JsonLexer::tokenize(std::string_view data) {
+    auto lex = JsonLexer{ data };
+    return lex.tokenize();
 }
 
-/// Retrieves the next char or '\0' if the cursor reached the end
-char JsonLexer::next() const {
-    return data.size() > 1 ? data[1] : '\0';
+/// Makes sure that the structural position at the cursor is indexed
+bool JsonLexer::fill() {
+    while (not error and cursor == index.size()) {
+        if (indexer.done()) {
+            // A string that is still open at the end of the data is never terminated
+            error = indexer.in_string();
+            return false;
+        }
+        index.clear();
+        cursor = 0;
+        indexer.next(index);
+    }
+    return not error;
 }
 
-/// Retrieves the data pointer or null if the cursor reached the end
-const char *JsonLexer::current_ptr() const {
-    return not end() ? data.data() : nullptr;
+/// Tries to lex a number that starts at the given position
+std::optional<std::string_view> JsonLexer::number(usize position) const {
+    auto text = data.substr(position);
+    auto length = number_length(text);
+    if (length == 0 or not delimited(position + length)) {
+        return std::nullopt;
+    }
+    return text.substr(0, length);
 }
 
-/// Retrieves the current text given a count of places
-std::string_view JsonLexer::current_text(u64 count) const {
-    return not end() ? data.substr(0, count) : std::string_view{};
+/// Tries to lex a string whose opening quote is at the given position, consumes the closing quote
+std::optional<std::string_view> JsonLexer::string(usize position) {
+    // The indexer guarantees that the closing quote is the next structural position
+    if (not fill()) {
+        return std::nullopt;
+    }
+    auto end = index[cursor++];
+    auto text = data.substr(position + 1, end - position - 1);
+
+    // Only strings with escape sequences have to be validated
+    for (auto escape = text.find('\\'); escape != std::string_view::npos; escape = text.find('\\', escape)) {
+        auto c = escape + 1 < text.size() ? text[escape + 1] : '\0';
+        if (trivial_control_character(c)) {
+            escape += 2;
+        } else if (c == 'u' and escape + 6 <= text.size() and is_hex(text.substr(escape + 2, 4))) {
+            escape += 6;
+        } else {
+            return std::nullopt;
+        }
+    }
+    return text;
+}
+
+/// Tries to lex a literal that starts at the given position
+std::optional<std::string_view> JsonLexer::literal(usize position, std::string_view text) const {
+    if (data.substr(position, text.size()) != text or not delimited(position + text.size())) {
+        return std::nullopt;
+    }
+    return data.substr(position, text.size());
 }
 
-/// Checks if the cursor reached the end
-bool JsonLexer::end() const {
-    return data.empty();
+/// Checks whether a number or literal that ends at the given position is properly delimited
+bool JsonLexer::delimited(usize position) const {
+    if (position >= data.size()) {
+        return true;
+    }
+    auto klass = CHARACTER_CLASSES[static_cast<u8>(data[position])];
+    return klass & (CLASS_OP | CLASS_WHITESPACE);
 }
 
-/// Creates a new parser
-JsonParser::JsonParser(const std::vector<JsonLexer::Token> &tokens) : tokens{ tokens } { }
+/// Creates a new parser that lexes the data on demand
+JsonParser::JsonParser(std::string_view data) : lexer{ data }, token{ lexer.lex() } { }
 
 /// Parses the JSON object
 std::optional<Json> JsonParser::parse() {
-    if (auto obj = object()) {
-        if (auto json = obj->as<Json>()) {
-            return *json;
-        }
+    if (auto json = members(1); json and match(JsonLexer::TokenType::END)) {
+        return json;
     }
     return std::nullopt;
 }
 
 /// Tries to parse stringified JSON data
 std::optional<Json> JsonParser::parse(std::string_view data) {
-    auto tokens = JsonLexer::tokenize(data);
-    auto parser = JsonParser{ tokens };
+    auto parser = JsonParser{ data };
     return parser.parse();
 }
 
-/// Tries to parse a JSON object
-std::optional<Json::Value> JsonParser::object() {
+/// Tries to parse the members of a JSON object
+std::optional<Json> JsonParser::members(usize depth) {
     if (not consume(JsonLexer::TokenType::LEFT_BRACE)) {
         return std::nullopt;
     }
@@ -430,12 +965,12 @@ std::optional<Json::Value> JsonParser::object() {
                 return std::nullopt;
             }
 
-            auto val = value();
+            auto val = value(depth);
             if (not key or not val) {
                 return std::nullopt;
             }
 
-            json[*key] = std::move(*val);
+            json.set(std::move(*key), std::move(*val));
 
             if (not match(JsonLexer::TokenType::RIGHT_BRACE) and not consume(JsonLexer::TokenType::COMMA)) {
                 return std::nullopt;
@@ -445,17 +980,25 @@ std::optional<Json::Value> JsonParser::object() {
         }
     }
 
-    return Json::Value{ json };
+    return json;
+}
+
+/// Tries to parse a JSON object
+std::optional<Json::Value> JsonParser::object(usize depth) {
+    if (auto json = members(depth)) {
+        return Json::Value{ std::move(*json) };
+    }
+    return std::nullopt;
 }
 
 /// Tries to parse a JSON value
-std::optional<Json::Value> JsonParser::value() {
+std::optional<Json::Value> JsonParser::value(usize depth) {
     auto token = current();
     switch (token.type) {
         case JsonLexer::TokenType::LEFT_BRACE:
-            return object();
+            return depth < JsonLexer::MAX_DEPTH ? object(depth + 1) : std::nullopt;
         case JsonLexer::TokenType::LEFT_BRACKET:
-            return array();
+            return depth < JsonLexer::MAX_DEPTH ? array(depth + 1) : std::nullopt;
         case JsonLexer::TokenType::STRING:
             return string();
         case JsonLexer::TokenType::TRUE:
@@ -471,33 +1014,42 @@ std::optional<Json::Value> JsonParser::value() {
     return std::nullopt;
 }
 
-/// Tries to parse a JSON array
-std::optional<Json::Value> JsonParser::array() {
+/// Tries to parse a JSON array, its elements are gathered on the element stack that is shared by all nesting
+/// levels, so that the array is allocated once with its final size
+std::optional<Json::Value> JsonParser::array(usize depth) {
     if (not consume(JsonLexer::TokenType::LEFT_BRACKET)) {
         return std::nullopt;
     }
 
-    Json::Array array;
+    auto base = elements.size();
     while (not consume(JsonLexer::TokenType::RIGHT_BRACKET)) {
-        auto val = value();
+        auto val = value(depth);
         if (not val) {
+            elements.resize(base);
             return std::nullopt;
         }
-        array.add(*val);
+        elements.emplace_back(std::move(*val));
 
         if (not match(JsonLexer::TokenType::RIGHT_BRACKET) and not consume(JsonLexer::TokenType::COMMA)) {
+            elements.resize(base);
             return std::nullopt;
         }
     }
 
-    return Json::Value{ array };
+    Json::Array array;
+    array.reserve(elements.size() - base);
+    for (auto it = elements.begin() + static_cast<std::ptrdiff_t>(base); it != elements.end(); ++it) {
+        array.add(std::move(*it));
+    }
+    elements.resize(base);
+    return Json::Value{ std::move(array) };
 }
 
 /// Tries to parse a JSON string value
 std::optional<Json::Value> JsonParser::string() {
     if (auto str = consume(JsonLexer::TokenType::STRING)) {
         if (auto parsed = stringify(str->lexeme)) {
-            return Json::Value{ *parsed };
+            return Json::Value{ std::move(*parsed) };
         }
     }
     return std::nullopt;
@@ -532,14 +1084,14 @@ std::optional<Json::Value> JsonParser::number() {
     return std::nullopt;
 }
 
-/// Advances the cursor by 1
+/// Advances the cursor by one token
 void JsonParser::advance() {
-    tokens = { tokens.begin() + 1, tokens.end() };
+    token = lexer.lex();
 }
 
 /// Tries to consume a token
-std::optional<JsonLexer::Token> JsonParser::consume(JsonLexer::TokenType token) {
-    if (match(token)) {
+std::optional<JsonLexer::Token> JsonParser::consume(JsonLexer::TokenType type) {
+    if (match(type)) {
         auto consumed = current();
         advance();
         return consumed;
@@ -552,22 +1104,9 @@ bool JsonParser::match(JsonLexer::TokenType type) const {
     return current().type == type;
 }
 
-/// Retrieves the current token or INVALID if the cursor reached the end
+/// Retrieves the current token, END if the data is exhausted or INVALID on malformed input
 JsonLexer::Token JsonParser::current() const {
-    return end() ? TOKEN_INVALID : tokens.front();
-}
-
-/// Retrieves the next token or INVALID if the cursor reached the end
-JsonLexer::Token JsonParser::next() const {
-    return tokens.size() > 1 ? tokens[1] : TOKEN_INVALID;
-}
-
-/// Checks if the cursor reached the end
-bool JsonParser::end() const {
-    if (tokens.empty() or tokens.front().type == JsonLexer::TokenType::END) {
-        return true;
-    }
-    return false;
+    return token;
 }
 
 }// namespace detail
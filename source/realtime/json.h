@@ -24,8 +24,10 @@
 #ifndef REALTIME_JSON_H
 #define REALTIME_JSON_H
 
+#include <bit>
+#include <limits>
 #include <unordered_map>
-#include <variant>
+#include <utility>
 #include <vector>
 
 #include "utility.h"
@@ -46,6 +48,9 @@ public:
     using Key = String;
     class Value;
 
+    using Internal = std::unordered_map<Key, Value>;
+    using ConstIterator = Internal::const_iterator;
+
     /// Creates an empty JSON object
     Json() = default;
 
@@ -55,7 +60,8 @@ public:
     Json(Json &&) = default;
     Json &operator=(Json &&) = default;
 
-    /// Parses a JSON object from a string
+    /// Parses a JSON object from a string. Objects and arrays may be nested at most
+    /// detail::JsonLexer::MAX_DEPTH levels deep.
     /// @param data The string
     /// @return An optional JSON object
     static std::optional<Json> parse(std::string_view data);
@@ -80,8 +86,30 @@ public:
     /// @return A reference to the value
     Value &get(std::string_view key);
 
+    /// Looks up the value of the given key without inserting it
+    /// @param key The key
+    /// @return A pointer to the value or nullptr if there is no such member
+    const Value *find(const Key &key) const;
+
+    /// Inserts or replaces the value of the given key without copying either of them
+    /// @param key The key
+    /// @param value The value
+    void set(Key &&key, Value &&value);
+
+    /// Retrieves the const begin iterator of the object
+    /// @return The const begin iterator
+    ConstIterator cbegin() const;
+
+    /// Retrieves the const end iterator of the object
+    /// @return The const end iterator
+    ConstIterator cend() const;
+
+    /// Retrieves the number of members of the object
+    /// @return The number of members
+    usize size() const;
+
 private:
-    std::unordered_map<Key, Value> fields;
+    Internal fields;
 };
 
 class Json::Array {
@@ -100,6 +128,10 @@ public:
     /// @return A reference to the value
     Value &operator[](usize index);
 
+    /// Reserves storage for the given number of elements
+    /// @param capacity The number of elements
+    void reserve(usize capacity);
+
     /// Adds a value to the array
     /// @param value The value
     void add(Value &&value);
@@ -140,26 +172,40 @@ public:
     /// @return The const reverse end iterator
     ConstReverseIterator crend() const;
 
+    /// Retrieves the number of elements of the array
+    /// @return The number of elements
+    usize size() const;
+
 private:
     Internal fields;
 };
 
+/// A JSON value in eight bytes. Numbers are stored inline as doubles, every other value is boxed into the
+/// payload of a quiet NaN whose high bits are reserved for tags: booleans and null carry their value inline,
+/// while strings, objects and arrays are owned through a pointer to their out-of-line storage.
 class Json::Value {
 public:
-    /// Creates an empty JSON value
-    Value() = default;
+    /// Creates a JSON nil value
+    Value();
 
-    /// A value may be copied or moved
-    Value(const Value &) = default;
-    Value &operator=(const Value &) = default;
-    Value(Value &&) = default;
-    Value &operator=(Value &&) = default;
+    /// A value may be copied or moved, a copy duplicates the out-of-line storage
+    Value(const Value &other);
+    Value &operator=(const Value &other);
+    Value(Value &&other) noexcept;
+    Value &operator=(Value &&other) noexcept;
+
+    /// Releases the out-of-line storage of the value
+    ~Value();
 
     /// Creates a JSON string value
     /// @param string The string
     explicit Value(const String &string);
 
-    /// Creates a JSON number value
+    /// Creates a JSON string value by taking over the string
+    /// @param string The string
+    explicit Value(String &&string);
+
+    /// Creates a JSON number value, every NaN is stored as the canonical quiet NaN
     /// @param number The number
     explicit Value(Number number);
 
@@ -175,26 +221,197 @@ public:
     /// @param json The object
     explicit Value(const Json &json);
 
+    /// Creates a JSON object value by taking over the members of the object
+    /// @param json The object
+    explicit Value(Json &&json);
+
     /// Creates a JSON array value
     /// @param array The array
     explicit Value(const Array &array);
 
-    /// Tries to retrieve the value with the given type
+    /// Creates a JSON array value by taking over the elements of the array
+    /// @param array The array
+    explicit Value(Array &&array);
+
+    /// Tries to retrieve the value with the given type. Numbers, bools and nil live inside of the value and
+    /// are returned as a copy, strings, objects and arrays are returned by reference.
     /// @tparam T The type
-    /// @return An optional reference to the value
+    /// @return An optional copy for Number, Bool and Null, an optional reference otherwise
     template<typename T>
-    T *as() {
+    auto as() {
+        if constexpr (meta::is_same_as_any_v<T, Number, Bool, Null>) {
+            return std::as_const(*this).as<T>();
+        } else {
+            return const_cast<T *>(std::as_const(*this).as<T>());
+        }
+    }
+
+    /// Tries to retrieve the value with the given type. Numbers, bools and nil live inside of the value and
+    /// are returned as a copy, strings, objects and arrays are returned by reference.
+    /// @tparam T The type
+    /// @return An optional copy for Number, Bool and Null, an optional reference otherwise
+    template<typename T>
+    auto as() const {
         static_assert(meta::is_same_as_any_v<T, String, Number, Bool, Null, Json, Array>,
                       "Invalid value type! Must be either String, Number, Bool, Null, Json or Array!");
-        return std::get_if<T>(&value);
+        if constexpr (std::is_same_v<T, Number>) {
+            return tag() == Tag::NUMBER ? std::optional<Number>{ std::bit_cast<Number>(bits) } : std::nullopt;
+        } else if constexpr (std::is_same_v<T, Bool>) {
+            return tag() == Tag::BOOL ? std::optional<Bool>{ (bits & PAYLOAD_MASK) != 0 } : std::nullopt;
+        } else if constexpr (std::is_same_v<T, Null>) {
+            return tag() == Tag::NIL ? std::optional<Null>{ nullptr } : std::nullopt;
+        } else {
+            return tag() == tag_of<T>() ? static_cast<const T *>(pointer()) : nullptr;
+        }
     }
 
 private:
-    std::variant<String, Number, Bool, Null, Json, Array> value;
+    /// The kind of value, everything but NUMBER is boxed
+    enum class Tag : u64 {
+        NUMBER,
+        STRING,
+        OBJECT,
+        ARRAY,
+        BOOL,
+        NIL
+    };
+
+    /// The high 16 bits of a negative quiet NaN, boxed values lie strictly above it with the tag in the low
+    /// three bits. Pointers of user space fit into the remaining 48 bits on x86-64 and AArch64.
+    static constexpr u64 BOX = 0xFFF8;
+    static constexpr u64 TAG_SHIFT = 48;
+    static constexpr u64 TAG_MASK = 0x7;
+    static constexpr u64 PAYLOAD_MASK = (u64{ 1 } << TAG_SHIFT) - 1;
+    static constexpr u64 CANONICAL_NAN = 0x7FF8'0000'0000'0000;
+
+    /// Retrieves the tag of the type that is stored out-of-line
+    /// @tparam T The type
+    /// @return The tag
+    template<typename T>
+    static constexpr Tag tag_of() {
+        if constexpr (std::is_same_v<T, String>) {
+            return Tag::STRING;
+        } else if constexpr (std::is_same_v<T, Json>) {
+            return Tag::OBJECT;
+        } else {
+            return Tag::ARRAY;
+        }
+    }
+
+    /// Boxes a payload with the given tag
+    /// @param tag The tag
+    /// @param payload The payload, must fit into 48 bits
+    /// @return The boxed bits
+    static u64 box(Tag tag, u64 payload);
+
+    /// Boxes a pointer to out-of-line storage with the given tag
+    /// @param tag The tag
+    /// @param pointer The pointer
+    /// @return The boxed bits
+    static u64 box(Tag tag, const void *pointer);
+
+    /// Retrieves the tag of the value
+    /// @return The tag
+    Tag tag() const {
+        auto high = bits >> TAG_SHIFT;
+        return high > BOX ? static_cast<Tag>(high & TAG_MASK) : Tag::NUMBER;
+    }
+
+    /// Retrieves the pointer to the out-of-line storage of a string, object or array
+    /// @return The pointer
+    void *pointer() const;
+
+    /// Duplicates the out-of-line storage of the given value
+    /// @param other The value
+    /// @return The bits of the duplicate
+    static u64 duplicate(const Value &other);
+
+    /// Releases the out-of-line storage of the value
+    void release();
+
+    u64 bits;
 };
 
 namespace detail {
 
+/// Decodes the escape sequences of a JSON string lexeme into UTF-8
+/// @param view The string lexeme without quotes
+/// @param out The output buffer, must be able to hold at least as many bytes as the lexeme
+/// @return The number of bytes written or std::nullopt if the lexeme is malformed
+std::optional<usize> unescape(std::string_view view, char *out);
+
+/// Measures the JSON number at the front of the text
+/// @param text The text
+/// @return The length of the number or zero if the text does not start with a valid number
+usize number_length(std::string_view text);
+
+/// The first stage of the JSON lexer. It locates all structural characters outside of strings, all
+/// unescaped quotes and the first character of every number and literal, classifying 64 bytes at a time.
+/// The data is indexed one window at a time, so the index never grows beyond the positions of a window.
+/// Positions are 32-bit, callers must reject data of more than MAX_SIZE bytes before indexing it.
+class JsonIndexer {
+public:
+    /// The implementations of the classification step
+    enum class Backend {
+        SCALAR,
+        SSE2,
+        AVX2
+    };
+
+    /// The number of bytes that are indexed at once, a multiple of the block size
+    static constexpr usize WINDOW_SIZE = 64 * 1024;
+
+    /// The size of the largest data whose positions can be indexed
+    static constexpr usize MAX_SIZE = std::numeric_limits<u32>::max();
+
+    /// Creates a new indexer, unsupported backends fall back to the fastest supported one
+    /// @param data The JSON data in string
+    /// @param backend The backend
+    explicit JsonIndexer(std::string_view data, Backend backend = best());
+
+    /// Appends the structural positions of the next window of the data
+    /// @param positions The list of positions
+    void next(std::vector<u32> &positions);
+
+    /// Checks whether the whole data has been indexed
+    /// @return A value that indicates whether the whole data has been indexed
+    bool done() const;
+
+    /// Checks whether the data indexed so far ends inside of a string
+    /// @return A value that indicates whether the data ends inside of a string
+    bool in_string() const;
+
+    /// Retrieves the fastest backend that is supported by the host CPU
+    /// @return The fastest backend
+    static Backend best();
+
+    /// Checks whether the given backend is supported by the host CPU
+    /// @param backend The backend
+    /// @return A value that indicates whether the backend is supported
+    static bool supported(Backend backend);
+
+    /// Indexes the data, unsupported backends fall back to the fastest supported one
+    /// @param data The JSON data in string
+    /// @param backend The backend
+    /// @return The ascending positions of all structural characters or std::nullopt if a string is
+    ///         not terminated or the data exceeds MAX_SIZE
+    static std::optional<std::vector<u32>> index(std::string_view data, Backend backend = best());
+
+private:
+    /// Appends the structural positions of the block at the current offset, carrying the string,
+    /// escape and scalar state over to the next block
+    /// @param block The block, must hold 64 bytes
+    /// @param positions The list of positions
+    void scan(const char *block, std::vector<u32> &positions);
+
+    std::string_view data;
+    Backend backend;
+    usize offset;
+    u64 previous_escaped;
+    u64 previous_in_string;
+    u64 previous_scalar;
+};
+
 class JsonLexer {
 public:
     /// List of valid tokens for parsing JSON
@@ -220,10 +437,29 @@ public:
         std::string_view lexeme;
     };
 
-    /// Creates a new lexer
+    /// The deepest nesting of objects and arrays that the parsers accept. Deeper data is rejected as
+    /// malformed, as the parsers recurse once per level and would otherwise overflow the stack.
+    static constexpr usize MAX_DEPTH = 1024;
+
+    /// Creates a new lexer that indexes the data with the fastest backend of the host CPU
     /// @param data The JSON data in string
     explicit JsonLexer(std::string_view data);
 
+    /// Creates a new lexer
+    /// @param data The JSON data in string
+    /// @param backend The backend that indexes the data
+    JsonLexer(std::string_view data, JsonIndexer::Backend backend);
+
+    /// Lexes the next token on demand by jumping to the next structural position
+    /// @return The next token, END if the data is exhausted or INVALID on malformed input or data that
+    ///         exceeds JsonIndexer::MAX_SIZE
+    Token lex();
+
+    /// Skips the remainder of the object or array whose opening token was lexed last. Only the balance
+    /// of the skipped brackets is checked, its contents are neither lexed nor validated.
+    /// @return A value that indicates whether the closing token was found
+    bool skip();
+
     /// Tokenizes the data
     /// @return A list of tokens
     std::vector<Token> tokenize();
@@ -234,53 +470,45 @@ public:
     static std::vector<Token> tokenize(std::string_view data);
 
 private:
-    /// Tries to parse a number from the current data string
-    /// @return An optional number
-    std::optional<std::string_view> number();
-
-    /// Tries to parse a string from the current data string
-    /// @return An optional string
-    std::optional<std::string_view> string();
+    /// Makes sure that the structural position at the cursor is indexed, indexing the next window of the
+    /// data once the current one is exhausted
+    /// @return A value that indicates whether a position is available, false at the end or on error
+    bool fill();
 
-    /// Advances the cursor by 'count' places
-    /// @param count The number of places the cursor should be advanced
-    void advance(u64 count = 1);
-
-    /// Tries to consume a text, returns the lexeme if successful
-    /// @param text The text
+    /// Tries to lex a number that starts at the given position
+    /// @param position The position
     /// @return The optional lexeme
-    std::optional<std::string_view> consume(std::string_view text);
-
-    /// Retrieves the current char or '\0' if the cursor reached the end
-    /// @return The current char or '\0' if the cursor reached the end
-    char current() const;
-
-    /// Retrieves the next char or '\0' if the cursor reached the end
-    /// @return The next char or '\0' if the cursor reached the end
-    char next() const;
+    std::optional<std::string_view> number(usize position) const;
 
-    /// Retrieves the data pointer or null if the cursor reached the end
-    /// @return The data pointer or null if the cursor reached the end
-    const char *current_ptr() const;
+    /// Tries to lex a string whose opening quote is at the given position, consumes the closing quote
+    /// @param position The position
+    /// @return The optional lexeme without quotes
+    std::optional<std::string_view> string(usize position);
 
-    /// Retrieves the current text given a count of places
-    /// @param count The count of places to look forward
-    /// @return The lexeme
-    std::string_view current_text(u64 count = 1) const;
+    /// Tries to lex a literal that starts at the given position
+    /// @param position The position
+    /// @param text The literal
+    /// @return The optional lexeme
+    std::optional<std::string_view> literal(usize position, std::string_view text) const;
 
-    /// Checks if the cursor reached the end
-    /// @return A value that indicates whether the cursor reached the end
-    bool end() const;
+    /// Checks whether a number or literal that ends at the given position is properly delimited
+    /// @param position The position after the last character of the number or literal
+    /// @return A value that indicates whether the token is followed by whitespace, a structural
+    ///         character or the end of the data
+    bool delimited(usize position) const;
 
     std::string_view data;
+    JsonIndexer indexer;
+    std::vector<u32> index;
+    usize cursor;
     bool error;
 };
 
 class JsonParser {
 public:
-    /// Creates a new parser
-    /// @param tokens The tokens
-    explicit JsonParser(const std::vector<JsonLexer::Token> &tokens);
+    /// Creates a new parser that lexes the data on demand
+    /// @param data The stringified JSON data
+    explicit JsonParser(std::string_view data);
 
     /// Parses the JSON object
     /// @return An optional JSON object
@@ -292,17 +520,25 @@ public:
     static std::optional<Json> parse(std::string_view data);
 
 private:
-    /// Tries to parse a JSON object
+    /// Tries to parse the members of a JSON object
+    /// @param depth The number of objects and arrays that enclose the members
     /// @return An optional JSON object
-    std::optional<Json::Value> object();
+    std::optional<Json> members(usize depth);
+
+    /// Tries to parse a JSON object
+    /// @param depth The number of objects and arrays that enclose the members
+    /// @return An optional JSON object value
+    std::optional<Json::Value> object(usize depth);
 
     /// Tries to parse a JSON value
-    /// @return An optional JSON value
-    std::optional<Json::Value> value();
+    /// @param depth The number of objects and arrays that enclose the value
+    /// @return An optional JSON value, std::nullopt if it is nested deeper than JsonLexer::MAX_DEPTH
+    std::optional<Json::Value> value(usize depth);
 
     /// Tries to parse a JSON array value
+    /// @param depth The number of objects and arrays that enclose the elements
     /// @return An optional JSON array value
-    std::optional<Json::Value> array();
+    std::optional<Json::Value> array(usize depth);
 
     /// Tries to parse a JSON string value
     /// @return An optional JSON string value
@@ -320,7 +556,7 @@ private:
     /// @return An optional JSON number
     std::optional<Json::Value> number();
 
-    /// Advances the cursor by one
+    /// Advances the cursor by one token
     void advance();
 
     /// Tries to consume a token
@@ -333,19 +569,13 @@ private:
     /// @return A value that indicates whether the current token type matches
     bool match(JsonLexer::TokenType type) const;
 
-    /// Retrieves the current token or INVALID if the cursor reached the end
-    /// @return The current token or INVALID if the cursor reached the end
+    /// Retrieves the current token, END if the data is exhausted or INVALID on malformed input
+    /// @return The current token
     JsonLexer::Token current() const;
 
-    /// Retrieves the next token or INVALID if the cursor reached the end
-    /// @return The next token or INVALID if the cursor reached the end
-    JsonLexer::Token next() const;
-
-    /// Checks if the cursor reached the end
-    /// @return A value that indicates whether the cursor reached the end
-    bool end() const;
-
-    std::vector<JsonLexer::Token> tokens;
+    JsonLexer lexer;
+    JsonLexer::Token token;
+    std::vector<Json::Value> elements;
 };
 
 }// namespace detail
@@ -0,0 +1,123 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Elias Engelbert Plank
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <functional>
+
+#include "json_binding.h"
+
+namespace rt {
+
+namespace detail {
+
+/// Creates a new binder
+JsonBinder::JsonBinder(std::string_view data)
+    : data{ data },
+      lexer{ data },
+      token{ lexer.lex() },
+      scratch{},
+      current{},
+      failure{} { }
+
+/// Checks that the data has been consumed entirely
+bool JsonBinder::finish() {
+    return match(JsonLexer::TokenType::END) or fail(JsonBinding::Error::Code::SYNTAX);
+}
+
+/// Retrieves the reason and location of the failure
+JsonBinding::Error JsonBinder::error() const {
+    return failure;
+}
+
+/// Tries to decode the current JSON string
+std::optional<std::string_view> JsonBinder::string() {
+    if (token.lexeme.find('\\') == std::string_view::npos) {
+        return token.lexeme;
+    }
+
+    if (scratch.size() < token.lexeme.size()) {
+        scratch.resize(token.lexeme.size());
+    }
+    if (auto size = unescape(token.lexeme, scratch.data())) {
+        return std::string_view{ scratch.data(), *size };
+    }
+    return std::nullopt;
+}
+
+/// Skips the current value
+bool JsonBinder::skip() {
+    switch (token.type) {
+        case JsonLexer::TokenType::LEFT_BRACE:
+        case JsonLexer::TokenType::LEFT_BRACKET:
+            if (not lexer.skip()) {
+                return fail(JsonBinding::Error::Code::SYNTAX);
+            }
+            advance();
+            return true;
+        case JsonLexer::TokenType::STRING:
+        case JsonLexer::TokenType::NUMBER:
+        case JsonLexer::TokenType::TRUE:
+        case JsonLexer::TokenType::FALSE:
+        case JsonLexer::TokenType::NIL:
+            advance();
+            return true;
+        default:
+            return fail(JsonBinding::Error::Code::SYNTAX);
+    }
+}
+
+/// Records a failure at the current token
+bool JsonBinder::fail(JsonBinding::Error::Code code) {
+    // END and INVALID tokens do not point into the data
+    auto *begin = data.data();
+    auto *end = data.data() + data.size();
+    auto *at = token.lexeme.data();
+    auto inside = std::less_equal<>{}(begin, at) and std::less_equal<>{}(at, end);
+    if (token.type == JsonLexer::TokenType::INVALID) {
+        code = JsonBinding::Error::Code::SYNTAX;
+    }
+    failure = { code, inside ? static_cast<usize>(at - begin) : data.size(), current };
+    return false;
+}
+
+/// Advances the cursor by one token
+void JsonBinder::advance() {
+    token = lexer.lex();
+}
+
+/// Tries to consume a token
+bool JsonBinder::consume(JsonLexer::TokenType type) {
+    if (match(type)) {
+        advance();
+        return true;
+    }
+    return false;
+}
+
+/// Tries to match the current token type
+bool JsonBinder::match(JsonLexer::TokenType type) const {
+    return token.type == type;
+}
+
+}// namespace detail
+
+}// namespace rt
@@ -0,0 +1,481 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Elias Engelbert Plank
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef REALTIME_JSON_BINDING_H
+#define REALTIME_JSON_BINDING_H
+
+#include <array>
+#include <bit>
+#include <bitset>
+#include <tuple>
+#include <vector>
+
+#include "json.h"
+
+namespace rt {
+
+/// Describes how a type is bound to JSON and must be specialized for every bound struct and enum.
+/// Structs list their members as a tuple of fields, enums that are spelled as strings list their names:
+///     template<> struct JsonSchema<Foo> {
+///         static constexpr auto fields = std::tuple{ JsonField{ "bar", &Foo::bar, true } };
+///     };
+///     template<> struct JsonSchema<Kind> {
+///         static constexpr std::array names = { JsonName{ "FIRST", Kind::FIRST } };
+///     };
+/// Enums without names are bound to their underlying integer.
+template<typename T>
+struct JsonSchema;
+
+/// Binds a JSON key to a data member
+/// @tparam MemberPointer The type of the pointer to the data member
+template<typename MemberPointer>
+struct JsonField {
+    std::string_view key;
+    MemberPointer member;
+    bool required = false;
+};
+
+template<typename MemberPointer>
+JsonField(std::string_view, MemberPointer, bool = false) -> JsonField<MemberPointer>;
+
+/// Binds a JSON string to an enum value
+/// @tparam Enum The enum
+template<typename Enum>
+struct JsonName {
+    std::string_view name;
+    Enum value;
+};
+
+template<typename Enum>
+JsonName(std::string_view, Enum) -> JsonName<Enum>;
+
+class JsonBinding {
+public:
+    /// Describes why decoding failed
+    struct Error {
+        enum class Code {
+            NONE,
+            SYNTAX,
+            TYPE_MISMATCH,
+            OUT_OF_RANGE,
+            MISSING_FIELD
+        };
+
+        Code code;
+        usize offset;
+        std::string_view field;
+    };
+
+    /// Decodes stringified JSON data straight into the given type, unknown keys are skipped
+    /// @tparam T The type, a struct with a schema or any other bindable type
+    /// @param data The stringified JSON data
+    /// @param error An optional pointer that receives the reason and location of a failure
+    /// @return The decoded value or std::nullopt if the data is malformed or does not match the type
+    template<typename T>
+    static std::optional<T> decode(std::string_view data, Error *error = nullptr);
+};
+
+namespace detail {
+
+/// Hashes a JSON key
+/// @param key The key
+/// @param seed The seed
+/// @return The hash of the key
+constexpr u32 json_key_hash(std::string_view key, u32 seed) {
+    u32 hash = 2166136261u ^ seed;
+    for (auto c : key) {
+        hash = (hash ^ static_cast<u8>(c)) * 16777619u;
+    }
+    return hash;
+}
+
+/// A perfect hash over the keys of a schema, searched for at compile time
+/// @tparam N The number of keys
+template<usize N>
+class JsonKeyTable {
+public:
+    static_assert(N < 255, "[json] Too many fields for a single schema!");
+    static constexpr usize SIZE = std::bit_ceil(2 * N + 1);
+
+    /// Searches for a seed under which no two keys share a slot
+    /// @param keys The keys
+    constexpr explicit JsonKeyTable(const std::array<std::string_view, N> &keys) : keys{ keys }, seed{ 0 }, slots{} {
+        for (;; seed++) {
+            slots.fill(0);
+            auto collision = false;
+            for (usize index = 0; index < N and not collision; index++) {
+                auto &slot = slots[json_key_hash(keys[index], seed) & (SIZE - 1)];
+                collision = slot != 0;
+                slot = static_cast<u8>(index + 1);
+            }
+            if (not collision) {
+                break;
+            }
+        }
+    }
+
+    /// Looks up the index of the given key
+    /// @param key The key
+    /// @return The index of the key or N if the key is unknown
+    constexpr usize find(std::string_view key) const {
+        if (auto slot = slots[json_key_hash(key, seed) & (SIZE - 1)]; slot != 0 and keys[slot - 1] == key) {
+            return slot - 1;
+        }
+        return N;
+    }
+
+private:
+    std::array<std::string_view, N> keys;
+    u32 seed;
+    std::array<u8, SIZE> slots;
+};
+
+/// Collects the keys of the fields of a schema
+/// @tparam T The bound type
+/// @return The keys
+template<typename T>
+constexpr auto json_schema_keys() {
+    return std::apply(
+            [](const auto &...fields) { return std::array<std::string_view, sizeof...(fields)>{ fields.key... }; },
+            JsonSchema<T>::fields);
+}
+
+/// Collects which fields of a schema are required
+/// @tparam T The bound type
+/// @return The required flags
+template<typename T>
+constexpr auto json_schema_required() {
+    return std::apply([](const auto &...fields) { return std::array<bool, sizeof...(fields)>{ fields.required... }; },
+                      JsonSchema<T>::fields);
+}
+
+template<typename T>
+concept JsonStruct = requires { JsonSchema<T>::fields; };
+
+template<typename T>
+concept JsonNamedEnum = std::is_enum_v<T> and requires { JsonSchema<T>::names; };
+
+template<typename T>
+struct is_std_array : std::false_type { };
+
+template<typename T, usize N>
+struct is_std_array<std::array<T, N>> : std::true_type { };
+
+/// Decodes JSON tokens straight into bound types while lexing
+class JsonBinder {
+public:
+    /// Creates a new binder
+    /// @param data The stringified JSON data
+    explicit JsonBinder(std::string_view data);
+
+    /// Tries to decode the current value into the given output
+    /// @tparam T The type of the output
+    /// @param out The output
+    /// @return A value that indicates success
+    template<typename T>
+    bool read(T &out);
+
+    /// Checks that the data has been consumed entirely
+    /// @return A value that indicates whether the data has been consumed entirely
+    bool finish();
+
+    /// Retrieves the reason and location of the failure
+    /// @return The error
+    JsonBinding::Error error() const;
+
+private:
+    /// Tries to decode the current JSON object into a struct
+    /// @tparam T The struct
+    /// @param out The output
+    /// @return A value that indicates success
+    template<typename T>
+    bool object(T &out);
+
+    /// Decodes the value of the field with the given index
+    /// @tparam T The struct
+    /// @param out The output
+    /// @param index The index of the field
+    /// @return A value that indicates success
+    template<typename T, usize... I>
+    bool field(T &out, usize index, std::index_sequence<I...>);
+
+    /// Tries to decode the current JSON array
+    /// @param element The function that decodes an element
+    /// @param capacity The maximum number of elements
+    /// @return The number of elements or std::nullopt on failure
+    template<typename Element>
+    std::optional<usize> array(Element &&element, usize capacity);
+
+    /// Tries to decode the current JSON number
+    /// @tparam T The arithmetic type
+    /// @param out The output
+    /// @return A value that indicates success
+    template<typename T>
+    bool number(T &out);
+
+    /// Tries to decode the current JSON string
+    /// @return The decoded string, valid until the next string is decoded, or std::nullopt on failure
+    std::optional<std::string_view> string();
+
+    /// Skips the current value
+    /// @return A value that indicates success
+    bool skip();
+
+    /// Records a failure at the current token
+    /// @param code The reason
+    /// @return Always false
+    bool fail(JsonBinding::Error::Code code);
+
+    /// Advances the cursor by one token
+    void advance();
+
+    /// Tries to consume a token
+    /// @param type The token type
+    /// @return A value that indicates whether the token was consumed
+    bool consume(JsonLexer::TokenType type);
+
+    /// Tries to match the current token type
+    /// @param type The token type
+    /// @return A value that indicates whether the current token type matches
+    bool match(JsonLexer::TokenType type) const;
+
+    std::string_view data;
+    JsonLexer lexer;
+    JsonLexer::Token token;
+    std::string scratch;
+    std::string_view current;
+    JsonBinding::Error failure;
+};
+
+/// Tries to decode the current value into the given output
+template<typename T>
+bool JsonBinder::read(T &out) {
+    using Code = JsonBinding::Error::Code;
+    using TokenType = JsonLexer::TokenType;
+
+    if constexpr (std::is_same_v<T, bool>) {
+        if (not match(TokenType::TRUE) and not match(TokenType::FALSE)) {
+            return fail(Code::TYPE_MISMATCH);
+        }
+        out = match(TokenType::TRUE);
+        advance();
+        return true;
+    } else if constexpr (std::is_arithmetic_v<T>) {
+        return number(out);
+    } else if constexpr (std::is_same_v<T, std::string>) {
+        if (not match(TokenType::STRING)) {
+            return fail(Code::TYPE_MISMATCH);
+        }
+        auto text = string();
+        if (not text) {
+            return fail(Code::SYNTAX);
+        }
+        out.assign(*text);
+        advance();
+        return true;
+    } else if constexpr (JsonNamedEnum<T>) {
+        if (not match(TokenType::STRING)) {
+            return fail(Code::TYPE_MISMATCH);
+        }
+        auto text = string();
+        if (not text) {
+            return fail(Code::SYNTAX);
+        }
+        for (const auto &name : JsonSchema<T>::names) {
+            if (name.name == *text) {
+                out = name.value;
+                advance();
+                return true;
+            }
+        }
+        return fail(Code::OUT_OF_RANGE);
+    } else if constexpr (std::is_enum_v<T>) {
+        std::underlying_type_t<T> value{};
+        if (not number(value)) {
+            return false;
+        }
+        out = static_cast<T>(value);
+        return true;
+    } else if constexpr (meta::is_specialization_of_v<T, std::optional>) {
+        if (consume(TokenType::NIL)) {
+            out.reset();
+            return true;
+        }
+        return read(out.emplace());
+    } else if constexpr (meta::is_specialization_of_v<T, std::vector>) {
+        out.clear();
+        auto count = array([this, &out](usize) { return read(out.emplace_back()); }, out.max_size());
+        return count.has_value();
+    } else if constexpr (is_std_array<T>::value) {
+        auto count = array([this, &out](usize index) { return read(out[index]); }, out.size());
+        if (count and *count != out.size()) {
+            return fail(Code::OUT_OF_RANGE);
+        }
+        return count.has_value();
+    } else if constexpr (JsonStruct<T>) {
+        return object(out);
+    } else {
+        static_assert(JsonStruct<T>, "[json] Type is not bindable, specialize JsonSchema for it!");
+    }
+}
+
+/// Tries to decode the current JSON object into a struct
+template<typename T>
+bool JsonBinder::object(T &out) {
+    using Code = JsonBinding::Error::Code;
+    using TokenType = JsonLexer::TokenType;
+
+    constexpr auto keys = json_schema_keys<T>();
+    constexpr auto table = JsonKeyTable<keys.size()>{ keys };
+
+    if (not match(TokenType::LEFT_BRACE)) {
+        return fail(Code::TYPE_MISMATCH);
+    }
+    advance();
+
+    std::bitset<keys.size()> seen{};
+    while (not consume(TokenType::RIGHT_BRACE)) {
+        if (not match(TokenType::STRING)) {
+            return fail(Code::SYNTAX);
+        }
+        auto key = string();
+        if (not key) {
+            return fail(Code::SYNTAX);
+        }
+        auto index = table.find(*key);
+        advance();
+        if (not consume(TokenType::COLON)) {
+            return fail(Code::SYNTAX);
+        }
+
+        if (index == keys.size()) {
+            if (not skip()) {
+                return false;
+            }
+        } else {
+            seen.set(index);
+            if (not field(out, index, std::make_index_sequence<keys.size()>{})) {
+                return false;
+            }
+        }
+
+        if (not match(TokenType::RIGHT_BRACE) and not consume(TokenType::COMMA)) {
+            return fail(Code::SYNTAX);
+        }
+    }
+
+    constexpr auto required = json_schema_required<T>();
+    for (usize index = 0; index < keys.size(); index++) {
+        if (required[index] and not seen.test(index)) {
+            current = keys[index];
+            return fail(Code::MISSING_FIELD);
+        }
+    }
+    return true;
+}
+
+/// Decodes the value of the field with the given index
+template<typename T, usize... I>
+bool JsonBinder::field(T &out, usize index, std::index_sequence<I...>) {
+    auto decode = [this, &out](const auto &field) {
+        auto parent = current;
+        current = field.key;
+        if (not read(out.*field.member)) {
+            return false;
+        }
+        current = parent;
+        return true;
+    };
+    return ((index == I and decode(std::get<I>(JsonSchema<T>::fields))) or ...);
+}
+
+/// Tries to decode the current JSON array
+template<typename Element>
+std::optional<usize> JsonBinder::array(Element &&element, usize capacity) {
+    using Code = JsonBinding::Error::Code;
+    using TokenType = JsonLexer::TokenType;
+
+    if (not consume(TokenType::LEFT_BRACKET)) {
+        fail(Code::TYPE_MISMATCH);
+        return std::nullopt;
+    }
+
+    usize count = 0;
+    while (not consume(TokenType::RIGHT_BRACKET)) {
+        if (count == capacity) {
+            fail(Code::OUT_OF_RANGE);
+            return std::nullopt;
+        }
+        if (not element(count++)) {
+            return std::nullopt;
+        }
+        if (not match(TokenType::RIGHT_BRACKET) and not consume(TokenType::COMMA)) {
+            fail(Code::SYNTAX);
+            return std::nullopt;
+        }
+    }
+    return count;
+}
+
+/// Tries to decode the current JSON number
+template<typename T>
+bool JsonBinder::number(T &out) {
+    using Code = JsonBinding::Error::Code;
+
+    if (not match(JsonLexer::TokenType::NUMBER)) {
+        return fail(Code::TYPE_MISMATCH);
+    }
+
+    // Integers reject fractions and exponents because the lexeme is not consumed entirely
+    auto lexeme = token.lexeme;
+    auto [end, ec] = std::from_chars(lexeme.data(), lexeme.data() + lexeme.size(), out);
+    if (ec == std::errc::result_out_of_range) {
+        return fail(Code::OUT_OF_RANGE);
+    }
+    if (ec != std::errc{} or end != lexeme.data() + lexeme.size()) {
+        return fail(Code::TYPE_MISMATCH);
+    }
+    advance();
+    return true;
+}
+
+}// namespace detail
+
+/// Decodes stringified JSON data straight into the given type
+template<typename T>
+std::optional<T> JsonBinding::decode(std::string_view data, Error *error) {
+    auto binder = detail::JsonBinder{ data };
+    T result{};
+    auto success = binder.read(result) and binder.finish();
+    if (error) {
+        *error = binder.error();
+    }
+    if (success) {
+        return result;
+    }
+    return std::nullopt;
+}
+
+}// namespace rt
+
+#endif// REALTIME_JSON_BINDING_H
@@ -0,0 +1,298 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Elias Engelbert Plank
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <memory>
+
+#include "json_document.h"
+
+namespace rt {
+
+/// Parses a JSON document from a string
+std::optional<JsonDocument> JsonDocument::parse(std::string_view data) {
+    return parse(data, false);
+}
+
+/// Parses a JSON document whose keys and strings are views into the given data
+std::optional<JsonDocument> JsonDocument::view(std::string_view data) {
+    return parse(data, true);
+}
+
+/// Retrieves the root node of the document
+const JsonDocument::Node &JsonDocument::root() const {
+    return *tree;
+}
+
+/// Retrieves the arena that holds the nodes of the document
+const Arena &JsonDocument::arena() const {
+    return storage;
+}
+
+/// Parses a JSON document from a string
+std::optional<JsonDocument> JsonDocument::parse(std::string_view data, bool borrow) {
+    // The lexer rejects data whose positions do not fit 32 bits, before anything is reserved for it
+    if (data.size() > detail::JsonIndexer::MAX_SIZE) {
+        return std::nullopt;
+    }
+
+    // Nodes and copied strings take up to three times the space of their textual representation, reserving
+    // that up front keeps most documents within a single block. Borrowed strings take no space at all.
+    auto estimate = borrow ? data.size() / 2 * 5 : data.size() * 3;
+    Arena arena{ std::max<usize>(estimate, Arena::DEFAULT_CAPACITY) };
+    auto parser = detail::JsonDocumentParser{ data, arena, borrow };
+    if (auto *root = parser.parse()) {
+        return JsonDocument{ std::move(arena), root };
+    }
+    return std::nullopt;
+}
+
+/// Creates a new document
+JsonDocument::JsonDocument(Arena &&arena, const Node *root) : storage{ std::move(arena) }, tree{ root } { }
+
+/// Retrieves the type of the node
+JsonDocument::Type JsonDocument::Node::type() const {
+    return kind;
+}
+
+/// Retrieves the number of the node
+std::optional<f64> JsonDocument::Node::number() const {
+    if (kind == Type::NUMBER) {
+        return num;
+    }
+    return std::nullopt;
+}
+
+/// Retrieves the boolean of the node
+std::optional<bool> JsonDocument::Node::boolean() const {
+    if (kind == Type::BOOL) {
+        return flag;
+    }
+    return std::nullopt;
+}
+
+/// Retrieves the string of the node
+std::optional<std::string_view> JsonDocument::Node::string() const {
+    if (kind == Type::STRING) {
+        return std::string_view{ text, length };
+    }
+    return std::nullopt;
+}
+
+/// Retrieves the elements of an array node
+std::span<const JsonDocument::Node> JsonDocument::Node::elements() const {
+    if (kind == Type::ARRAY) {
+        return { children, length };
+    }
+    return {};
+}
+
+/// Retrieves the members of an object node
+std::span<const JsonDocument::Member> JsonDocument::Node::members() const {
+    if (kind == Type::OBJECT) {
+        return { fields, length };
+    }
+    return {};
+}
+
+/// Retrieves the number of elements or members of the node
+usize JsonDocument::Node::size() const {
+    return kind == Type::ARRAY or kind == Type::OBJECT ? length : 0;
+}
+
+/// Searches for the member with the given key
+const JsonDocument::Node *JsonDocument::Node::find(std::string_view key) const {
+    for (const auto &member : members()) {
+        if (member.key == key) {
+            return &member.value;
+        }
+    }
+    return nullptr;
+}
+
+/// Retrieves the element at the given index
+const JsonDocument::Node *JsonDocument::Node::at(usize index) const {
+    if (auto children = elements(); index < children.size()) {
+        return &children[index];
+    }
+    return nullptr;
+}
+
+namespace detail {
+
+/// Creates a new parser that allocates the document nodes from the given arena
+JsonDocumentParser::JsonDocumentParser(std::string_view data, Arena &arena, bool borrow)
+    : lexer{ data },
+      token{ lexer.lex() },
+      arena{ arena },
+      borrow{ borrow } { }
+
+/// Parses the JSON document
+const JsonDocument::Node *JsonDocumentParser::parse() {
+    auto *root = arena.allocate<JsonDocument::Node>();
+    if (value(*root, 0) and match(JsonLexer::TokenType::END)) {
+        return root;
+    }
+    return nullptr;
+}
+
+/// Tries to parse a JSON value
+bool JsonDocumentParser::value(JsonDocument::Node &node, usize depth) {
+    node.length = 0;
+    switch (token.type) {
+        case JsonLexer::TokenType::LEFT_BRACE:
+            return depth < JsonLexer::MAX_DEPTH and object(node, depth + 1);
+        case JsonLexer::TokenType::LEFT_BRACKET:
+            return depth < JsonLexer::MAX_DEPTH and array(node, depth + 1);
+        case JsonLexer::TokenType::STRING:
+            if (auto str = string(token.lexeme)) {
+                node.kind = JsonDocument::Type::STRING;
+                node.length = static_cast<u32>(str->size());
+                node.text = str->data();
+                advance();
+                return true;
+            }
+            return false;
+        case JsonLexer::TokenType::TRUE:
+        case JsonLexer::TokenType::FALSE:
+            node.kind = JsonDocument::Type::BOOL;
+            node.flag = token.type == JsonLexer::TokenType::TRUE;
+            advance();
+            return true;
+        case JsonLexer::TokenType::NIL:
+            node.kind = JsonDocument::Type::NIL;
+            node.text = nullptr;
+            advance();
+            return true;
+        case JsonLexer::TokenType::NUMBER:
+            if (auto number = number_from_view<f64>(token.lexeme)) {
+                node.kind = JsonDocument::Type::NUMBER;
+                node.num = *number;
+                advance();
+                return true;
+            }
+            return false;
+        default:
+            return false;
+    }
+}
+
+/// Tries to parse a JSON object
+bool JsonDocumentParser::object(JsonDocument::Node &node, usize depth) {
+    advance();
+
+    auto mark = members.size();
+    while (not consume(JsonLexer::TokenType::RIGHT_BRACE)) {
+        if (not match(JsonLexer::TokenType::STRING)) {
+            return false;
+        }
+        auto key = string(token.lexeme);
+        advance();
+        if (not key or not consume(JsonLexer::TokenType::COLON)) {
+            return false;
+        }
+
+        JsonDocument::Node child{};
+        if (not value(child, depth)) {
+            return false;
+        }
+        members.push_back({ *key, child });
+
+        if (not match(JsonLexer::TokenType::RIGHT_BRACE) and not consume(JsonLexer::TokenType::COMMA)) {
+            return false;
+        }
+    }
+
+    auto count = members.size() - mark;
+    auto *fields = arena.allocate<JsonDocument::Member>(count);
+    std::uninitialized_copy(members.begin() + static_cast<std::ptrdiff_t>(mark), members.end(), fields);
+    members.resize(mark);
+
+    node.kind = JsonDocument::Type::OBJECT;
+    node.length = static_cast<u32>(count);
+    node.fields = fields;
+    return true;
+}
+
+/// Tries to parse a JSON array
+bool JsonDocumentParser::array(JsonDocument::Node &node, usize depth) {
+    advance();
+
+    auto mark = elements.size();
+    while (not consume(JsonLexer::TokenType::RIGHT_BRACKET)) {
+        JsonDocument::Node child{};
+        if (not value(child, depth)) {
+            return false;
+        }
+        elements.push_back(child);
+
+        if (not match(JsonLexer::TokenType::RIGHT_BRACKET) and not consume(JsonLexer::TokenType::COMMA)) {
+            return false;
+        }
+    }
+
+    auto count = elements.size() - mark;
+    auto *children = arena.allocate<JsonDocument::Node>(count);
+    std::uninitialized_copy(elements.begin() + static_cast<std::ptrdiff_t>(mark), elements.end(), children);
+    elements.resize(mark);
+
+    node.kind = JsonDocument::Type::ARRAY;
+    node.length = static_cast<u32>(count);
+    node.children = children;
+    return true;
+}
+
+/// Tries to decode a JSON string lexeme, copying it into the arena unless it can be borrowed
+std::optional<std::string_view> JsonDocumentParser::string(std::string_view lexeme) {
+    if (lexeme.find('\\') == std::string_view::npos) {
+        return borrow ? lexeme : arena.copy(lexeme);
+    }
+
+    auto *out = arena.allocate<char>(lexeme.size());
+    if (auto size = unescape(lexeme, out)) {
+        return std::string_view{ out, *size };
+    }
+    return std::nullopt;
+}
+
+/// Advances the cursor by one token
+void JsonDocumentParser::advance() {
+    token = lexer.lex();
+}
+
+/// Tries to consume a token
+bool JsonDocumentParser::consume(JsonLexer::TokenType type) {
+    if (match(type)) {
+        advance();
+        return true;
+    }
+    return false;
+}
+
+/// Tries to match the current token type
+bool JsonDocumentParser::match(JsonLexer::TokenType type) const {
+    return token.type == type;
+}
+
+}// namespace detail
+
+}// namespace rt
@@ -0,0 +1,223 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Elias Engelbert Plank
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef REALTIME_JSON_DOCUMENT_H
+#define REALTIME_JSON_DOCUMENT_H
+
+#include <span>
+#include <vector>
+
+#include "arena.h"
+#include "json.h"
+
+namespace rt {
+
+namespace detail {
+class JsonDocumentParser;
+}
+
+/// A compact, read-only JSON document. All nodes, keys and strings are bump-allocated from a single
+/// arena that is owned by the document, so the whole tree is released with the arena. Objects are
+/// stored as flat arrays of members and are searched linearly.
+class JsonDocument {
+public:
+    enum class Type : u8 {
+        NIL,
+        BOOL,
+        NUMBER,
+        STRING,
+        ARRAY,
+        OBJECT
+    };
+
+    class Node;
+    struct Member;
+
+    /// A document cannot be copied, allow move
+    JsonDocument(const JsonDocument &) = delete;
+    JsonDocument &operator=(const JsonDocument &) = delete;
+    JsonDocument(JsonDocument &&) = default;
+    JsonDocument &operator=(JsonDocument &&) = default;
+
+    /// Parses a JSON document from a string. Objects and arrays may be nested at most
+    /// detail::JsonLexer::MAX_DEPTH levels deep.
+    /// @param data The string
+    /// @return An optional JSON document
+    static std::optional<JsonDocument> parse(std::string_view data);
+
+    /// Parses a JSON document whose keys and strings are views into the given data. Only strings with
+    /// escape sequences are decoded into the arena, so the data must outlive the document. Objects and
+    /// arrays may be nested at most detail::JsonLexer::MAX_DEPTH levels deep.
+    /// @param data The string
+    /// @return An optional JSON document
+    static std::optional<JsonDocument> view(std::string_view data);
+
+    /// Retrieves the root node of the document
+    /// @return The root node
+    const Node &root() const;
+
+    /// Retrieves the arena that holds the nodes of the document
+    /// @return The arena
+    const Arena &arena() const;
+
+private:
+    /// Parses a JSON document from a string
+    /// @param data The string
+    /// @param borrow Whether unescaped strings may reference the data instead of being copied
+    /// @return An optional JSON document
+    static std::optional<JsonDocument> parse(std::string_view data, bool borrow);
+
+    /// Creates a new document
+    /// @param arena The arena that holds the nodes
+    /// @param root The root node
+    JsonDocument(Arena &&arena, const Node *root);
+
+    Arena storage;
+    const Node *tree;
+};
+
+class JsonDocument::Node {
+public:
+    /// Retrieves the type of the node
+    /// @return The type
+    Type type() const;
+
+    /// Retrieves the number of the node
+    /// @return The number or std::nullopt if the node is not a number
+    std::optional<f64> number() const;
+
+    /// Retrieves the boolean of the node
+    /// @return The boolean or std::nullopt if the node is not a boolean
+    std::optional<bool> boolean() const;
+
+    /// Retrieves the string of the node
+    /// @return The UTF-8 string or std::nullopt if the node is not a string
+    std::optional<std::string_view> string() const;
+
+    /// Retrieves the elements of an array node
+    /// @return The elements, empty if the node is not an array
+    std::span<const Node> elements() const;
+
+    /// Retrieves the members of an object node
+    /// @return The members, empty if the node is not an object
+    std::span<const Member> members() const;
+
+    /// Retrieves the number of elements or members of the node
+    /// @return The number of elements or members, zero for scalar nodes
+    usize size() const;
+
+    /// Searches for the member with the given key
+    /// @param key The key
+    /// @return The value of the member or null if the node is not an object or has no such member
+    const Node *find(std::string_view key) const;
+
+    /// Retrieves the element at the given index
+    /// @param index The index
+    /// @return The element or null if the node is not an array or the index is out of bounds
+    const Node *at(usize index) const;
+
+private:
+    friend class detail::JsonDocumentParser;
+
+    Type kind;
+    u32 length;
+    union {
+        f64 num;
+        bool flag;
+        const char *text;
+        const Node *children;
+        const Member *fields;
+    };
+};
+
+struct JsonDocument::Member {
+    std::string_view key;
+    Node value;
+};
+
+namespace detail {
+
+class JsonDocumentParser {
+public:
+    /// Creates a new parser that allocates the document nodes from the given arena
+    /// @param data The stringified JSON data
+    /// @param arena The arena
+    /// @param borrow Whether unescaped strings may reference the data instead of being copied
+    JsonDocumentParser(std::string_view data, Arena &arena, bool borrow);
+
+    /// Parses the JSON document
+    /// @return The root node or null if the data is malformed
+    const JsonDocument::Node *parse();
+
+private:
+    /// Tries to parse a JSON value
+    /// @param node The node that receives the value
+    /// @param depth The number of objects and arrays that enclose the value
+    /// @return A value that indicates success, false if the value is nested deeper than JsonLexer::MAX_DEPTH
+    bool value(JsonDocument::Node &node, usize depth);
+
+    /// Tries to parse a JSON object
+    /// @param node The node that receives the object
+    /// @param depth The number of objects and arrays that enclose the members
+    /// @return A value that indicates success
+    bool object(JsonDocument::Node &node, usize depth);
+
+    /// Tries to parse a JSON array
+    /// @param node The node that receives the array
+    /// @param depth The number of objects and arrays that enclose the elements
+    /// @return A value that indicates success
+    bool array(JsonDocument::Node &node, usize depth);
+
+    /// Tries to decode a JSON string lexeme, copying it into the arena unless it can be borrowed
+    /// @param lexeme The string lexeme without quotes
+    /// @return The decoded UTF-8 string or std::nullopt if the lexeme is malformed
+    std::optional<std::string_view> string(std::string_view lexeme);
+
+    /// Advances the cursor by one token
+    void advance();
+
+    /// Tries to consume a token
+    /// @param type The token type
+    /// @return A value that indicates whether the token was consumed
+    bool consume(JsonLexer::TokenType type);
+
+    /// Tries to match the current token type
+    /// @param type The token type
+    /// @return A value that indicates whether the current token type matches
+    bool match(JsonLexer::TokenType type) const;
+
+    JsonLexer lexer;
+    JsonLexer::Token token;
+    Arena &arena;
+    bool borrow;
+
+    // Scratch stacks that collect the children of all open containers
+    std::vector<JsonDocument::Node> elements;
+    std::vector<JsonDocument::Member> members;
+};
+
+}// namespace detail
+
+}// namespace rt
+
+#endif// REALTIME_JSON_DOCUMENT_H
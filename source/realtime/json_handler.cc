@@ -0,0 +1,248 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Elias Engelbert Plank
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "json_handler.h"
+
+namespace rt {
+
+/// Parses stringified JSON data and reports its values to the handler
+bool JsonHandler::parse(std::string_view data) {
+    auto parser = detail::JsonEventParser{ data, *this };
+    return parser.parse();
+}
+
+/// Called when an object begins
+JsonHandler::Action JsonHandler::on_object_begin() {
+    return Action::CONTINUE;
+}
+
+/// Called when an object ends
+JsonHandler::Action JsonHandler::on_object_end() {
+    return Action::CONTINUE;
+}
+
+/// Called when an array begins
+JsonHandler::Action JsonHandler::on_array_begin() {
+    return Action::CONTINUE;
+}
+
+/// Called when an array ends
+JsonHandler::Action JsonHandler::on_array_end() {
+    return Action::CONTINUE;
+}
+
+/// Called for every key of an object
+JsonHandler::Action JsonHandler::on_key(std::string_view) {
+    return Action::CONTINUE;
+}
+
+/// Called for every string value
+JsonHandler::Action JsonHandler::on_string_view(std::string_view) {
+    return Action::CONTINUE;
+}
+
+/// Called for every number value
+JsonHandler::Action JsonHandler::on_number(f64) {
+    return Action::CONTINUE;
+}
+
+/// Called for every boolean value
+JsonHandler::Action JsonHandler::on_bool(bool) {
+    return Action::CONTINUE;
+}
+
+/// Called for every null value
+JsonHandler::Action JsonHandler::on_null() {
+    return Action::CONTINUE;
+}
+
+namespace detail {
+
+/// Creates a new parser that reports the values of the data to the handler
+JsonEventParser::JsonEventParser(std::string_view data, JsonHandler &handler)
+    : lexer{ data },
+      token{ lexer.lex() },
+      handler{ handler },
+      stopped{ false } { }
+
+/// Parses the data
+bool JsonEventParser::parse() {
+    if (value(false, 0) and match(JsonLexer::TokenType::END)) {
+        return true;
+    }
+    return stopped;
+}
+
+/// Tries to parse a JSON value
+bool JsonEventParser::value(bool skip, usize depth) {
+    switch (token.type) {
+        case JsonLexer::TokenType::LEFT_BRACE:
+        case JsonLexer::TokenType::LEFT_BRACKET: {
+            // Skipping does not recurse, so only containers that are reported count towards the depth
+            auto is_object = token.type == JsonLexer::TokenType::LEFT_BRACE;
+            if (not skip) {
+                if (depth >= JsonLexer::MAX_DEPTH) {
+                    return false;
+                }
+                auto action = is_object ? handler.on_object_begin() : handler.on_array_begin();
+                if (not proceed(action)) {
+                    return false;
+                }
+                skip = action == JsonHandler::Action::SKIP;
+            }
+            if (skip) {
+                if (not lexer.skip()) {
+                    return false;
+                }
+                advance();
+                return true;
+            }
+            return is_object ? object(depth + 1) : array(depth + 1);
+        }
+        case JsonLexer::TokenType::STRING:
+            if (not skip) {
+                auto str = string(token.lexeme);
+                if (not str or not proceed(handler.on_string_view(*str))) {
+                    return false;
+                }
+            }
+            advance();
+            return true;
+        case JsonLexer::TokenType::NUMBER:
+            if (not skip) {
+                auto number = number_from_view<f64>(token.lexeme);
+                if (not number or not proceed(handler.on_number(*number))) {
+                    return false;
+                }
+            }
+            advance();
+            return true;
+        case JsonLexer::TokenType::TRUE:
+        case JsonLexer::TokenType::FALSE:
+            if (not skip and not proceed(handler.on_bool(token.type == JsonLexer::TokenType::TRUE))) {
+                return false;
+            }
+            advance();
+            return true;
+        case JsonLexer::TokenType::NIL:
+            if (not skip and not proceed(handler.on_null())) {
+                return false;
+            }
+            advance();
+            return true;
+        default:
+            return false;
+    }
+}
+
+/// Tries to parse the members of a JSON object whose opening brace is the current token
+bool JsonEventParser::object(usize depth) {
+    advance();
+
+    while (not consume(JsonLexer::TokenType::RIGHT_BRACE)) {
+        if (not match(JsonLexer::TokenType::STRING)) {
+            return false;
+        }
+        auto key = string(token.lexeme);
+        if (not key) {
+            return false;
+        }
+        auto action = handler.on_key(*key);
+        if (not proceed(action)) {
+            return false;
+        }
+        advance();
+        if (not consume(JsonLexer::TokenType::COLON) or not value(action == JsonHandler::Action::SKIP, depth)) {
+            return false;
+        }
+
+        if (not match(JsonLexer::TokenType::RIGHT_BRACE) and not consume(JsonLexer::TokenType::COMMA)) {
+            return false;
+        }
+    }
+    return proceed(handler.on_object_end());
+}
+
+/// Tries to parse the elements of a JSON array whose opening bracket is the current token
+bool JsonEventParser::array(usize depth) {
+    advance();
+
+    while (not consume(JsonLexer::TokenType::RIGHT_BRACKET)) {
+        if (not value(false, depth)) {
+            return false;
+        }
+
+        if (not match(JsonLexer::TokenType::RIGHT_BRACKET) and not consume(JsonLexer::TokenType::COMMA)) {
+            return false;
+        }
+    }
+    return proceed(handler.on_array_end());
+}
+
+/// Tries to decode a JSON string lexeme, strings without escape sequences are returned as is
+std::optional<std::string_view> JsonEventParser::string(std::string_view lexeme) {
+    if (lexeme.find('\\') == std::string_view::npos) {
+        return lexeme;
+    }
+
+    // The scratch buffer only ever grows to the longest escaped string of the document
+    if (scratch.size() < lexeme.size()) {
+        scratch.resize(lexeme.size());
+    }
+    if (auto size = unescape(lexeme, scratch.data())) {
+        return std::string_view{ scratch.data(), *size };
+    }
+    return std::nullopt;
+}
+
+/// Applies the action that was returned by a callback
+bool JsonEventParser::proceed(JsonHandler::Action action) {
+    if (action == JsonHandler::Action::STOP) {
+        stopped = true;
+        return false;
+    }
+    return true;
+}
+
+/// Advances the cursor by one token
+void JsonEventParser::advance() {
+    token = lexer.lex();
+}
+
+/// Tries to consume a token
+bool JsonEventParser::consume(JsonLexer::TokenType type) {
+    if (match(type)) {
+        advance();
+        return true;
+    }
+    return false;
+}
+
+/// Tries to match the current token type
+bool JsonEventParser::match(JsonLexer::TokenType type) const {
+    return token.type == type;
+}
+
+}// namespace detail
+
+}// namespace rt
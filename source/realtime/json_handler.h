@@ -0,0 +1,164 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Elias Engelbert Plank
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef REALTIME_JSON_HANDLER_H
+#define REALTIME_JSON_HANDLER_H
+
+#include <string>
+
+#include "json.h"
+
+namespace rt {
+
+/// A push-style JSON consumer. Parsing a document reports every value to the overridden callbacks in
+/// document order without building a tree, so only the data the handler keeps is retained. Callbacks
+/// may skip the value they announce or stop parsing altogether.
+class JsonHandler {
+public:
+    /// The action that is taken after a callback returns
+    enum class Action {
+        CONTINUE,
+        SKIP,
+        STOP
+    };
+
+    /// A handler may be copied or moved
+    JsonHandler() = default;
+    JsonHandler(const JsonHandler &) = default;
+    JsonHandler &operator=(const JsonHandler &) = default;
+    JsonHandler(JsonHandler &&) = default;
+    JsonHandler &operator=(JsonHandler &&) = default;
+    virtual ~JsonHandler() = default;
+
+    /// Parses stringified JSON data and reports its values to the handler. Objects and arrays may be nested
+    /// at most detail::JsonLexer::MAX_DEPTH levels deep, unless they are skipped.
+    /// @param data The stringified JSON data
+    /// @return A value that indicates whether the data is well-formed, stopping counts as success
+    bool parse(std::string_view data);
+
+    /// Called when an object begins, SKIP passes over the object without further callbacks
+    /// @return The action
+    virtual Action on_object_begin();
+
+    /// Called when an object ends
+    /// @return The action
+    virtual Action on_object_end();
+
+    /// Called when an array begins, SKIP passes over the array without further callbacks
+    /// @return The action
+    virtual Action on_array_begin();
+
+    /// Called when an array ends
+    /// @return The action
+    virtual Action on_array_end();
+
+    /// Called for every key of an object, SKIP passes over the value of the key
+    /// @param key The decoded key, only valid for the duration of the call
+    /// @return The action
+    virtual Action on_key(std::string_view key);
+
+    /// Called for every string value
+    /// @param string The decoded string, only valid for the duration of the call
+    /// @return The action
+    virtual Action on_string_view(std::string_view string);
+
+    /// Called for every number value
+    /// @param number The number
+    /// @return The action
+    virtual Action on_number(f64 number);
+
+    /// Called for every boolean value
+    /// @param boolean The boolean
+    /// @return The action
+    virtual Action on_bool(bool boolean);
+
+    /// Called for every null value
+    /// @return The action
+    virtual Action on_null();
+};
+
+namespace detail {
+
+class JsonEventParser {
+public:
+    /// Creates a new parser that reports the values of the data to the handler
+    /// @param data The stringified JSON data
+    /// @param handler The handler
+    JsonEventParser(std::string_view data, JsonHandler &handler);
+
+    /// Parses the data
+    /// @return A value that indicates whether the data is well-formed
+    bool parse();
+
+private:
+    /// Tries to parse a JSON value
+    /// @param skip Whether the value is skipped without reporting it
+    /// @param depth The number of objects and arrays that enclose the value
+    /// @return A value that indicates success, false if the value is nested deeper than JsonLexer::MAX_DEPTH
+    bool value(bool skip, usize depth);
+
+    /// Tries to parse the members of a JSON object whose opening brace is the current token
+    /// @param depth The number of objects and arrays that enclose the members
+    /// @return A value that indicates success
+    bool object(usize depth);
+
+    /// Tries to parse the elements of a JSON array whose opening bracket is the current token
+    /// @param depth The number of objects and arrays that enclose the elements
+    /// @return A value that indicates success
+    bool array(usize depth);
+
+    /// Tries to decode a JSON string lexeme, strings without escape sequences are returned as is
+    /// @param lexeme The string lexeme without quotes
+    /// @return The decoded string, valid until the next call, or std::nullopt if the lexeme is malformed
+    std::optional<std::string_view> string(std::string_view lexeme);
+
+    /// Applies the action that was returned by a callback
+    /// @param action The action
+    /// @return A value that indicates whether parsing continues
+    bool proceed(JsonHandler::Action action);
+
+    /// Advances the cursor by one token
+    void advance();
+
+    /// Tries to consume a token
+    /// @param type The token type
+    /// @return A value that indicates whether the token was consumed
+    bool consume(JsonLexer::TokenType type);
+
+    /// Tries to match the current token type
+    /// @param type The token type
+    /// @return A value that indicates whether the current token type matches
+    bool match(JsonLexer::TokenType type) const;
+
+    JsonLexer lexer;
+    JsonLexer::Token token;
+    JsonHandler &handler;
+    std::string scratch;
+    bool stopped;
+};
+
+}// namespace detail
+
+}// namespace rt
+
+#endif// REALTIME_JSON_HANDLER_H
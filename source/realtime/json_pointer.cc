@@ -0,0 +1,107 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Elias Engelbert Plank
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "json_pointer.h"
+
+namespace rt {
+
+/// Compiles a JSON Pointer
+std::optional<JsonPointer> JsonPointer::compile(std::string_view pointer) {
+    JsonPointer result{};
+    while (not pointer.empty()) {
+        if (pointer.front() != '/') {
+            return std::nullopt;
+        }
+        pointer.remove_prefix(1);
+        auto token = pointer.substr(0, pointer.find('/'));
+        pointer.remove_prefix(token.size());
+
+        Segment segment{ {}, {}, std::nullopt, token == "*" };
+        for (usize i = 0; i < token.size(); i++) {
+            if (token[i] != '~') {
+                segment.key += token[i];
+            } else if (i + 1 < token.size() and (token[i + 1] == '0' or token[i + 1] == '1')) {
+                segment.key += token[++i] == '0' ? '~' : '/';
+            } else {
+                return std::nullopt;
+            }
+        }
+
+        std::string_view key = segment.key;
+        while (not key.empty()) {
+            auto codepoint = utf8_decode(key);
+            if (not codepoint) {
+                return std::nullopt;
+            }
+            segment.wide_key += static_cast<char32_t>(*codepoint);
+        }
+
+        // Array indices are either zero or decimal digits without a leading zero
+        auto digits = not token.empty() and token.find_first_not_of("0123456789") == std::string_view::npos;
+        if (digits and (token.size() == 1 or token.front() != '0')) {
+            segment.index = number_from_view<usize>(token);
+        }
+        result.segments.emplace_back(std::move(segment));
+    }
+    return result;
+}
+
+/// Retrieves the first value that is matched by the pointer
+const Json::Value *JsonPointer::find(const Json &json) const {
+    const Json::Value *result = nullptr;
+    for_each(json, [&result](const Json::Value &value) {
+        result = &value;
+        return false;
+    });
+    return result;
+}
+
+/// Retrieves the first value that is matched by the pointer
+JsonTape::Value JsonPointer::find(const JsonTape &tape) const {
+    JsonTape::Value result{};
+    for_each(tape, [&result](JsonTape::Value value) {
+        result = value;
+        return false;
+    });
+    return result;
+}
+
+/// Retrieves the number of segments of the pointer
+usize JsonPointer::size() const {
+    return segments.size();
+}
+
+/// Checks whether the key of an object member equals the key of the segment
+bool JsonPointer::matches(JsonTape::Value name, const Segment &segment) {
+    auto text = name.raw();
+    if (not text) {
+        return false;
+    }
+    if (text->find('\\') == std::string_view::npos) {
+        return *text == segment.key;
+    }
+    return name.string() == segment.key;
+}
+
+}// namespace rt
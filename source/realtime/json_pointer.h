@@ -0,0 +1,224 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Elias Engelbert Plank
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef REALTIME_JSON_POINTER_H
+#define REALTIME_JSON_POINTER_H
+
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "json.h"
+#include "json_tape.h"
+
+namespace rt {
+
+/// A compiled JSON Pointer as specified by RFC 6901, extended by `*` segments that match every element
+/// of an array and every member of an object, e.g. `/accessors/*/bufferView`. The escape sequences of
+/// every segment are decoded once when compiling, into UTF-8 for tapes and UTF-32 for Json objects, so a
+/// pointer can run against any number of documents without converting keys or building intermediate
+/// values. Matches are passed to a function, which may return false to stop the search.
+class JsonPointer {
+public:
+    /// A reference token of the pointer
+    struct Segment {
+        /// The unescaped key in UTF-8
+        std::string key;
+
+        /// The unescaped key in UTF-32
+        Json::Key wide_key;
+
+        /// The array index, if the key is a valid one
+        std::optional<usize> index;
+
+        /// Whether the segment matches every child
+        bool wildcard;
+    };
+
+    /// Compiles a JSON Pointer
+    /// @param pointer The pointer, either empty or a sequence of segments that each start with a slash
+    /// @return The compiled pointer or std::nullopt if the pointer is malformed
+    static std::optional<JsonPointer> compile(std::string_view pointer);
+
+    /// Passes every value that is matched by the pointer to the function. Unlike with values and tapes, the
+    /// empty pointer matches nothing: it refers to the object itself, which is not a Json::Value.
+    /// @param json The JSON object
+    /// @param function The function that is called with a const Json::Value &
+    template<typename Function>
+    void for_each(const Json &json, Function &&function) const {
+        if (not segments.empty()) {
+            visit(json, 0, function);
+        }
+    }
+
+    /// Passes every value that is matched by the pointer to the function
+    /// @param value The JSON value
+    /// @param function The function that is called with a const Json::Value &
+    template<typename Function>
+    void for_each(const Json::Value &value, Function &&function) const {
+        visit(value, 0, function);
+    }
+
+    /// Passes every value that is matched by the pointer to the function
+    /// @param tape The JSON tape
+    /// @param function The function that is called with a JsonTape::Value
+    template<typename Function>
+    void for_each(const JsonTape &tape, Function &&function) const {
+        visit(tape.root(), 0, function);
+    }
+
+    /// Retrieves the first value that is matched by the pointer
+    /// @param json The JSON object
+    /// @return A pointer to the value or nullptr if nothing matches, always for the empty pointer, which
+    ///         refers to the object itself
+    const Json::Value *find(const Json &json) const;
+
+    /// Retrieves the first value that is matched by the pointer
+    /// @param tape The JSON tape
+    /// @return The value, invalid if nothing matches
+    JsonTape::Value find(const JsonTape &tape) const;
+
+    /// Retrieves the number of segments of the pointer
+    /// @return The number of segments
+    usize size() const;
+
+private:
+    /// Calls the function with a match
+    /// @param function The function
+    /// @param value The match
+    /// @return A value that indicates whether the search continues
+    template<typename Function, typename Value>
+    static bool yield(Function &function, const Value &value) {
+        if constexpr (std::is_void_v<std::invoke_result_t<Function &, const Value &>>) {
+            function(value);
+            return true;
+        } else {
+            return static_cast<bool>(function(value));
+        }
+    }
+
+    /// Matches the segments starting at the given depth against the members of an object
+    /// @param json The JSON object
+    /// @param depth The index of the segment, must be in range
+    /// @param function The function
+    /// @return A value that indicates whether the search continues
+    template<typename Function>
+    bool visit(const Json &json, usize depth, Function &function) const {
+        const auto &segment = segments[depth];
+        if (segment.wildcard) {
+            for (auto it = json.cbegin(); it != json.cend(); ++it) {
+                if (not visit(it->second, depth + 1, function)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        if (const auto *member = json.find(segment.wide_key)) {
+            return visit(*member, depth + 1, function);
+        }
+        return true;
+    }
+
+    /// Matches the segments starting at the given depth against a value
+    /// @param value The JSON value
+    /// @param depth The index of the segment
+    /// @param function The function
+    /// @return A value that indicates whether the search continues
+    template<typename Function>
+    bool visit(const Json::Value &value, usize depth, Function &function) const {
+        if (depth == segments.size()) {
+            return yield(function, value);
+        }
+        if (const auto *json = value.as<Json>()) {
+            return visit(*json, depth, function);
+        }
+        if (const auto *array = value.as<Json::Array>()) {
+            const auto &segment = segments[depth];
+            if (segment.wildcard) {
+                for (auto it = array->cbegin(); it != array->cend(); ++it) {
+                    if (not visit(*it, depth + 1, function)) {
+                        return false;
+                    }
+                }
+            } else if (segment.index and *segment.index < array->size()) {
+                return visit(*(array->cbegin() + static_cast<std::ptrdiff_t>(*segment.index)), depth + 1, function);
+            }
+        }
+        return true;
+    }
+
+    /// Matches the segments starting at the given depth against a value of a tape
+    /// @param value The tape value
+    /// @param depth The index of the segment
+    /// @param function The function
+    /// @return A value that indicates whether the search continues
+    template<typename Function>
+    bool visit(JsonTape::Value value, usize depth, Function &function) const {
+        if (depth == segments.size()) {
+            return yield(function, value);
+        }
+        const auto &segment = segments[depth];
+        switch (value.type()) {
+            case JsonTape::Type::OBJECT:
+                for (auto name = value.first(); name; name = name.next().next()) {
+                    if (segment.wildcard or matches(name, segment)) {
+                        if (not visit(name.next(), depth + 1, function)) {
+                            return false;
+                        }
+                        if (not segment.wildcard) {
+                            break;
+                        }
+                    }
+                }
+                return true;
+            case JsonTape::Type::ARRAY:
+                if (segment.wildcard) {
+                    for (auto element = value.first(); element; element = element.next()) {
+                        if (not visit(element, depth + 1, function)) {
+                            return false;
+                        }
+                    }
+                } else if (segment.index) {
+                    if (auto element = value[*segment.index]) {
+                        return visit(element, depth + 1, function);
+                    }
+                }
+                return true;
+            default:
+                return true;
+        }
+    }
+
+    /// Checks whether the key of an object member equals the key of the segment
+    /// @param name The key of the member
+    /// @param segment The segment
+    /// @return A value that indicates whether the keys are equal
+    static bool matches(JsonTape::Value name, const Segment &segment);
+
+    std::vector<Segment> segments;
+};
+
+}// namespace rt
+
+#endif// REALTIME_JSON_POINTER_H
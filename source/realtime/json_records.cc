@@ -0,0 +1,139 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Elias Engelbert Plank
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "json_records.h"
+
+namespace rt {
+
+namespace {
+
+/// Removes JSON whitespace from both ends of a view
+/// @param view The view
+/// @return The trimmed view
+std::string_view trim(std::string_view view) {
+    constexpr std::string_view WHITESPACE = " \t\n\r";
+    auto begin = view.find_first_not_of(WHITESPACE);
+    if (begin == std::string_view::npos) {
+        return {};
+    }
+    return view.substr(begin, view.find_last_not_of(WHITESPACE) - begin + 1);
+}
+
+}// namespace
+
+/// Splits JSON Lines data into records
+std::vector<std::string_view> JsonRecords::split_lines(std::string_view data) {
+    // Strings cannot contain raw line breaks, so every line break ends a record
+    std::vector<std::string_view> records{};
+    while (not data.empty()) {
+        auto end = data.find('\n');
+        if (auto record = trim(data.substr(0, end)); not record.empty()) {
+            records.push_back(record);
+        }
+        data.remove_prefix(end == std::string_view::npos ? data.size() : end + 1);
+    }
+    return records;
+}
+
+/// Splits a top-level JSON array into its elements
+std::optional<std::vector<std::string_view>> JsonRecords::split_array(std::string_view data) {
+    if (data.size() > detail::JsonIndexer::MAX_SIZE) {
+        return std::nullopt;
+    }
+    std::vector<std::string_view> records{};
+    std::vector<u32> positions{};
+    positions.reserve(detail::JsonIndexer::WINDOW_SIZE / 4);
+
+    usize depth = 0;
+    usize start = 0;
+    auto opened = false;
+    auto closed = false;
+    auto separated = false;
+    auto indexer = detail::JsonIndexer{ data };
+    while (not indexer.done()) {
+        positions.clear();
+        indexer.next(positions);
+        for (auto position : positions) {
+            auto c = data[position];
+            if (closed or (not opened and c != '[')) {
+                return std::nullopt;
+            }
+
+            switch (c) {
+                case '{':
+                case '[':
+                    if (depth++ == 0) {
+                        opened = true;
+                        start = position + 1;
+                    }
+                    break;
+                case '}':
+                case ']':
+                    if (depth-- == 1) {
+                        if (c != ']') {
+                            return std::nullopt;
+                        }
+                        auto record = trim(data.substr(start, position - start));
+                        if (not record.empty() or separated) {
+                            records.push_back(record);
+                        }
+                        closed = true;
+                    }
+                    break;
+                case ',':
+                    if (depth == 1) {
+                        records.push_back(trim(data.substr(start, position - start)));
+                        start = position + 1;
+                        separated = true;
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
+    if (not closed or indexer.in_string()) {
+        return std::nullopt;
+    }
+    return records;
+}
+
+/// Groups consecutive records into batches of at least BATCH_SIZE bytes
+std::vector<usize> JsonRecords::batches(std::span<const std::string_view> records) {
+    std::vector<usize> bounds{ 0 };
+    usize bytes = 0;
+    for (usize index = 0; index < records.size(); index++) {
+        bytes += records[index].size();
+        if (bytes >= BATCH_SIZE) {
+            bounds.push_back(index + 1);
+            bytes = 0;
+        }
+    }
+    if (bounds.back() != records.size()) {
+        bounds.push_back(records.size());
+    }
+    return bounds;
+}
+
+}// namespace rt
@@ -0,0 +1,123 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Elias Engelbert Plank
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef REALTIME_JSON_RECORDS_H
+#define REALTIME_JSON_RECORDS_H
+
+#include <span>
+#include <vector>
+
+#include "json.h"
+#include "thread_pool.h"
+
+namespace rt {
+
+/// Parses independent JSON records in parallel. The records of JSON Lines data or of a top-level array
+/// are located by a fast structural pre-scan, grouped into batches and parsed on a thread pool with an
+/// arbitrary record parser. The results are returned in record order.
+class JsonRecords {
+public:
+    /// The minimum number of bytes of a batch of records that is parsed by a single task
+    static constexpr usize BATCH_SIZE = 64 * 1024;
+
+    /// Splits JSON Lines data into records, blank lines are skipped
+    /// @param data The JSON Lines data
+    /// @return The records
+    static std::vector<std::string_view> split_lines(std::string_view data);
+
+    /// Splits a top-level JSON array into its elements
+    /// @param data The stringified JSON array
+    /// @return The elements or std::nullopt if the data is not a single array
+    static std::optional<std::vector<std::string_view>> split_array(std::string_view data);
+
+    /// Parses the records on the thread pool
+    /// @param records The records, they must outlive the call
+    /// @param pool The thread pool
+    /// @param parse The record parser, invoked concurrently with a record and returning an optional result
+    /// @return The results in record order or std::nullopt if any record fails to parse
+    template<typename Parse>
+    static auto parse(std::span<const std::string_view> records, ThreadPool &pool, Parse &&parse);
+
+    /// Parses JSON Lines data on the thread pool
+    /// @param data The JSON Lines data
+    /// @param pool The thread pool
+    /// @param parse The record parser, invoked concurrently with a record and returning an optional result
+    /// @return The results in line order or std::nullopt if any record fails to parse
+    template<typename Parse>
+    static auto parse_lines(std::string_view data, ThreadPool &pool, Parse &&parse) {
+        auto records = split_lines(data);
+        return JsonRecords::parse(records, pool, std::forward<Parse>(parse));
+    }
+
+    /// Parses the elements of a top-level JSON array on the thread pool
+    /// @param data The stringified JSON array
+    /// @param pool The thread pool
+    /// @param parse The element parser, invoked concurrently with an element and returning an optional result
+    /// @return The results in element order or std::nullopt if the array or any element is malformed
+    template<typename Parse>
+    static auto parse_array(std::string_view data, ThreadPool &pool, Parse &&parse)
+            -> decltype(JsonRecords::parse(std::span<const std::string_view>{}, pool, std::forward<Parse>(parse))) {
+        if (auto records = split_array(data)) {
+            return JsonRecords::parse(*records, pool, std::forward<Parse>(parse));
+        }
+        return std::nullopt;
+    }
+
+private:
+    /// Groups consecutive records into batches of at least BATCH_SIZE bytes
+    /// @param records The records
+    /// @return The index of the first record of every batch followed by the number of records
+    static std::vector<usize> batches(std::span<const std::string_view> records);
+};
+
+/// Parses the records on the thread pool
+template<typename Parse>
+auto JsonRecords::parse(std::span<const std::string_view> records, ThreadPool &pool, Parse &&parse) {
+    using Result = typename std::invoke_result_t<Parse &, std::string_view>::value_type;
+
+    std::vector<std::optional<Result>> results(records.size());
+    std::atomic<bool> failed{ false };
+    auto bounds = batches(records);
+    pool.parallel_for(bounds.size() - 1, [&](usize batch) {
+        for (auto index = bounds[batch]; index < bounds[batch + 1] and not failed; index++) {
+            results[index] = parse(records[index]);
+            if (not results[index]) {
+                failed = true;
+            }
+        }
+    });
+
+    auto output = std::optional<std::vector<Result>>{};
+    if (not failed) {
+        output.emplace();
+        output->reserve(results.size());
+        for (auto &result : results) {
+            output->push_back(std::move(*result));
+        }
+    }
+    return output;
+}
+
+}// namespace rt
+
+#endif// REALTIME_JSON_RECORDS_H
@@ -0,0 +1,371 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Elias Engelbert Plank
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "json_stream.h"
+
+namespace rt {
+
+namespace {
+
+/// Checks whether the character is JSON whitespace
+/// @param c The character
+/// @return A value that indicates whether the character is whitespace
+bool is_whitespace(char c) {
+    return c == ' ' or c == '\t' or c == '\n' or c == '\r';
+}
+
+/// Checks whether the character ends a number or literal
+/// @param c The character
+/// @return A value that indicates whether the character ends a number or literal
+bool is_delimiter(char c) {
+    switch (c) {
+        case ' ':
+        case '\t':
+        case '\n':
+        case '\r':
+        case '{':
+        case '}':
+        case '[':
+        case ']':
+        case ':':
+        case ',':
+        case '"':
+            return true;
+        default:
+            return false;
+    }
+}
+
+}// namespace
+
+/// Creates a new parser that reports the values to the given handler
+JsonStreamParser::JsonStreamParser(JsonHandler &handler)
+    : handler{ handler },
+      stack{},
+      buffer{},
+      scratch{},
+      skip_depth{ 0 },
+      skip_value{ false },
+      key{ false },
+      state{ State::VALUE },
+      status{ Status::PARTIAL } { }
+
+/// Parses the next chunk of the data
+JsonStreamParser::Status JsonStreamParser::feed(std::string_view chunk) {
+    if (status == Status::STOPPED or status == Status::FAILED) {
+        return status;
+    }
+
+    const auto *at = chunk.data();
+    const auto *end = chunk.data() + chunk.size();
+
+    // The part of the current string or scalar that lies within this chunk, earlier parts are buffered
+    const auto *segment = at;
+    while (at and at < end) {
+        switch (state) {
+            case State::STRING: {
+                const auto *stop = at;
+                while (stop < end and *stop != '"' and *stop != '\\') {
+                    stop++;
+                }
+                if (stop == end) {
+                    at = end;
+                } else if (*stop == '\\') {
+                    at = stop + 1;
+                    state = State::ESCAPE;
+                } else {
+                    at = string(pending(segment, stop)) ? stop + 1 : nullptr;
+                }
+                break;
+            }
+            case State::ESCAPE:
+                // The escaped character never ends the string
+                at++;
+                state = State::STRING;
+                break;
+            case State::SCALAR: {
+                const auto *stop = at;
+                while (stop < end and not is_delimiter(*stop)) {
+                    stop++;
+                }
+                if (stop == end) {
+                    at = end;
+                } else {
+                    at = scalar(pending(segment, stop)) ? stop : nullptr;
+                }
+                break;
+            }
+            default:
+                at = structural(at);
+                if (state == State::STRING or state == State::SCALAR) {
+                    buffer.clear();
+                    segment = at;
+                }
+                break;
+        }
+    }
+
+    if (at and (state == State::STRING or state == State::ESCAPE or state == State::SCALAR)) {
+        buffer.append(segment, end);
+    }
+    return status;
+}
+
+/// Retrieves the current string or scalar, which is only copied if it started in an earlier chunk
+std::string_view JsonStreamParser::pending(const char *segment, const char *stop) {
+    if (buffer.empty()) {
+        return { segment, static_cast<usize>(stop - segment) };
+    }
+    buffer.append(segment, stop);
+    return buffer;
+}
+
+/// Signals the end of the data
+JsonStreamParser::Status JsonStreamParser::finish() {
+    if (status == Status::STOPPED or status == Status::FAILED) {
+        return status;
+    }
+    if (state == State::SCALAR and not scalar(buffer)) {
+        return status;
+    }
+    status = state == State::DONE ? Status::DONE : Status::FAILED;
+    return status;
+}
+
+/// Processes a structural or whitespace character
+const char *JsonStreamParser::structural(const char *at) {
+    auto c = *at;
+    if (is_whitespace(c)) {
+        return at + 1;
+    }
+
+    switch (state) {
+        case State::VALUE:
+            return begin(at);
+        case State::FIRST_ELEMENT:
+            if (c == ']') {
+                return close(c) ? at + 1 : nullptr;
+            }
+            return begin(at);
+        case State::FIRST_KEY:
+            if (c == '}') {
+                return close(c) ? at + 1 : nullptr;
+            }
+            [[fallthrough]];
+        case State::KEY:
+            if (c == '"') {
+                key = true;
+                state = State::STRING;
+                return at + 1;
+            }
+            break;
+        case State::COLON:
+            if (c == ':') {
+                state = State::VALUE;
+                return at + 1;
+            }
+            break;
+        case State::NEXT:
+            if (c == ',') {
+                state = stack.back() == '{' ? State::KEY : State::VALUE;
+                return at + 1;
+            }
+            if (c == '}' or c == ']') {
+                return close(c) ? at + 1 : nullptr;
+            }
+            break;
+        default:
+            break;
+    }
+    fail();
+    return nullptr;
+}
+
+/// Begins a value with the given character
+const char *JsonStreamParser::begin(const char *at) {
+    switch (*at) {
+        case '{':
+        case '[':
+            return open(*at) ? at + 1 : nullptr;
+        case '"':
+            key = false;
+            state = State::STRING;
+            return at + 1;
+        case '}':
+        case ']':
+        case ':':
+        case ',':
+            fail();
+            return nullptr;
+        default:
+            // Numbers and literals are validated once they are complete
+            state = State::SCALAR;
+            return at;
+    }
+}
+
+/// Opens an object or array
+bool JsonStreamParser::open(char kind) {
+    stack.push_back(kind);
+    state = kind == '{' ? State::FIRST_KEY : State::FIRST_ELEMENT;
+    if (skip_value) {
+        skip_value = false;
+        skip_depth = stack.size();
+        return true;
+    }
+    if (skipping()) {
+        return true;
+    }
+
+    auto action = kind == '{' ? handler.on_object_begin() : handler.on_array_begin();
+    if (not proceed(action)) {
+        return false;
+    }
+    if (action == JsonHandler::Action::SKIP) {
+        skip_depth = stack.size();
+    }
+    return true;
+}
+
+/// Closes the innermost object or array
+bool JsonStreamParser::close(char kind) {
+    if (stack.empty() or stack.back() != (kind == '}' ? '{' : '[')) {
+        return fail();
+    }
+
+    auto depth = stack.size();
+    stack.pop_back();
+    if (skip_depth == depth) {
+        skip_depth = 0;
+    } else if (not skipping()) {
+        if (not proceed(kind == '}' ? handler.on_object_end() : handler.on_array_end())) {
+            return false;
+        }
+    }
+    complete();
+    return true;
+}
+
+/// Completes a string
+bool JsonStreamParser::string(std::string_view raw) {
+    if (key) {
+        state = State::COLON;
+        if (skipping()) {
+            return true;
+        }
+
+        auto text = decode(raw);
+        if (not text) {
+            return fail();
+        }
+        auto action = handler.on_key(*text);
+        skip_value = action == JsonHandler::Action::SKIP;
+        return proceed(action);
+    }
+
+    if (not skipping()) {
+        auto text = decode(raw);
+        if (not text) {
+            return fail();
+        }
+        if (not proceed(handler.on_string_view(*text))) {
+            return false;
+        }
+    }
+    complete();
+    return true;
+}
+
+/// Completes a number or literal
+bool JsonStreamParser::scalar(std::string_view text) {
+    auto literal = text == "true" or text == "false" or text == "null";
+    if (not literal and detail::number_length(text) != text.size()) {
+        return fail();
+    }
+
+    if (not skipping()) {
+        auto action = JsonHandler::Action::CONTINUE;
+        if (text == "null") {
+            action = handler.on_null();
+        } else if (literal) {
+            action = handler.on_bool(text == "true");
+        } else if (auto number = number_from_view<f64>(text)) {
+            action = handler.on_number(*number);
+        } else {
+            return fail();
+        }
+        if (not proceed(action)) {
+            return false;
+        }
+    }
+    complete();
+    return true;
+}
+
+/// Completes a value and moves on to the next one
+void JsonStreamParser::complete() {
+    skip_value = false;
+    if (stack.empty()) {
+        state = State::DONE;
+        status = Status::DONE;
+    } else {
+        state = State::NEXT;
+    }
+}
+
+/// Checks whether the current value is skipped and not reported to the handler
+bool JsonStreamParser::skipping() const {
+    return skip_depth != 0 or skip_value;
+}
+
+/// Applies the action that was returned by a callback
+bool JsonStreamParser::proceed(JsonHandler::Action action) {
+    if (action == JsonHandler::Action::STOP) {
+        status = Status::STOPPED;
+        return false;
+    }
+    return true;
+}
+
+/// Decodes the escape sequences of a string
+std::optional<std::string_view> JsonStreamParser::decode(std::string_view raw) {
+    if (raw.find('\\') == std::string_view::npos) {
+        return raw;
+    }
+
+    if (scratch.size() < raw.size()) {
+        scratch.resize(raw.size());
+    }
+    if (auto size = detail::unescape(raw, scratch.data())) {
+        return std::string_view{ scratch.data(), *size };
+    }
+    return std::nullopt;
+}
+
+/// Records a failure
+bool JsonStreamParser::fail() {
+    status = Status::FAILED;
+    return false;
+}
+
+}// namespace rt
@@ -0,0 +1,146 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Elias Engelbert Plank
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef REALTIME_JSON_STREAM_H
+#define REALTIME_JSON_STREAM_H
+
+#include <string>
+#include <vector>
+
+#include "json_handler.h"
+
+namespace rt {
+
+/// A resumable JSON parser that is fed the data in arbitrary chunks and reports its values to a handler.
+/// All state, including strings and numbers that are split across chunks, is kept between calls, so the
+/// memory usage is bounded by the nesting depth and the longest split token instead of the data size.
+class JsonStreamParser {
+public:
+    /// The progress of the parser
+    enum class Status {
+        PARTIAL,
+        DONE,
+        STOPPED,
+        FAILED
+    };
+
+    /// Creates a new parser that reports the values to the given handler
+    /// @param handler The handler
+    explicit JsonStreamParser(JsonHandler &handler);
+
+    /// Parses the next chunk of the data
+    /// @param chunk The chunk, it may be released once the call returns
+    /// @return PARTIAL while the document is incomplete, DONE once it is complete, STOPPED if the handler
+    ///         stopped parsing or FAILED if the data is malformed
+    Status feed(std::string_view chunk);
+
+    /// Signals the end of the data, which completes a trailing top-level number or literal
+    /// @return DONE if the document is complete, STOPPED if the handler stopped parsing or FAILED otherwise
+    Status finish();
+
+private:
+    /// The syntactic state between two characters
+    enum class State : u8 {
+        VALUE,
+        FIRST_ELEMENT,
+        FIRST_KEY,
+        KEY,
+        COLON,
+        NEXT,
+        STRING,
+        ESCAPE,
+        SCALAR,
+        DONE
+    };
+
+    /// Retrieves the current string or scalar, which is only copied if it started in an earlier chunk
+    /// @param segment The part of the string or scalar that lies within the current chunk
+    /// @param stop The end of the string or scalar
+    /// @return The string or scalar
+    std::string_view pending(const char *segment, const char *stop);
+
+    /// Processes a structural or whitespace character
+    /// @param at The character
+    /// @return The position after the character or null on failure
+    const char *structural(const char *at);
+
+    /// Begins a value with the given character
+    /// @param at The first character of the value
+    /// @return The position after the character or null on failure
+    const char *begin(const char *at);
+
+    /// Opens an object or array
+    /// @param kind The opening character
+    /// @return A value that indicates success
+    bool open(char kind);
+
+    /// Closes the innermost object or array
+    /// @param kind The closing character
+    /// @return A value that indicates success
+    bool close(char kind);
+
+    /// Completes a string
+    /// @param raw The string without quotes and with escape sequences
+    /// @return A value that indicates success
+    bool string(std::string_view raw);
+
+    /// Completes a number or literal
+    /// @param text The number or literal
+    /// @return A value that indicates success
+    bool scalar(std::string_view text);
+
+    /// Completes a value and moves on to the next one
+    void complete();
+
+    /// Checks whether the current value is skipped and not reported to the handler
+    /// @return A value that indicates whether the current value is skipped
+    bool skipping() const;
+
+    /// Applies the action that was returned by a callback, SKIP skips the value that was announced
+    /// @param action The action
+    /// @return A value that indicates whether parsing continues
+    bool proceed(JsonHandler::Action action);
+
+    /// Decodes the escape sequences of a string
+    /// @param raw The string without quotes and with escape sequences
+    /// @return The decoded string, valid until the next string is decoded, or std::nullopt if it is malformed
+    std::optional<std::string_view> decode(std::string_view raw);
+
+    /// Records a failure
+    /// @return Always false
+    bool fail();
+
+    JsonHandler &handler;
+    std::vector<char> stack;
+    std::string buffer;
+    std::string scratch;
+    usize skip_depth;
+    bool skip_value;
+    bool key;
+    State state;
+    Status status;
+};
+
+}// namespace rt
+
+#endif// REALTIME_JSON_STREAM_H
@@ -0,0 +1,439 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Elias Engelbert Plank
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "json_tape.h"
+
+#include <cstring>
+#include <fstream>
+
+namespace rt {
+
+/// Parses a JSON tape from a string
+std::optional<JsonTape> JsonTape::parse(std::string_view data) {
+    std::vector<u64> entries{};
+    auto parser = detail::JsonTapeParser{ data, entries };
+    if (parser.parse()) {
+        return JsonTape{ data, std::move(entries) };
+    }
+    return std::nullopt;
+}
+
+/// Maps a tape from a cache file that was saved for the given data
+std::optional<JsonTape> JsonTape::load(std::string_view data, const fs::path &path) {
+    auto file = MappedFile::open(path);
+    if (not file or file->size() < sizeof(detail::tape::CacheHeader)) {
+        return std::nullopt;
+    }
+
+    detail::tape::CacheHeader header{};
+    std::memcpy(&header, file->bytes().data(), sizeof(header));
+    auto payload = file->bytes().subspan(sizeof(header));
+    if (header.magic != detail::tape::CACHE_MAGIC or header.version != detail::tape::CACHE_VERSION or
+        header.data_size != data.size() or header.count == 0 or header.count != payload.size() / sizeof(u64) or
+        payload.size() % sizeof(u64) != 0) {
+        return std::nullopt;
+    }
+
+    auto bytes = std::string_view{ reinterpret_cast<const char *>(payload.data()), payload.size() };
+    if (hash_bytes(bytes) != header.checksum or hash_bytes(data) != header.data_hash) {
+        return std::nullopt;
+    }
+
+    // The mapping is page aligned and the header keeps the entries aligned
+    auto mapping = std::make_shared<const MappedFile>(std::move(*file));
+    auto entries = std::span{ reinterpret_cast<const u64 *>(payload.data()), header.count };
+    auto tape = JsonTape{ data, std::move(mapping), entries };
+    if (not tape.consistent()) {
+        return std::nullopt;
+    }
+    return tape;
+}
+
+/// Loads the tape from the cache file or parses the data and saves the tape to the cache file
+std::optional<JsonTape> JsonTape::cached(std::string_view data, const fs::path &path) {
+    if (auto tape = load(data, path)) {
+        return tape;
+    }
+    auto tape = parse(data);
+    if (tape) {
+        // A cache that cannot be written only costs the next start its warm path
+        tape->save(path);
+    }
+    return tape;
+}
+
+/// Saves the tape to a cache file
+bool JsonTape::save(const fs::path &path) const {
+    auto bytes = std::string_view{ reinterpret_cast<const char *>(entries.data()), entries.size_bytes() };
+    auto header = detail::tape::CacheHeader{ detail::tape::CACHE_MAGIC, detail::tape::CACHE_VERSION, data.size(),
+                                             hash_bytes(data), entries.size(), hash_bytes(bytes) };
+
+    auto temporary = path;
+    temporary += ".tmp";
+    {
+        std::ofstream file{ temporary, std::ios::binary | std::ios::trunc };
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        if (not file.good()) {
+            return false;
+        }
+    }
+
+    std::error_code error{};
+    fs::rename(temporary, path, error);
+    if (error) {
+        fs::remove(temporary, error);
+        return false;
+    }
+    return true;
+}
+
+/// Retrieves the root value of the tape
+JsonTape::Value JsonTape::root() const {
+    return Value{ this, 0, static_cast<u32>(entries.size()) };
+}
+
+/// Retrieves the member of the root object with the given key
+JsonTape::Value JsonTape::operator[](std::string_view key) const {
+    return root()[key];
+}
+
+/// Retrieves the number of tape entries
+usize JsonTape::size() const {
+    return entries.size();
+}
+
+/// Copies a tape, copies of a mapped tape share the mapping
+JsonTape::JsonTape(const JsonTape &other)
+    : data{ other.data },
+      storage{ other.storage },
+      mapping{ other.mapping },
+      entries{ mapping ? other.entries : std::span<const u64>{ storage } } { }
+
+/// Copies a tape, copies of a mapped tape share the mapping
+JsonTape &JsonTape::operator=(const JsonTape &other) {
+    if (this != &other) {
+        data = other.data;
+        storage = other.storage;
+        mapping = other.mapping;
+        entries = mapping ? other.entries : std::span<const u64>{ storage };
+    }
+    return *this;
+}
+
+/// Creates a new tape that owns its entries
+JsonTape::JsonTape(std::string_view data, std::vector<u64> &&entries)
+    : data{ data },
+      storage{ std::move(entries) },
+      mapping{},
+      entries{ storage } { }
+
+/// Creates a new tape whose entries live in a mapped cache file
+JsonTape::JsonTape(std::string_view data, std::shared_ptr<const MappedFile> mapping, std::span<const u64> entries)
+    : data{ data },
+      storage{},
+      mapping{ std::move(mapping) },
+      entries{ entries } { }
+
+/// Checks whether every entry stays within the data and the tape
+bool JsonTape::consistent() const {
+    for (usize position = 0; position < entries.size(); position++) {
+        auto entry = entries[position];
+        auto type = entry >> detail::tape::TYPE_SHIFT;
+        auto low = entry & detail::tape::LOW_MASK;
+        if (type == static_cast<u64>(Type::ARRAY) or type == static_cast<u64>(Type::OBJECT)) {
+            // Containers end after themselves and within the tape, the root spans the whole tape
+            if (low <= position or low > entries.size() or (position == 0 and low != entries.size())) {
+                return false;
+            }
+        } else if (type > static_cast<u64>(Type::OBJECT) or
+                   low + ((entry >> detail::tape::SIZE_SHIFT) & detail::tape::SIZE_MASK) > data.size()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// Checks whether the value references a tape entry
+bool JsonTape::Value::valid() const {
+    return owner != nullptr;
+}
+
+/// Checks whether the value references a tape entry
+JsonTape::Value::operator bool() const {
+    return valid();
+}
+
+/// Retrieves the type of the value
+JsonTape::Type JsonTape::Value::type() const {
+    assert(valid() and "[json] Cannot retrieve the type of an invalid value!");
+    return static_cast<Type>(entry() >> detail::tape::TYPE_SHIFT);
+}
+
+/// Converts the value to a number
+std::optional<f64> JsonTape::Value::number() const {
+    if (valid() and type() == Type::NUMBER) {
+        return number_from_view<f64>(lexeme());
+    }
+    return std::nullopt;
+}
+
+/// Converts the value to a boolean
+std::optional<bool> JsonTape::Value::boolean() const {
+    if (valid() and type() == Type::BOOL) {
+        return lexeme().front() == 't';
+    }
+    return std::nullopt;
+}
+
+/// Retrieves the string of the value without decoding escape sequences
+std::optional<std::string_view> JsonTape::Value::raw() const {
+    if (valid() and type() == Type::STRING) {
+        return lexeme();
+    }
+    return std::nullopt;
+}
+
+/// Decodes the string of the value
+std::optional<std::string> JsonTape::Value::string() const {
+    auto text = raw();
+    if (not text) {
+        return std::nullopt;
+    }
+    if (text->find('\\') == std::string_view::npos) {
+        return std::string{ *text };
+    }
+
+    std::string result(text->size(), '\0');
+    if (auto size = detail::unescape(*text, result.data())) {
+        result.resize(*size);
+        return result;
+    }
+    return std::nullopt;
+}
+
+/// Retrieves the number of elements or members of the value
+usize JsonTape::Value::size() const {
+    if (valid() and (type() == Type::ARRAY or type() == Type::OBJECT)) {
+        return (entry() >> detail::tape::SIZE_SHIFT) & detail::tape::SIZE_MASK;
+    }
+    return 0;
+}
+
+/// Retrieves the member with the given key
+JsonTape::Value JsonTape::Value::operator[](std::string_view key) const {
+    if (not valid() or type() != Type::OBJECT) {
+        return {};
+    }
+    for (auto name = first(); name; name = name.next().next()) {
+        auto text = name.lexeme();
+        if (text == key or (text.find('\\') != std::string_view::npos and name.string() == key)) {
+            return name.next();
+        }
+    }
+    return {};
+}
+
+/// Retrieves the element at the given index
+JsonTape::Value JsonTape::Value::operator[](usize index) const {
+    if (not valid() or type() != Type::ARRAY or index >= size()) {
+        return {};
+    }
+    auto element = first();
+    for (; index > 0; index--) {
+        element = element.next();
+    }
+    return element;
+}
+
+/// Retrieves the first element of an array or the first key of an object
+JsonTape::Value JsonTape::Value::first() const {
+    if (size() == 0) {
+        return {};
+    }
+    return Value{ owner, position + 1, static_cast<u32>(entry() & detail::tape::LOW_MASK) };
+}
+
+/// Retrieves the next sibling
+JsonTape::Value JsonTape::Value::next() const {
+    if (not valid()) {
+        return {};
+    }
+
+    // Containers know where they end, every scalar occupies a single entry
+    auto type = this->type();
+    auto after = type == Type::ARRAY or type == Type::OBJECT ? static_cast<u32>(entry() & detail::tape::LOW_MASK)
+                                                             : position + 1;
+    if (after < end) {
+        return Value{ owner, after, end };
+    }
+    return {};
+}
+
+/// Creates a new value
+JsonTape::Value::Value(const JsonTape *owner, u32 position, u32 end) : owner{ owner }, position{ position }, end{ end } { }
+
+/// Retrieves the tape entry of the value
+u64 JsonTape::Value::entry() const {
+    return owner->entries[position];
+}
+
+/// Retrieves the lexeme of a scalar value
+std::string_view JsonTape::Value::lexeme() const {
+    auto offset = entry() & detail::tape::LOW_MASK;
+    auto length = (entry() >> detail::tape::SIZE_SHIFT) & detail::tape::SIZE_MASK;
+    return owner->data.substr(offset, length);
+}
+
+namespace detail {
+
+/// Creates a new parser that appends the tape entries to the given list
+JsonTapeParser::JsonTapeParser(std::string_view data, std::vector<u64> &entries)
+    : data{ data },
+      lexer{ data },
+      token{ lexer.lex() },
+      entries{ entries } { }
+
+/// Parses the data
+bool JsonTapeParser::parse() {
+    if (data.size() > JsonIndexer::MAX_SIZE) {
+        return false;
+    }
+
+    // Most values take up at least eight bytes of their textual representation
+    entries.reserve(data.size() / 8);
+    return value(0) and match(JsonLexer::TokenType::END);
+}
+
+/// Tries to parse a JSON value
+bool JsonTapeParser::value(usize depth) {
+    switch (token.type) {
+        case JsonLexer::TokenType::LEFT_BRACE:
+            return depth < JsonLexer::MAX_DEPTH and object(depth + 1);
+        case JsonLexer::TokenType::LEFT_BRACKET:
+            return depth < JsonLexer::MAX_DEPTH and array(depth + 1);
+        case JsonLexer::TokenType::STRING:
+            return scalar(JsonTape::Type::STRING);
+        case JsonLexer::TokenType::NUMBER:
+            return scalar(JsonTape::Type::NUMBER);
+        case JsonLexer::TokenType::TRUE:
+        case JsonLexer::TokenType::FALSE:
+            return scalar(JsonTape::Type::BOOL);
+        case JsonLexer::TokenType::NIL:
+            return scalar(JsonTape::Type::NIL);
+        default:
+            return false;
+    }
+}
+
+/// Tries to parse the members of a JSON object whose opening brace is the current token
+bool JsonTapeParser::object(usize depth) {
+    auto at = open();
+    advance();
+
+    usize count = 0;
+    while (not consume(JsonLexer::TokenType::RIGHT_BRACE)) {
+        if (not match(JsonLexer::TokenType::STRING) or not scalar(JsonTape::Type::STRING)) {
+            return false;
+        }
+        if (not consume(JsonLexer::TokenType::COLON) or not value(depth)) {
+            return false;
+        }
+        count++;
+
+        if (not match(JsonLexer::TokenType::RIGHT_BRACE) and not consume(JsonLexer::TokenType::COMMA)) {
+            return false;
+        }
+    }
+    return close(at, JsonTape::Type::OBJECT, count);
+}
+
+/// Tries to parse the elements of a JSON array whose opening bracket is the current token
+bool JsonTapeParser::array(usize depth) {
+    auto at = open();
+    advance();
+
+    usize count = 0;
+    while (not consume(JsonLexer::TokenType::RIGHT_BRACKET)) {
+        if (not value(depth)) {
+            return false;
+        }
+        count++;
+
+        if (not match(JsonLexer::TokenType::RIGHT_BRACKET) and not consume(JsonLexer::TokenType::COMMA)) {
+            return false;
+        }
+    }
+    return close(at, JsonTape::Type::ARRAY, count);
+}
+
+/// Appends the entry of the current scalar token
+bool JsonTapeParser::scalar(JsonTape::Type type) {
+    auto offset = static_cast<u64>(token.lexeme.data() - data.data());
+    auto length = static_cast<u64>(token.lexeme.size());
+    if (length > tape::SIZE_MASK) {
+        return false;
+    }
+    entries.push_back(static_cast<u64>(type) << tape::TYPE_SHIFT | length << tape::SIZE_SHIFT | offset);
+    advance();
+    return true;
+}
+
+/// Appends a placeholder entry for a container
+usize JsonTapeParser::open() {
+    entries.push_back(0);
+    return entries.size() - 1;
+}
+
+/// Completes the entry of a container
+bool JsonTapeParser::close(usize at, JsonTape::Type type, usize count) {
+    if (count > tape::SIZE_MASK or entries.size() > tape::LOW_MASK) {
+        return false;
+    }
+    entries[at] = static_cast<u64>(type) << tape::TYPE_SHIFT | static_cast<u64>(count) << tape::SIZE_SHIFT |
+                  static_cast<u64>(entries.size());
+    return true;
+}
+
+/// Advances the cursor by one token
+void JsonTapeParser::advance() {
+    token = lexer.lex();
+}
+
+/// Tries to consume a token
+bool JsonTapeParser::consume(JsonLexer::TokenType type) {
+    if (match(type)) {
+        advance();
+        return true;
+    }
+    return false;
+}
+
+/// Tries to match the current token type
+bool JsonTapeParser::match(JsonLexer::TokenType type) const {
+    return token.type == type;
+}
+
+}// namespace detail
+
+}// namespace rt
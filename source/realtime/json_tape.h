@@ -0,0 +1,299 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Elias Engelbert Plank
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef REALTIME_JSON_TAPE_H
+#define REALTIME_JSON_TAPE_H
+
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "json.h"
+#include "mapped_file.h"
+
+namespace rt {
+
+namespace detail {
+class JsonTapeParser;
+}
+
+/// A lazily decoded JSON document. Parsing validates the data and records every value as a single
+/// 64-bit tape entry that references the data, containers additionally store where they end. Lookups
+/// jump over siblings instead of decoding them, numbers and strings are only converted when accessed.
+/// The data must outlive the tape. A tape can be saved to a binary cache file and mapped back in later, which
+/// skips lexing and parsing entirely.
+class JsonTape {
+public:
+    enum class Type : u8 {
+        NIL,
+        BOOL,
+        NUMBER,
+        STRING,
+        ARRAY,
+        OBJECT
+    };
+
+    class Value;
+
+    /// A tape may be copied or moved, copies of a mapped tape share the mapping
+    JsonTape(const JsonTape &other);
+    JsonTape &operator=(const JsonTape &other);
+    JsonTape(JsonTape &&) = default;
+    JsonTape &operator=(JsonTape &&) = default;
+
+    /// Parses a JSON tape from a string. Objects and arrays may be nested at most
+    /// detail::JsonLexer::MAX_DEPTH levels deep.
+    /// @param data The string
+    /// @return An optional JSON tape
+    static std::optional<JsonTape> parse(std::string_view data);
+
+    /// Maps a tape from a cache file that was saved for the given data. The header must match the size and
+    /// content hash of the data, the checksum must match the entries and every entry must stay within the
+    /// data and the tape, so a stale or damaged cache is rejected instead of being trusted.
+    /// @param data The string the tape was parsed from
+    /// @param path The path to the cache file
+    /// @return The mapped tape or std::nullopt if the cache is missing, stale or damaged
+    static std::optional<JsonTape> load(std::string_view data, const fs::path &path);
+
+    /// Loads the tape from the cache file or parses the data and saves the tape to the cache file, which
+    /// usually lives next to the source, e.g. `scene.gltf.tape`
+    /// @param data The string
+    /// @param path The path to the cache file
+    /// @return An optional JSON tape
+    static std::optional<JsonTape> cached(std::string_view data, const fs::path &path);
+
+    /// Saves the tape to a cache file, which is written to a temporary file first and then renamed, so
+    /// concurrent readers never observe a partial cache
+    /// @param path The path to the cache file
+    /// @return A value that indicates whether the cache file was written
+    bool save(const fs::path &path) const;
+
+    /// Retrieves the root value of the tape
+    /// @return The root value
+    Value root() const;
+
+    /// Retrieves the member of the root object with the given key
+    /// @param key The key
+    /// @return The value, invalid if the root is not an object or has no such member
+    Value operator[](std::string_view key) const;
+
+    /// Retrieves the number of tape entries, one per value
+    /// @return The number of tape entries
+    usize size() const;
+
+private:
+    /// Creates a new tape that owns its entries
+    /// @param data The data that is referenced by the tape
+    /// @param entries The tape entries
+    JsonTape(std::string_view data, std::vector<u64> &&entries);
+
+    /// Creates a new tape whose entries live in a mapped cache file
+    /// @param data The data that is referenced by the tape
+    /// @param mapping The mapped cache file
+    /// @param entries The tape entries inside of the mapping
+    JsonTape(std::string_view data, std::shared_ptr<const MappedFile> mapping, std::span<const u64> entries);
+
+    /// Checks whether every entry stays within the data and the tape
+    /// @return A value that indicates whether the entries are consistent
+    bool consistent() const;
+
+    std::string_view data;
+    std::vector<u64> storage;
+    std::shared_ptr<const MappedFile> mapping;
+    std::span<const u64> entries;
+};
+
+/// A lightweight reference to a value of a tape. Navigating to a missing member or element yields an
+/// invalid value, so lookups can be chained and checked once at the end.
+class JsonTape::Value {
+public:
+    /// Creates an invalid value
+    Value() = default;
+
+    /// Checks whether the value references a tape entry
+    /// @return A value that indicates whether the value is valid
+    bool valid() const;
+
+    /// Checks whether the value references a tape entry
+    explicit operator bool() const;
+
+    /// Retrieves the type of the value, which must be valid
+    /// @return The type
+    Type type() const;
+
+    /// Converts the value to a number
+    /// @return The number or std::nullopt if the value is not a number
+    std::optional<f64> number() const;
+
+    /// Converts the value to a boolean
+    /// @return The boolean or std::nullopt if the value is not a boolean
+    std::optional<bool> boolean() const;
+
+    /// Retrieves the string of the value without decoding escape sequences
+    /// @return The raw string or std::nullopt if the value is not a string
+    std::optional<std::string_view> raw() const;
+
+    /// Decodes the string of the value
+    /// @return The UTF-8 string or std::nullopt if the value is not a string
+    std::optional<std::string> string() const;
+
+    /// Retrieves the number of elements or members of the value
+    /// @return The number of elements or members, zero for scalar values
+    usize size() const;
+
+    /// Retrieves the member with the given key
+    /// @param key The key
+    /// @return The value, invalid if this is not an object or has no such member
+    Value operator[](std::string_view key) const;
+
+    /// Retrieves the element at the given index
+    /// @param index The index
+    /// @return The element, invalid if this is not an array or the index is out of bounds
+    Value operator[](usize index) const;
+
+    /// Retrieves the first element of an array or the first key of an object
+    /// @return The first child, invalid if there is none
+    Value first() const;
+
+    /// Retrieves the next sibling, inside of objects keys and values alternate
+    /// @return The next sibling, invalid if this is the last child of its parent
+    Value next() const;
+
+private:
+    friend class JsonTape;
+
+    /// Creates a new value
+    /// @param owner The tape
+    /// @param position The index of the tape entry
+    /// @param end The index past the last child of the parent
+    Value(const JsonTape *owner, u32 position, u32 end);
+
+    /// Retrieves the tape entry of the value
+    /// @return The tape entry
+    u64 entry() const;
+
+    /// Retrieves the lexeme of a scalar value
+    /// @return The lexeme
+    std::string_view lexeme() const;
+
+    const JsonTape *owner = nullptr;
+    u32 position = 0;
+    u32 end = 0;
+};
+
+namespace detail {
+
+/// The layout of a tape entry, the type is stored in the upper four bits. Containers store their number
+/// of children and the index past their last descendant, scalars store the length and offset of their
+/// lexeme, strings without quotes.
+namespace tape {
+
+constexpr u64 TYPE_SHIFT = 60;
+constexpr u64 SIZE_SHIFT = 32;
+constexpr u64 SIZE_MASK = (u64{ 1 } << (TYPE_SHIFT - SIZE_SHIFT)) - 1;
+constexpr u64 LOW_MASK = (u64{ 1 } << SIZE_SHIFT) - 1;
+
+/// The header of a cache file, the tape entries follow right after it
+struct CacheHeader {
+    u32 magic;
+    u32 version;
+    u64 data_size;
+    u64 data_hash;
+    u64 count;
+    u64 checksum;
+};
+
+constexpr u32 CACHE_MAGIC = 0x45504154;// "TAPE"
+constexpr u32 CACHE_VERSION = 1;
+static_assert(sizeof(CacheHeader) % alignof(u64) == 0, "[json] Cached entries must stay aligned!");
+
+}// namespace tape
+
+class JsonTapeParser {
+public:
+    /// Creates a new parser that appends the tape entries to the given list
+    /// @param data The stringified JSON data
+    /// @param entries The list of tape entries
+    JsonTapeParser(std::string_view data, std::vector<u64> &entries);
+
+    /// Parses the data
+    /// @return A value that indicates whether the data is well-formed and fits the tape layout
+    bool parse();
+
+private:
+    /// Tries to parse a JSON value
+    /// @param depth The number of objects and arrays that enclose the value
+    /// @return A value that indicates success, false if the value is nested deeper than JsonLexer::MAX_DEPTH
+    bool value(usize depth);
+
+    /// Tries to parse the members of a JSON object whose opening brace is the current token
+    /// @param depth The number of objects and arrays that enclose the members
+    /// @return A value that indicates success
+    bool object(usize depth);
+
+    /// Tries to parse the elements of a JSON array whose opening bracket is the current token
+    /// @param depth The number of objects and arrays that enclose the elements
+    /// @return A value that indicates success
+    bool array(usize depth);
+
+    /// Appends the entry of the current scalar token
+    /// @param type The type of the scalar
+    /// @return A value that indicates whether the lexeme fits the tape layout
+    bool scalar(JsonTape::Type type);
+
+    /// Appends a placeholder entry for a container, which is completed once the container is closed
+    /// @return The index of the entry
+    usize open();
+
+    /// Completes the entry of a container
+    /// @param at The index of the entry
+    /// @param type The type of the container
+    /// @param count The number of children
+    /// @return A value that indicates whether the container fits the tape layout
+    bool close(usize at, JsonTape::Type type, usize count);
+
+    /// Advances the cursor by one token
+    void advance();
+
+    /// Tries to consume a token
+    /// @param type The token type
+    /// @return A value that indicates whether the token was consumed
+    bool consume(JsonLexer::TokenType type);
+
+    /// Tries to match the current token type
+    /// @param type The token type
+    /// @return A value that indicates whether the current token type matches
+    bool match(JsonLexer::TokenType type) const;
+
+    std::string_view data;
+    JsonLexer lexer;
+    JsonLexer::Token token;
+    std::vector<u64> &entries;
+};
+
+}// namespace detail
+
+}// namespace rt
+
+#endif// REALTIME_JSON_TAPE_H
@@ -0,0 +1,329 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Elias Engelbert Plank
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <bit>
+#include <charconv>
+#include <cmath>
+
+#include "cpu.h"
+#include "json_writer.h"
+
+#if REALTIME_X86
+#include <immintrin.h>
+#endif
+
+namespace rt {
+
+namespace {
+
+/// Checks whether a character has to be escaped inside of a JSON string
+/// @param c The character
+/// @return A value that indicates whether the character has to be escaped
+bool needs_escape(char c) {
+    return c == '"' or c == '\\' or static_cast<u8>(c) < 0x20;
+}
+
+/// Measures the prefix of a string that can be written without escaping, one byte at a time
+/// @param string The string
+/// @return The length of the prefix
+usize unescaped_prefix_scalar(std::string_view string) {
+    usize length = 0;
+    while (length < string.size() and not needs_escape(string[length])) {
+        length++;
+    }
+    return length;
+}
+
+#if REALTIME_X86
+
+/// Measures the prefix of a string that can be written without escaping, 16 bytes at a time
+/// @param string The string
+/// @return The length of the prefix
+REALTIME_TARGET("sse2") usize unescaped_prefix_sse2(std::string_view string) {
+    auto quote = _mm_set1_epi8('"');
+    auto backslash = _mm_set1_epi8('\\');
+    auto control = _mm_set1_epi8(0x1F);
+
+    usize offset = 0;
+    for (; offset + 16 <= string.size(); offset += 16) {
+        auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(string.data() + offset));
+
+        // Control characters are the bytes that are not larger than 0x1F when compared unsigned
+        auto special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)),
+                                    _mm_cmpeq_epi8(_mm_min_epu8(chunk, control), chunk));
+        if (auto mask = static_cast<u32>(_mm_movemask_epi8(special))) {
+            return offset + static_cast<usize>(std::countr_zero(mask));
+        }
+    }
+    return offset + unescaped_prefix_scalar(string.substr(offset));
+}
+
+#endif
+
+}// namespace
+
+/// Creates a new writer
+JsonWriter::JsonWriter(Style style, usize indent)
+    : out{},
+      scratch{},
+      style{ style },
+      indent{ indent },
+      depth{ 0 },
+      first{ true },
+      after_key{ false } { }
+
+/// Serializes a JSON object
+std::string JsonWriter::serialize(const Json &json, Style style) {
+    auto writer = JsonWriter{ style };
+    writer.write(json);
+    return writer.take();
+}
+
+/// Writes a JSON object
+void JsonWriter::write(const Json &json) {
+    on_object_begin();
+    for (auto it = json.cbegin(); it != json.cend(); ++it) {
+        scratch.clear();
+        for (auto codepoint : it->first) {
+            char bytes[4];
+            scratch.append(bytes, utf8_encode(codepoint, bytes));
+        }
+        on_key(scratch);
+        write(it->second);
+    }
+    on_object_end();
+}
+
+/// Writes a JSON value
+void JsonWriter::write(const Json::Value &value) {
+    if (const auto *string = value.as<Json::String>()) {
+        scratch.clear();
+        for (auto codepoint : *string) {
+            char bytes[4];
+            scratch.append(bytes, utf8_encode(codepoint, bytes));
+        }
+        on_string_view(scratch);
+    } else if (auto number = value.as<Json::Number>()) {
+        on_number(*number);
+    } else if (auto boolean = value.as<Json::Bool>()) {
+        on_bool(*boolean);
+    } else if (const auto *json = value.as<Json>()) {
+        write(*json);
+    } else if (const auto *array = value.as<Json::Array>()) {
+        on_array_begin();
+        for (auto it = array->cbegin(); it != array->cend(); ++it) {
+            write(*it);
+        }
+        on_array_end();
+    } else {
+        on_null();
+    }
+}
+
+/// Retrieves the output that has been written so far
+const std::string &JsonWriter::output() const {
+    return out;
+}
+
+/// Moves the output out of the writer and resets it
+std::string JsonWriter::take() {
+    auto result = std::move(out);
+    out.clear();
+    depth = 0;
+    first = true;
+    after_key = false;
+    return result;
+}
+
+/// Writes the beginning of an object
+JsonHandler::Action JsonWriter::on_object_begin() {
+    open('{');
+    return Action::CONTINUE;
+}
+
+/// Writes the end of an object
+JsonHandler::Action JsonWriter::on_object_end() {
+    close('}');
+    return Action::CONTINUE;
+}
+
+/// Writes the beginning of an array
+JsonHandler::Action JsonWriter::on_array_begin() {
+    open('[');
+    return Action::CONTINUE;
+}
+
+/// Writes the end of an array
+JsonHandler::Action JsonWriter::on_array_end() {
+    close(']');
+    return Action::CONTINUE;
+}
+
+/// Writes the key of an object member
+JsonHandler::Action JsonWriter::on_key(std::string_view key) {
+    separate();
+    quote(key);
+    out += style == Style::PRETTY ? ": " : ":";
+    after_key = true;
+    return Action::CONTINUE;
+}
+
+/// Writes a string value
+JsonHandler::Action JsonWriter::on_string_view(std::string_view string) {
+    separate();
+    quote(string);
+    return Action::CONTINUE;
+}
+
+/// Writes a number value, JSON cannot represent infinities and NaN so they are written as null
+JsonHandler::Action JsonWriter::on_number(f64 number) {
+    separate();
+    if (not std::isfinite(number)) {
+        out += "null";
+        return Action::CONTINUE;
+    }
+
+    char buffer[32];
+    auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), number);
+    out.append(buffer, end);
+    return Action::CONTINUE;
+}
+
+/// Writes a boolean value
+JsonHandler::Action JsonWriter::on_bool(bool boolean) {
+    separate();
+    out += boolean ? "true" : "false";
+    return Action::CONTINUE;
+}
+
+/// Writes a null value
+JsonHandler::Action JsonWriter::on_null() {
+    separate();
+    out += "null";
+    return Action::CONTINUE;
+}
+
+/// Writes the separator and indentation that precede a value or key
+void JsonWriter::separate() {
+    if (after_key) {
+        after_key = false;
+        return;
+    }
+    if (depth > 0) {
+        if (not first) {
+            out += ',';
+        }
+        if (style == Style::PRETTY) {
+            newline();
+        }
+    }
+    first = false;
+}
+
+/// Opens an object or array
+void JsonWriter::open(char bracket) {
+    separate();
+    out += bracket;
+    depth++;
+    first = true;
+}
+
+/// Closes the innermost object or array
+void JsonWriter::close(char bracket) {
+    depth--;
+    if (not first and style == Style::PRETTY) {
+        newline();
+    }
+    out += bracket;
+    first = false;
+}
+
+/// Writes a quoted and escaped string
+void JsonWriter::quote(std::string_view string) {
+    constexpr char HEX[] = "0123456789abcdef";
+
+    out.reserve(out.size() + string.size() + 2);
+    out += '"';
+    while (true) {
+        auto length = detail::json_unescaped_prefix(string);
+        out.append(string.data(), length);
+        string.remove_prefix(length);
+        if (string.empty()) {
+            break;
+        }
+
+        auto c = string.front();
+        string.remove_prefix(1);
+        switch (c) {
+            case '"':
+                out += "\\\"";
+                break;
+            case '\\':
+                out += "\\\\";
+                break;
+            case '\b':
+                out += "\\b";
+                break;
+            case '\f':
+                out += "\\f";
+                break;
+            case '\n':
+                out += "\\n";
+                break;
+            case '\r':
+                out += "\\r";
+                break;
+            case '\t':
+                out += "\\t";
+                break;
+            default:
+                out += "\\u00";
+                out += HEX[static_cast<u8>(c) >> 4];
+                out += HEX[static_cast<u8>(c) & 0xF];
+                break;
+        }
+    }
+    out += '"';
+}
+
+/// Writes a new line followed by the indentation of the current nesting level
+void JsonWriter::newline() {
+    out += '\n';
+    out.append(depth * indent, ' ');
+}
+
+namespace detail {
+
+/// Measures the prefix of a string that can be written to JSON without escaping
+usize json_unescaped_prefix(std::string_view string) {
+#if REALTIME_X86
+    static const auto scan = cpu_features().sse2 ? unescaped_prefix_sse2 : unescaped_prefix_scalar;
+    return scan(string);
+#else
+    return unescaped_prefix_scalar(string);
+#endif
+}
+
+}// namespace detail
+
+}// namespace rt
@@ -0,0 +1,138 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Elias Engelbert Plank
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef REALTIME_JSON_WRITER_H
+#define REALTIME_JSON_WRITER_H
+
+#include <string>
+#include <vector>
+
+#include "json_handler.h"
+
+namespace rt {
+
+/// Serializes JSON into a growable buffer. Values are either written from a Json object or pushed as
+/// events through the JsonHandler interface, so parsing data with a writer re-serializes it. Numbers use
+/// the shortest representation that reads back to the same double.
+class JsonWriter final : public JsonHandler {
+public:
+    /// The layout of the output
+    enum class Style {
+        COMPACT,
+        PRETTY
+    };
+
+    /// Creates a new writer
+    /// @param style The layout of the output
+    /// @param indent The number of spaces per nesting level in pretty mode
+    explicit JsonWriter(Style style = Style::COMPACT, usize indent = 4);
+
+    /// Serializes a JSON object
+    /// @param json The JSON object
+    /// @param style The layout of the output
+    /// @return The serialized JSON
+    static std::string serialize(const Json &json, Style style = Style::COMPACT);
+
+    /// Writes a JSON object
+    /// @param json The JSON object
+    void write(const Json &json);
+
+    /// Writes a JSON value
+    /// @param value The JSON value
+    void write(const Json::Value &value);
+
+    /// Retrieves the output that has been written so far
+    /// @return The output
+    const std::string &output() const;
+
+    /// Moves the output out of the writer and resets it
+    /// @return The output
+    std::string take();
+
+    /// Writes the beginning of an object
+    Action on_object_begin() override;
+
+    /// Writes the end of an object
+    Action on_object_end() override;
+
+    /// Writes the beginning of an array
+    Action on_array_begin() override;
+
+    /// Writes the end of an array
+    Action on_array_end() override;
+
+    /// Writes the key of an object member
+    Action on_key(std::string_view key) override;
+
+    /// Writes a string value
+    Action on_string_view(std::string_view string) override;
+
+    /// Writes a number value, JSON cannot represent infinities and NaN so they are written as null
+    Action on_number(f64 number) override;
+
+    /// Writes a boolean value
+    Action on_bool(bool boolean) override;
+
+    /// Writes a null value
+    Action on_null() override;
+
+private:
+    /// Writes the separator and indentation that precede a value or key
+    void separate();
+
+    /// Opens an object or array
+    /// @param bracket The opening bracket
+    void open(char bracket);
+
+    /// Closes the innermost object or array
+    /// @param bracket The closing bracket
+    void close(char bracket);
+
+    /// Writes a quoted and escaped string
+    /// @param string The UTF-8 string
+    void quote(std::string_view string);
+
+    /// Writes a new line followed by the indentation of the current nesting level
+    void newline();
+
+    std::string out;
+    std::string scratch;
+    Style style;
+    usize indent;
+    usize depth;
+    bool first;
+    bool after_key;
+};
+
+namespace detail {
+
+/// Measures the prefix of a string that can be written to JSON without escaping
+/// @param string The string
+/// @return The length of the prefix
+usize json_unescaped_prefix(std::string_view string);
+
+}// namespace detail
+
+}// namespace rt
+
+#endif// REALTIME_JSON_WRITER_H
@@ -0,0 +1,152 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Elias Engelbert Plank
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "mapped_file.h"
+
+#include <utility>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace rt {
+
+/// Maps the file at the given path
+std::optional<MappedFile> MappedFile::open(const fs::path &path) {
+#if defined(_WIN32)
+    auto file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return std::nullopt;
+    }
+
+    LARGE_INTEGER size{};
+    if (not GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        return std::nullopt;
+    }
+    if (size.QuadPart == 0) {
+        CloseHandle(file);
+        return MappedFile{ nullptr, 0 };
+    }
+
+    // The view keeps the mapping alive, so neither handle is needed afterwards
+    auto mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (mapping == nullptr) {
+        return std::nullopt;
+    }
+    auto *data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (data == nullptr) {
+        return std::nullopt;
+    }
+    return MappedFile{ static_cast<const u8 *>(data), static_cast<usize>(size.QuadPart) };
+#else
+    auto file = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (file < 0) {
+        return std::nullopt;
+    }
+
+    struct stat status {};
+    if (fstat(file, &status) != 0 or not S_ISREG(status.st_mode)) {
+        close(file);
+        return std::nullopt;
+    }
+    if (status.st_size == 0) {
+        close(file);
+        return MappedFile{ nullptr, 0 };
+    }
+
+    // The mapping keeps the file alive, so the descriptor is not needed afterwards
+    auto size = static_cast<usize>(status.st_size);
+    auto *data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+    close(file);
+    if (data == MAP_FAILED) {
+        return std::nullopt;
+    }
+    return MappedFile{ static_cast<const u8 *>(data), size };
+#endif
+}
+
+/// Unmaps the file
+MappedFile::~MappedFile() {
+    unmap();
+}
+
+/// Moves a mapped file
+MappedFile::MappedFile(MappedFile &&other) noexcept
+    : data{ std::exchange(other.data, nullptr) },
+      length{ std::exchange(other.length, 0) } { }
+
+/// Moves a mapped file
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept {
+    if (this != &other) {
+        unmap();
+        data = std::exchange(other.data, nullptr);
+        length = std::exchange(other.length, 0);
+    }
+    return *this;
+}
+
+/// Retrieves the bytes of the file
+std::span<const u8> MappedFile::bytes() const {
+    return { data, length };
+}
+
+/// Retrieves the contents of the file as text
+std::string_view MappedFile::view() const {
+    return { reinterpret_cast<const char *>(data), length };
+}
+
+/// Retrieves the size of the file
+usize MappedFile::size() const {
+    return length;
+}
+
+/// Creates a new mapped file
+MappedFile::MappedFile(const u8 *data, usize length) : data{ data }, length{ length } { }
+
+/// Unmaps the file
+void MappedFile::unmap() {
+    if (data == nullptr) {
+        return;
+    }
+#if defined(_WIN32)
+    UnmapViewOfFile(data);
+#else
+    munmap(const_cast<u8 *>(data), length);
+#endif
+    data = nullptr;
+    length = 0;
+}
+
+}// namespace rt
@@ -0,0 +1,80 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Elias Engelbert Plank
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef REALTIME_MAPPED_FILE_H
+#define REALTIME_MAPPED_FILE_H
+
+#include <span>
+#include <string_view>
+
+#include "utility.h"
+
+namespace rt {
+
+/// A read-only memory mapping of a whole file. The pages are loaded by the operating system on first
+/// access and shared with its page cache, so opening a large file costs neither a read nor a copy.
+class MappedFile {
+public:
+    /// Maps the file at the given path
+    /// @param path The path to the file
+    /// @return The mapped file or std::nullopt if the file cannot be opened or mapped
+    static std::optional<MappedFile> open(const fs::path &path);
+
+    /// Unmaps the file
+    ~MappedFile();
+
+    /// A mapped file cannot be copied, allow move
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+    MappedFile(MappedFile &&other) noexcept;
+    MappedFile &operator=(MappedFile &&other) noexcept;
+
+    /// Retrieves the bytes of the file
+    /// @return The bytes of the file
+    std::span<const u8> bytes() const;
+
+    /// Retrieves the contents of the file as text
+    /// @return The contents of the file
+    std::string_view view() const;
+
+    /// Retrieves the size of the file
+    /// @return The size of the file in bytes
+    usize size() const;
+
+private:
+    /// Creates a new mapped file
+    /// @param data The first byte of the mapping, nullptr for empty files
+    /// @param length The size of the mapping in bytes
+    MappedFile(const u8 *data, usize length);
+
+    /// Unmaps the file
+    void unmap();
+
+    const u8 *data;
+    usize length;
+};
+
+}// namespace rt
+
+#endif// REALTIME_MAPPED_FILE_H
@@ -31,7 +31,10 @@
 
 #include <array>
 #include <cstring>
+#include <limits>
+#include <numeric>
 #include <unordered_map>
+#include "gltf_accessor.h"
 #include "mesh.h"
 #include "tinyobjloader.h"
 
@@ -116,9 +119,302 @@ void Mesh::Builder::from_wavefront(const fs::path &path) {
     }
 }
 
+namespace {
+
+/// The views of the accessors of a triangle primitive
+struct PrimitiveViews {
+    gltf::AccessorView positions;
+    std::optional<gltf::AccessorView> colors;
+    std::optional<gltf::AccessorView> normals;
+    std::optional<gltf::AccessorView> uvs;
+    std::optional<gltf::AccessorView> indices;
+    gltf::Primitive::Mode mode;
+
+    /// Retrieves the number of indices as stored, primitives without indices are indexed sequentially
+    /// @return The number of stored indices
+    u32 stored_index_count() const {
+        return indices ? indices->count : positions.count;
+    }
+
+    /// Retrieves the number of indices of the triangle list, into which strips and fans are converted
+    /// @return The number of indices
+    u64 index_count() const {
+        u64 count = stored_index_count();
+        if (mode == gltf::Primitive::Mode::TRIANGLES) {
+            return count;
+        }
+        return count < 3 ? 0 : (count - 2) * 3;
+    }
+};
+
+/// Resolves the data of every buffer view of a glTF file
+/// @param file The glTF file
+/// @param storage The storage of the decoded buffer views
+/// @return The data of every buffer view or std::nullopt if any buffer view is malformed
+std::optional<std::vector<std::span<const u8>>> resolve_views(const GltfFile &file,
+                                                              std::vector<std::vector<u8>> &storage) {
+    return gltf::resolve_views(file.document, file.buffers, storage);
+}
+
+/// Checks whether a primitive is made of triangles. Points and lines are not drawn, and neither are primitives
+/// without positions, whose rendering the glTF specification leaves to the client.
+/// @param primitive The primitive
+/// @return A value that indicates whether the primitive is a triangle list, strip or fan with positions
+bool has_triangles(const gltf::Primitive &primitive) {
+    using Mode = gltf::Primitive::Mode;
+    auto mode = primitive.mode;
+    return primitive.attributes.position and
+           (mode == Mode::TRIANGLES or mode == Mode::TRIANGLE_STRIP or mode == Mode::TRIANGLE_FAN);
+}
+
+/// Creates the views of the accessors of a triangle primitive
+/// @param document The glTF document
+/// @param buffer_views The data of every buffer view of the document
+/// @param primitive The primitive
+/// @return The views or std::nullopt if the primitive has no triangles or any accessor is malformed
+std::optional<PrimitiveViews> prepare(const gltf::Document &document,
+                                      std::span<const std::span<const u8>> buffer_views,
+                                      const gltf::Primitive &primitive) {
+    if (not has_triangles(primitive)) {
+        return std::nullopt;
+    }
+    auto positions = gltf::AccessorView::create(document, buffer_views, *primitive.attributes.position);
+    if (not positions) {
+        return std::nullopt;
+    }
+
+    // Every attribute must provide exactly one element per vertex
+    auto views = PrimitiveViews{ *positions, {}, {}, {}, {}, primitive.mode };
+    auto attribute = [&](std::optional<u32> accessor, std::optional<gltf::AccessorView> &view) {
+        if (not accessor) {
+            return true;
+        }
+        view = gltf::AccessorView::create(document, buffer_views, *accessor);
+        return view and view->count == positions->count;
+    };
+    if (not attribute(primitive.attributes.color_0, views.colors) or
+        not attribute(primitive.attributes.normal, views.normals) or
+        not attribute(primitive.attributes.texcoord_0, views.uvs)) {
+        return std::nullopt;
+    }
+    if (primitive.indices) {
+        views.indices = gltf::AccessorView::create(document, buffer_views, *primitive.indices);
+        if (not views.indices) {
+            return std::nullopt;
+        }
+    }
+    return views;
+}
+
+/// Reads the indices of a primitive as they are stored
+/// @param views The views of the primitive
+/// @param out The indices, must hold every stored index
+/// @param base The number of vertices of earlier primitives, which is added to every index
+/// @return A value that indicates whether every index refers to a vertex of the primitive
+bool read_indices(const PrimitiveViews &views, u32 *out, u32 base) {
+    auto count = views.positions.count;
+    if (views.indices) {
+        return views.indices->read_indices(out, base, count);
+    }
+    std::iota(out, out + count, base);
+    return true;
+}
+
+/// Converts the indices of a triangle strip or fan into those of a triangle list
+/// @param mode The mode of the primitive, either TRIANGLE_STRIP or TRIANGLE_FAN
+/// @param source The indices of the strip or fan
+/// @param out The indices of the list, three per triangle
+void triangulate(gltf::Primitive::Mode mode, std::span<const u32> source, u32 *out) {
+    for (usize triangle = 0; triangle + 2 < source.size(); triangle++, out += 3) {
+        if (mode == gltf::Primitive::Mode::TRIANGLE_FAN) {
+            out[0] = source[triangle + 1];
+            out[1] = source[triangle + 2];
+            out[2] = source[0];
+        } else {
+            // Every other triangle of a strip swaps two of its vertices to keep the winding order
+            auto odd = triangle % 2;
+            out[0] = source[triangle];
+            out[1] = source[triangle + 1 + odd];
+            out[2] = source[triangle + 2 - odd];
+        }
+    }
+}
+
+/// Decodes a primitive into vertices and indices. Both are only ever written, never read, as they may be
+/// mapped device memory, so every field is written even if the primitive lacks the attribute.
+/// @param views The views of the primitive
+/// @param vertices The vertices of the primitive
+/// @param indices The indices of the primitive as triangle list
+/// @param base The number of vertices of earlier primitives, which is added to every index
+/// @return A value that indicates whether every index refers to a vertex of the primitive
+bool decode(const PrimitiveViews &views, Mesh::Vertex *vertices, u32 *indices, u32 base) {
+    auto count = views.positions.count;
+    if (views.mode == gltf::Primitive::Mode::TRIANGLES) {
+        if (not read_indices(views, indices, base)) {
+            return false;
+        }
+    } else {
+        // Strips and fans read most indices thrice, so they are not read back from the destination
+        std::vector<u32> source(views.stored_index_count());
+        if (not read_indices(views, source.data(), base)) {
+            return false;
+        }
+        triangulate(views.mode, source, indices);
+    }
+
+    // The attributes are decoded straight into the interleaved vertices, one field at a time
+    auto target = std::span{ vertices, count };
+    views.positions.read_floats(&vertices->position.x, 3, sizeof(Mesh::Vertex));
+    if (views.colors) {
+        views.colors->read_floats(&vertices->color.x, 3, sizeof(Mesh::Vertex));
+    } else {
+        for (auto &vertex : target) {
+            vertex.color = glm::vec3{ 1.0f };
+        }
+    }
+    if (views.normals) {
+        views.normals->read_floats(&vertices->normal.x, 3, sizeof(Mesh::Vertex));
+    } else {
+        for (auto &vertex : target) {
+            vertex.normal = glm::vec3{ 0.0f };
+        }
+    }
+    if (views.uvs) {
+        views.uvs->read_floats(&vertices->uv.x, 2, sizeof(Mesh::Vertex));
+    } else {
+        for (auto &vertex : target) {
+            vertex.uv = glm::vec2{ 0.0f };
+        }
+    }
+    return true;
+}
+
+/// The sum of the positions and the bounds of a set of vertices
+struct Extent {
+    glm::vec3 sum{ 0.0f };
+    Mesh::Bounds bounds{ glm::vec3{ std::numeric_limits<f32>::max() }, glm::vec3{ -std::numeric_limits<f32>::max() } };
+
+    /// Adds a position to the extent
+    /// @param position The position
+    void add(const glm::vec3 &position) {
+        sum += position;
+        bounds.min = glm::min(bounds.min, position);
+        bounds.max = glm::max(bounds.max, position);
+    }
+
+    /// Adds another extent to the extent
+    /// @param other The other extent
+    void add(const Extent &other) {
+        sum += other.sum;
+        bounds.min = glm::min(bounds.min, other.bounds.min);
+        bounds.max = glm::max(bounds.max, other.bounds.max);
+    }
+};
+
+/// Measures the positions of a set of vertices
+/// @param vertices The vertices
+/// @return The sum of the positions and their bounds
+Extent measure(std::span<const Mesh::Vertex> vertices) {
+    Extent result{};
+    for (const auto &vertex : vertices) {
+        result.add(vertex.position);
+    }
+    return result;
+}
+
+/// Measures the positions of a primitive from its accessor instead of from the decoded vertices, which may be
+/// mapped device memory that is slow to read
+/// @param positions The view of the positions
+/// @return The sum of the positions and their bounds
+Extent measure(const gltf::AccessorView &positions) {
+    constexpr u32 BLOCK_SIZE = 256;
+
+    Extent result{};
+    glm::vec3 block[BLOCK_SIZE];
+    for (u32 first = 0; first < positions.count; first += BLOCK_SIZE) {
+        auto view = positions.slice(first, std::min(BLOCK_SIZE, positions.count - first));
+        view.read_floats(&block[0].x, 3, sizeof(glm::vec3));
+        for (u32 index = 0; index < view.count; index++) {
+            result.add(block[index]);
+        }
+    }
+    return result;
+}
+
+}// namespace
+
+/// Appends a primitive of a glTF document as triangle list
+bool Mesh::Builder::append(const gltf::Document &document, std::span<const std::span<const u8>> buffer_views,
+                           const gltf::Primitive &primitive) {
+    if (not has_triangles(primitive)) {
+        return true;
+    }
+    auto views = prepare(document, buffer_views, primitive);
+    if (not views or vertices.size() + views->positions.count > std::numeric_limits<u32>::max() or
+        indices.size() + views->index_count() > std::numeric_limits<u32>::max()) {
+        return false;
+    }
+
+    auto base = vertices.size();
+    auto first = indices.size();
+    vertices.resize(base + views->positions.count);
+    indices.resize(first + views->index_count());
+    if (not decode(*views, vertices.data() + base, indices.data() + first, static_cast<u32>(base))) {
+        vertices.resize(base);
+        indices.resize(first);
+        return false;
+    }
+    return true;
+}
+
+/// Loads every primitive of every mesh of a glTF file from the specified filesystem path
+bool Mesh::Builder::from_gltf(const fs::path &path) {
+    vertices.clear();
+    indices.clear();
+
+    auto file = GltfFile::read(path);
+    if (not file) {
+        return false;
+    }
+
+    std::vector<std::vector<u8>> storage{};
+    auto buffer_views = resolve_views(*file, storage);
+    if (not buffer_views) {
+        return false;
+    }
+    for (const auto &mesh : file->document.meshes) {
+        for (const auto &primitive : mesh.primitives) {
+            if (not append(file->document, *buffer_views, primitive)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/// Merges identical vertices and remaps the indices onto the remaining ones
+void Mesh::Builder::weld() {
+    std::unordered_map<Vertex, u32> unique_vertices{};
+    unique_vertices.reserve(vertices.size());
+    std::vector<u32> remap(vertices.size());
+    usize count = 0;
+    for (usize index = 0; index < vertices.size(); index++) {
+        auto [unique, inserted] = unique_vertices.try_emplace(vertices[index], static_cast<u32>(count));
+        if (inserted) {
+            vertices[count++] = vertices[index];
+        }
+        remap[index] = unique->second;
+    }
+    vertices.resize(count);
+    for (auto &index : indices) {
+        index = remap[index];
+    }
+}
+
 /// Creates a new mesh
 Mesh::Mesh(Device &device, const Builder &builder)
     : centroid{},
+      bounds{},
       device{ device },
       vertex_buffer{},
       vertex_count{},
@@ -127,7 +423,117 @@ Mesh::Mesh(Device &device, const Builder &builder)
       index_count{} {
     create_vertex_buffers(builder.vertices);
     create_index_buffers(builder.indices);
-    compute_centroid(builder.vertices);
+    compute_extent(builder.vertices);
+}
+
+/// Creates a new mesh from a glTF file
+Mesh::Mesh(Device &device, const GltfFile &file)
+    : centroid{},
+      bounds{},
+      device{ device },
+      vertex_buffer{},
+      vertex_count{},
+      has_index_buffer{ false },
+      index_buffer{},
+      index_count{} {
+    std::vector<std::vector<u8>> storage{};
+    auto buffer_views = resolve_views(file, storage);
+    if (not buffer_views) {
+        error(64, "[mesh] Malformed glTF buffer view");
+    }
+
+    // All primitives are validated up front, so that the staging buffers can be sized exactly
+    std::vector<PrimitiveViews> primitives{};
+    u64 vertices = 0;
+    u64 indices = 0;
+    for (const auto &mesh : file.document.meshes) {
+        for (const auto &primitive : mesh.primitives) {
+            if (not has_triangles(primitive)) {
+                continue;
+            }
+            auto views = prepare(file.document, *buffer_views, primitive);
+            if (not views) {
+                error(64, "[mesh] Malformed glTF primitive");
+            }
+            vertices += views->positions.count;
+            indices += views->index_count();
+            primitives.push_back(*views);
+        }
+    }
+    if (vertices > std::numeric_limits<u32>::max() or indices > std::numeric_limits<u32>::max()) {
+        error(64, "[mesh] glTF mesh exceeds 32-bit indices");
+    }
+    if (indices < 3) {
+        error(64, "[mesh] glTF file has no triangles");
+    }
+
+    // Degenerate triangles may share fewer than three vertices, but indices into no vertices are out of range
+    if (vertices == 0) {
+        error(64, "[mesh] glTF index out of range");
+    }
+
+    vertex_count = static_cast<u32>(vertices);
+    index_count = static_cast<u32>(indices);
+    has_index_buffer = index_count > 0;
+
+    Buffer vertex_staging{ device, sizeof(Vertex), vertex_count, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                           VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT };
+    vertex_staging.map();
+    std::unique_ptr<Buffer> index_staging{};
+    if (has_index_buffer) {
+        index_staging = std::make_unique<Buffer>(device, sizeof(u32), index_count, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                                                 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                                                         VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+        index_staging->map();
+    }
+
+    // The primitives are decoded straight into the mapped staging buffers
+    auto *vertex = static_cast<Vertex *>(vertex_staging.mapped);
+    auto *index = has_index_buffer ? static_cast<u32 *>(index_staging->mapped) : nullptr;
+    Extent extent{};
+    u32 base = 0;
+    for (const auto &views : primitives) {
+        if (not decode(views, vertex + base, index, base)) {
+            error(64, "[mesh] glTF index out of range");
+        }
+        extent.add(measure(views.positions));
+        index += views.index_count();
+        base += views.positions.count;
+    }
+    centroid = extent.sum / static_cast<f32>(vertex_count);
+    bounds = extent.bounds;
+
+    vertex_buffer = std::make_unique<Buffer>(device, sizeof(Vertex), vertex_count,
+                                             VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                             VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    device.copy_buffer(vertex_staging.buffer, vertex_buffer->buffer, sizeof(Vertex) * vertex_count);
+    if (has_index_buffer) {
+        index_buffer = std::make_unique<Buffer>(device, sizeof(u32), index_count,
+                                                VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        device.copy_buffer(index_staging->buffer, index_buffer->buffer, sizeof(u32) * index_count);
+    }
+}
+
+/// Creates a new mesh with device-local buffers whose data is uploaded by the caller
+Mesh::Mesh(Device &device, u32 vertex_count, u32 index_count)
+    : centroid{},
+      bounds{},
+      device{ device },
+      vertex_buffer{},
+      vertex_count{ vertex_count },
+      has_index_buffer{ index_count > 0 },
+      index_buffer{},
+      index_count{ index_count } {
+    assert(vertex_count >= 3 and "[mesh] Vertex count must be at least 3!");
+    vertex_buffer = std::make_unique<Buffer>(device, sizeof(Vertex), vertex_count,
+                                             VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                             VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    if (has_index_buffer) {
+        index_buffer = std::make_unique<Buffer>(device, sizeof(u32), index_count,
+                                                VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    }
 }
 
 /// Destroys the data of the current mesh
@@ -140,6 +546,157 @@ std::unique_ptr<Mesh> Mesh::from_wavefront(Device &device, const fs::path &path)
     return std::make_unique<Mesh>(device, builder);
 }
 
+/// Creates a mesh from the glTF file at the specified filesystem path
+std::unique_ptr<Mesh> Mesh::from_gltf(Device &device, const fs::path &path) {
+    auto file = GltfFile::read(path);
+    if (not file) {
+        error(64, "[mesh] Could not read glTF file " + path.string());
+    }
+    return std::make_unique<Mesh>(device, *file);
+}
+
+/// Imports every mesh of the glTF file at the specified filesystem path
+std::vector<std::unique_ptr<Mesh>> Mesh::import_gltf(Device &device, ThreadPool &pool, const fs::path &path) {
+    auto file = GltfFile::read(path);
+    if (not file) {
+        error(64, "[mesh] Could not read glTF file " + path.string());
+    }
+    return import_gltf(device, pool, *file);
+}
+
+/// Imports every mesh of a glTF file
+std::vector<std::unique_ptr<Mesh>> Mesh::import_gltf(Device &device, ThreadPool &pool, const GltfFile &file) {
+    std::vector<std::vector<u8>> storage{};
+    auto buffer_views = resolve_views(file, storage);
+    if (not buffer_views) {
+        error(64, "[mesh] Malformed glTF buffer view");
+    }
+
+    struct Task {
+        usize mesh;
+        const gltf::Primitive *primitive;
+        Builder builder;
+        Extent extent;
+        bool decoded;
+        u32 base;
+        VkDeviceSize vertex_offset;
+        VkDeviceSize index_offset;
+    };
+    std::vector<Task> tasks{};
+    const auto &meshes = file.document.meshes;
+    for (usize mesh = 0; mesh < meshes.size(); mesh++) {
+        for (const auto &primitive : meshes[mesh].primitives) {
+            if (has_triangles(primitive)) {
+                tasks.push_back(Task{ mesh, &primitive, {}, {}, false, 0, 0, 0 });
+            }
+        }
+    }
+
+    // Every primitive is decoded, welded and bounded independently of all others
+    pool.parallel_for(tasks.size(), [&](usize index) {
+        auto &task = tasks[index];
+        task.decoded = task.builder.append(file.document, *buffer_views, *task.primitive);
+        if (task.decoded) {
+            task.builder.weld();
+            task.extent = measure(task.builder.vertices);
+        }
+    });
+
+    // The staging buffer holds the vertices of all meshes followed by the indices of all meshes
+    struct Layout {
+        u64 vertices;
+        u64 indices;
+        Extent extent;
+        VkDeviceSize vertex_offset;
+        VkDeviceSize index_offset;
+    };
+    std::vector<Layout> layouts(meshes.size());
+    for (auto &task : tasks) {
+        if (not task.decoded) {
+            error(64, "[mesh] Malformed glTF primitive");
+        }
+        auto &layout = layouts[task.mesh];
+        task.base = static_cast<u32>(layout.vertices);
+        task.vertex_offset = layout.vertices * sizeof(Vertex);
+        task.index_offset = layout.indices * sizeof(u32);
+        layout.vertices += task.builder.vertices.size();
+        layout.indices += task.builder.indices.size();
+        layout.extent.add(task.extent);
+        if (layout.vertices > std::numeric_limits<u32>::max() or layout.indices > std::numeric_limits<u32>::max()) {
+            error(64, "[mesh] glTF mesh exceeds 32-bit indices");
+        }
+    }
+
+    // Meshes without a single triangle are left out, nothing of them is uploaded. So are meshes whose triangles
+    // all collapsed into fewer than three vertices when welding, as all of them are degenerate.
+    for (auto &layout : layouts) {
+        if (layout.indices < 3 or layout.vertices < 3) {
+            layout.vertices = 0;
+            layout.indices = 0;
+        }
+    }
+    VkDeviceSize staging_size = 0;
+    for (auto &layout : layouts) {
+        layout.vertex_offset = staging_size;
+        staging_size += layout.vertices * sizeof(Vertex);
+    }
+    for (auto &layout : layouts) {
+        layout.index_offset = staging_size;
+        staging_size += layout.indices * sizeof(u32);
+    }
+
+    std::vector<std::unique_ptr<Mesh>> result{};
+    for (const auto &layout : layouts) {
+        if (layout.indices == 0) {
+            result.emplace_back();
+            continue;
+        }
+        auto &mesh = result.emplace_back(
+                new Mesh{ device, static_cast<u32>(layout.vertices), static_cast<u32>(layout.indices) });
+        mesh->centroid = layout.extent.sum / static_cast<f32>(layout.vertices);
+        mesh->bounds = layout.extent.bounds;
+    }
+    if (staging_size == 0) {
+        return result;
+    }
+
+    Buffer staging_buffer{ device, staging_size, 1, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                           VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT };
+    staging_buffer.map();
+    auto *staging = static_cast<u8 *>(staging_buffer.mapped);
+    pool.parallel_for(tasks.size(), [&](usize index) {
+        const auto &task = tasks[index];
+        const auto &layout = layouts[task.mesh];
+        if (layout.indices == 0) {
+            return;
+        }
+        std::memcpy(staging + layout.vertex_offset + task.vertex_offset, task.builder.vertices.data(),
+                    task.builder.vertices.size() * sizeof(Vertex));
+        auto *indices = reinterpret_cast<u32 *>(staging + layout.index_offset + task.index_offset);
+        for (usize offset = 0; offset < task.builder.indices.size(); offset++) {
+            indices[offset] = task.builder.indices[offset] + task.base;
+        }
+    });
+
+    // All copies are recorded into a single command buffer, so the whole scene is uploaded with one submission
+    auto command_buffer = device.begin_commands();
+    for (usize mesh = 0; mesh < layouts.size(); mesh++) {
+        const auto &layout = layouts[mesh];
+        if (not result[mesh]) {
+            continue;
+        }
+        VkBufferCopy vertex_region{ layout.vertex_offset, 0, layout.vertices * sizeof(Vertex) };
+        vkCmdCopyBuffer(command_buffer, staging_buffer.buffer, result[mesh]->vertex_buffer->buffer, 1, &vertex_region);
+        if (result[mesh]->has_index_buffer) {
+            VkBufferCopy index_region{ layout.index_offset, 0, layout.indices * sizeof(u32) };
+            vkCmdCopyBuffer(command_buffer, staging_buffer.buffer, result[mesh]->index_buffer->buffer, 1,
+                            &index_region);
+        }
+    }
+    device.end_commands(command_buffer);
+    return result;
+}
+
 /// Binds the current mesh using the specified command buffer
 void Mesh::bind(VkCommandBuffer command_buffer) const {
     std::array<VkDeviceSize, 1> offsets = { 0 };
@@ -158,6 +715,36 @@ void Mesh::draw(VkCommandBuffer command_buffer) const {
     }
 }
 
+/// Records copies of ranges of vertices into the vertex buffer
+void Mesh::copy_vertices(VkCommandBuffer command_buffer, const Buffer &source,
+                         std::span<const VertexRange> ranges) const {
+    if (ranges.empty()) {
+        return;
+    }
+
+    std::vector<VkBufferCopy> regions{};
+    regions.reserve(ranges.size());
+    for (const auto &[first, count] : ranges) {
+        assert(first + count <= vertex_count and "[mesh] Vertex range exceeds the vertex buffer!");
+        auto offset = VkDeviceSize{ first } * sizeof(Vertex);
+        regions.push_back({ offset, offset, VkDeviceSize{ count } * sizeof(Vertex) });
+    }
+    vkCmdCopyBuffer(command_buffer, source.buffer, vertex_buffer->buffer, static_cast<u32>(regions.size()),
+                    regions.data());
+
+    VkBufferMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.buffer = vertex_buffer->buffer;
+    barrier.offset = 0;
+    barrier.size = VK_WHOLE_SIZE;
+    vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, 0, 0,
+                         nullptr, 1, &barrier, 0, nullptr);
+}
+
 void Mesh::create_vertex_buffers(const std::vector<Vertex> &vertices) {
     vertex_count = static_cast<u32>(vertices.size());
     assert(vertex_count >= 3 and "[mesh] Vertex count must be at least 3!");
@@ -202,13 +789,11 @@ void Mesh::create_index_buffers(const std::vector<u32> &indices) {
     device.copy_buffer(staging_buffer.buffer, index_buffer->buffer, buffer_size);
 }
 
-/// Computes the centroid of the current mesh
-void Mesh::compute_centroid(const std::vector<Vertex> &vertices) {
-    auto result = glm::vec3{ 0.0f };
-    for (const auto &vertex : vertices) {
-        result += vertex.position;
-    }
-    centroid = result / static_cast<f32>(vertices.size());
+/// Computes the centroid and the bounds of the current mesh
+void Mesh::compute_extent(const std::vector<Vertex> &vertices) {
+    auto extent = measure(vertices);
+    centroid = extent.sum / static_cast<f32>(vertices.size());
+    bounds = extent.bounds;
 }
 
 }// namespace rt
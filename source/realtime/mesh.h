@@ -30,9 +30,12 @@
 #include <glm/glm.hpp>
 
 #include <memory>
+#include <span>
 
 #include "buffer.h"
 #include "device.h"
+#include "gltf.h"
+#include "thread_pool.h"
 #include "utility.h"
 
 
@@ -60,6 +63,18 @@ public:
         auto operator<=>(const Vertex &other) const = default;
     };
 
+    /// A range of consecutive vertices
+    struct VertexRange {
+        u32 first;
+        u32 count;
+    };
+
+    /// An axis-aligned bounding box
+    struct Bounds {
+        glm::vec3 min;
+        glm::vec3 max;
+    };
+
     struct Builder {
         std::vector<Vertex> vertices{};
         std::vector<u32> indices{};
@@ -67,17 +82,44 @@ public:
         /// Loads a wavefront mesh from the specified filesystem path
         /// @param path The filesystem path of the mesh
         void from_wavefront(const fs::path &path);
+
+        /// Appends a primitive of a glTF document as triangle list, its indices are rebased onto the vertices
+        /// that are already present. Vertices without colour are white. Strips and fans are converted into
+        /// lists, points, lines and primitives without positions are skipped and append nothing.
+        /// @param document The glTF document
+        /// @param buffer_views The data of every buffer view of the document, as resolved by gltf::resolve_views
+        /// @param primitive The primitive
+        /// @return A value that indicates whether the primitive could be decoded, nothing is appended otherwise
+        bool append(const gltf::Document &document, std::span<const std::span<const u8>> buffer_views,
+                    const gltf::Primitive &primitive);
+
+        /// Loads every primitive of every mesh of a glTF file from the specified filesystem path
+        /// @param path The filesystem path of the glTF or GLB file
+        /// @return A value that indicates whether the file could be read and all of its primitives decoded
+        bool from_gltf(const fs::path &path);
+
+        /// Merges identical vertices and remaps the indices onto the remaining ones
+        void weld();
     };
 
 
     /// The centroid of the mesh
     glm::vec3 centroid;
 
+    /// The bounds of the mesh
+    Bounds bounds;
+
     /// Creates a new mesh
     /// @param device The device instance
     /// @param builder A builder for the vertex data
     explicit Mesh(Device &device, const Builder &builder);
 
+    /// Creates a new mesh from a glTF file. Its primitives are decoded straight into the mapped staging
+    /// buffers, so no vertex or index is held in host memory twice.
+    /// @param device The device instance
+    /// @param file The glTF file
+    explicit Mesh(Device &device, const GltfFile &file);
+
     /// Destroys the data of the current mesh
     ~Mesh();
 
@@ -91,6 +133,30 @@ public:
     /// @return A new mesh
     static std::unique_ptr<Mesh> from_wavefront(Device &device, const fs::path &path);
 
+    /// Creates a mesh from the glTF file at the specified filesystem path
+    /// @param device The device instance
+    /// @param path The filesystem path of the glTF or GLB file
+    /// @return A new mesh
+    static std::unique_ptr<Mesh> from_gltf(Device &device, const fs::path &path);
+
+    /// Imports every mesh of the glTF file at the specified filesystem path. Every primitive is
+    /// decoded, welded and bounded in its own task on the thread pool, afterwards all meshes are uploaded
+    /// through a single staging buffer with a single command buffer.
+    /// @param device The device instance
+    /// @param pool The thread pool that decodes the primitives
+    /// @param path The filesystem path of the glTF or GLB file
+    /// @return The meshes, indexed like the meshes of the file, nullptr for meshes without triangles or whose
+    ///         triangles are all degenerate
+    static std::vector<std::unique_ptr<Mesh>> import_gltf(Device &device, ThreadPool &pool, const fs::path &path);
+
+    /// Imports every mesh of a glTF file
+    /// @param device The device instance
+    /// @param pool The thread pool that decodes the primitives
+    /// @param file The glTF file
+    /// @return The meshes, indexed like the meshes of the file, nullptr for meshes without triangles or whose
+    ///         triangles are all degenerate
+    static std::vector<std::unique_ptr<Mesh>> import_gltf(Device &device, ThreadPool &pool, const GltfFile &file);
+
     /// Binds the current mesh using the specified command buffer
     /// @param command_buffer The recording command buffer
     void bind(VkCommandBuffer command_buffer) const;
@@ -99,7 +165,21 @@ public:
     /// @param command_buffer The recording command buffer
     void draw(VkCommandBuffer command_buffer) const;
 
+    /// Records copies of ranges of vertices into the vertex buffer, followed by a barrier that makes them
+    /// visible to vertex input, so that only the vertices that changed are transferred
+    /// @param command_buffer The recording command buffer
+    /// @param source A buffer that holds every vertex of the mesh at the same position as the vertex buffer
+    /// @param ranges The ranges of vertices
+    void copy_vertices(VkCommandBuffer command_buffer, const Buffer &source,
+                       std::span<const VertexRange> ranges) const;
+
 private:
+    /// Creates a new mesh with device-local buffers whose data is uploaded by the caller
+    /// @param device The device instance
+    /// @param vertex_count The number of vertices
+    /// @param index_count The number of indices
+    Mesh(Device &device, u32 vertex_count, u32 index_count);
+
     /// Creates the vertex buffers for the current mesh
     /// @param vertices The vertices
     void create_vertex_buffers(const std::vector<Vertex> &vertices);
@@ -108,9 +188,9 @@ private:
     /// @param indices The indices
     void create_index_buffers(const std::vector<u32> &indices);
 
-    /// Computes the centroid of the current mesh
+    /// Computes the centroid and the bounds of the current mesh
     /// @param vertices The vertices
-    void compute_centroid(const std::vector<Vertex> &vertices);
+    void compute_extent(const std::vector<Vertex> &vertices);
 
     Device &device;
 
@@ -0,0 +1,242 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Elias Engelbert Plank
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "morph.h"
+#include "gltf_accessor.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+namespace rt {
+
+namespace {
+
+/// The number of dense displacements that are read at once
+constexpr u32 BLOCK_SIZE = 256;
+
+/// The largest number of unchanged vertices between two dirty ranges that are merged
+constexpr u32 MERGE_GAP = 8;
+
+/// The vertex after the last displacement of an attribute
+constexpr u32 END = std::numeric_limits<u32>::max();
+
+/// The displacements of one attribute of a target, sorted by vertex
+struct Displacements {
+    std::vector<u32> vertices;
+    std::vector<glm::vec3> values;
+};
+
+/// Reads the displacements of a target attribute, skipping vertices that are not displaced
+/// @param view The view of the attribute
+/// @param base The number of vertices of earlier primitives, which is added to every vertex
+/// @param out The displacements
+void read_displacements(const gltf::AccessorView &view, u32 base, Displacements &out) {
+    // Accessors without buffer view displace only their sparse elements, which are read as they are, and
+    // nothing at all if they are not sparse
+    if (view.data == nullptr) {
+        if (not view.sparse) {
+            return;
+        }
+        auto values = view.sparse_values();
+        out.vertices.resize(values.count);
+        out.values.resize(values.count);
+        view.read_sparse_indices(out.vertices.data());
+        values.read_floats(&out.values.front().x, 3, sizeof(glm::vec3));
+        for (auto &vertex : out.vertices) {
+            vertex += base;
+        }
+        return;
+    }
+
+    glm::vec3 block[BLOCK_SIZE];
+    for (u32 first = 0; first < view.count; first += BLOCK_SIZE) {
+        auto elements = std::min(BLOCK_SIZE, view.count - first);
+        view.slice(first, elements).read_floats(&block[0].x, 3, sizeof(glm::vec3));
+        for (u32 index = 0; index < elements; index++) {
+            const auto &value = block[index];
+            if (value.x != 0.0f or value.y != 0.0f or value.z != 0.0f) {
+                out.vertices.push_back(base + first + index);
+                out.values.push_back(value);
+            }
+        }
+    }
+}
+
+/// Normalizes a vector unless it is zero
+/// @param vector The vector
+/// @return The normalized vector
+glm::vec3 normalize_or_zero(glm::vec3 vector) {
+    auto length = vector.x * vector.x + vector.y * vector.y + vector.z * vector.z;
+    if (length > 0.0f) {
+        auto root = std::sqrt(length);
+        return { vector.x / root, vector.y / root, vector.z / root };
+    }
+    return vector;
+}
+
+}// namespace
+
+/// Imports the vertices and morph targets of every primitive of a glTF mesh
+std::optional<MorphTargets> MorphTargets::from_gltf(const gltf::Document &document,
+                                                    std::span<const std::span<const u8>> buffer_views, u32 mesh) {
+    if (mesh >= document.meshes.size() or document.meshes[mesh].primitives.empty()) {
+        return std::nullopt;
+    }
+    const auto &primitives = document.meshes[mesh].primitives;
+    auto target_count = primitives.front().targets.size();
+
+    // Displacements are collected per target, as the primitives interleave them
+    Mesh::Builder builder{};
+    std::vector<Displacements> positions(target_count);
+    std::vector<Displacements> normals(target_count);
+    for (const auto &primitive : primitives) {
+        if (primitive.targets.size() != target_count) {
+            return std::nullopt;
+        }
+        auto base = static_cast<u32>(builder.vertices.size());
+        if (not builder.append(document, buffer_views, primitive)) {
+            return std::nullopt;
+        }
+        auto count = builder.vertices.size() - base;
+        if (count == 0) {
+            continue;
+        }
+
+        for (usize target = 0; target < target_count; target++) {
+            const auto &attributes = primitive.targets[target];
+            auto read = [&](std::optional<u32> accessor, Displacements &out) {
+                if (not accessor) {
+                    return true;
+                }
+                auto view = gltf::AccessorView::create(document, buffer_views, *accessor);
+                if (not view or view->components != 3 or view->count != count) {
+                    return false;
+                }
+                read_displacements(*view, base, out);
+                return true;
+            };
+            if (not read(attributes.position, positions[target]) or not read(attributes.normal, normals[target])) {
+                return std::nullopt;
+            }
+        }
+    }
+
+    auto result = MorphTargets{};
+    result.base = std::move(builder.vertices);
+    result.indices = std::move(builder.indices);
+    result.weights = document.meshes[mesh].weights;
+    result.weights.resize(target_count, 0.0f);
+
+    // The displaced positions and normals of a target are merged, a vertex may displace either or both
+    for (usize target = 0; target < target_count; target++) {
+        const auto &position = positions[target];
+        const auto &normal = normals[target];
+        auto first = static_cast<u32>(result.vertices.size());
+        usize p = 0;
+        usize n = 0;
+        while (p < position.vertices.size() or n < normal.vertices.size()) {
+            auto position_vertex = p < position.vertices.size() ? position.vertices[p] : END;
+            auto normal_vertex = n < normal.vertices.size() ? normal.vertices[n] : END;
+            auto vertex = std::min(position_vertex, normal_vertex);
+            result.vertices.push_back(vertex);
+            result.positions.push_back(vertex == position_vertex ? position.values[p++] : glm::vec3{ 0.0f });
+            result.normals.push_back(vertex == normal_vertex ? normal.values[n++] : glm::vec3{ 0.0f });
+        }
+        result.targets.push_back({ first, static_cast<u32>(result.vertices.size()) - first });
+    }
+    return result;
+}
+
+/// Blends the targets into vertices that hold the blend of the current weights
+void MorphTargets::blend(std::span<const f32> weights, std::span<f32> current, std::span<Mesh::Vertex> out,
+                         std::vector<Mesh::VertexRange> &dirty) const {
+    assert(weights.size() >= targets.size() and current.size() >= targets.size() and
+           "[morph] Weights must hold a weight per target");
+    assert(out.size() >= base.size() and "[morph] Destination must hold every vertex");
+
+    // The vertices of all changed targets are merged into one sorted set
+    std::vector<u32> changed{};
+    for (usize target = 0; target < targets.size(); target++) {
+        if (weights[target] == current[target]) {
+            continue;
+        }
+        const auto &[first, count] = targets[target];
+        auto middle = changed.size();
+        changed.insert(changed.end(), vertices.begin() + first, vertices.begin() + first + count);
+        std::inplace_merge(changed.begin(), changed.begin() + static_cast<std::ptrdiff_t>(middle), changed.end());
+        current[target] = weights[target];
+    }
+    changed.erase(std::unique(changed.begin(), changed.end()), changed.end());
+    if (changed.empty()) {
+        return;
+    }
+
+    // Every target that displaces a changed vertex contributes to it, which a merge of both sorted sets finds
+    std::vector<glm::vec3> blended_positions(changed.size());
+    std::vector<glm::vec3> blended_normals(changed.size());
+    for (usize index = 0; index < changed.size(); index++) {
+        blended_positions[index] = base[changed[index]].position;
+        blended_normals[index] = base[changed[index]].normal;
+    }
+    for (usize target = 0; target < targets.size(); target++) {
+        auto weight = weights[target];
+        if (weight == 0.0f) {
+            continue;
+        }
+
+        // Only the displacements between the first and the last changed vertex can meet one
+        const auto *begin = vertices.data() + targets[target].first;
+        const auto *end = begin + targets[target].count;
+        begin = std::lower_bound(begin, end, changed.front());
+        end = std::upper_bound(begin, end, changed.back());
+        usize index = 0;
+        for (const auto *vertex = begin; vertex != end; vertex++) {
+            while (changed[index] < *vertex) {
+                index++;
+            }
+            if (changed[index] == *vertex) {
+                auto displacement = static_cast<usize>(vertex - vertices.data());
+                blended_positions[index] += positions[displacement] * weight;
+                blended_normals[index] += normals[displacement] * weight;
+            }
+        }
+    }
+
+    // Vertices are written in increasing order, which yields the dirty ranges in the same pass
+    auto ranges = dirty.size();
+    for (usize index = 0; index < changed.size(); index++) {
+        auto vertex = changed[index];
+        out[vertex].position = blended_positions[index];
+        out[vertex].normal = normalize_or_zero(blended_normals[index]);
+        if (dirty.size() > ranges and dirty.back().first + dirty.back().count + MERGE_GAP >= vertex) {
+            dirty.back().count = vertex - dirty.back().first + 1;
+        } else {
+            dirty.push_back({ vertex, 1 });
+        }
+    }
+}
+
+}// namespace rt
@@ -0,0 +1,87 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Elias Engelbert Plank
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef REALTIME_MORPH_H
+#define REALTIME_MORPH_H
+
+#include <span>
+#include <vector>
+
+#include "gltf.h"
+#include "mesh.h"
+
+namespace rt {
+
+/// The morph targets of a glTF mesh in sparse form. Every target only holds the vertices it displaces, sorted
+/// by vertex, which is all that facial animation assets usually displace. Blending recomputes nothing but the
+/// vertices of targets whose weight changed, and reports them as ranges so that only those are uploaded.
+struct MorphTargets {
+    /// The displacements of a target, a range of the displacements of all targets
+    struct Target {
+        u32 first;
+        u32 count;
+    };
+
+    /// The vertices of every primitive of the mesh, neither displaced nor welded
+    std::vector<Mesh::Vertex> base;
+    std::vector<u32> indices;
+
+    std::vector<Target> targets;
+
+    /// The displaced vertex, position and normal displacement of every displacement
+    std::vector<u32> vertices;
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec3> normals;
+
+    /// The default weight of every target
+    std::vector<f32> weights;
+
+    /// Imports the vertices and morph targets of every primitive of a glTF mesh. Sparse accessors are read
+    /// without being expanded, dense ones are compacted a block at a time.
+    /// @param document The glTF document
+    /// @param buffer_views The data of every buffer view of the document, as resolved by gltf::resolve_views
+    /// @param mesh The index of the mesh
+    /// @return The morph targets or std::nullopt if any primitive is malformed or the primitives do not have
+    ///         the same number of targets
+    static std::optional<MorphTargets> from_gltf(const gltf::Document &document,
+                                                 std::span<const std::span<const u8>> buffer_views, u32 mesh);
+
+    /// Blends the targets into vertices that hold the blend of the current weights. Every vertex that a target
+    /// with a changed weight displaces is recomputed from its base vertex and all of its displacements, so no
+    /// error accumulates over time. Only positions and normals of those vertices are written and nothing is
+    /// ever read from the destination, which may be mapped memory.
+    /// @param weights The new weight of every target
+    /// @param current The weight of every target the vertices are blended with, all zero for the base vertices,
+    ///                which is updated to the new weights
+    /// @param out The blended vertices
+    /// @param dirty The ranges of the vertices that were written, which are appended in increasing order. Ranges
+    ///              closer than a few vertices are merged, so that a few unchanged vertices are uploaded
+    ///              instead of many small ranges.
+    void blend(std::span<const f32> weights, std::span<f32> current, std::span<Mesh::Vertex> out,
+               std::vector<Mesh::VertexRange> &dirty) const;
+};
+
+}// namespace rt
+
+#endif// REALTIME_MORPH_H
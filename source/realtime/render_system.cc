@@ -76,12 +76,19 @@ void RenderSystem::create_pipeline(VkRenderPass render_pass) {
 }
 
 /// Renders the entities
-void RenderSystem::render_entities(const FrameInfo &info, std::vector<Entity> &entities) const {
+void RenderSystem::render_entities(const FrameInfo &info, std::vector<Entity> &entities,
+                                   const Hierarchy &hierarchy) const {
     pipeline->bind(info.command_buffer);
     for (auto projection_view = info.camera.projection_view(); auto &entity : entities) {
         PushConstantData push{};
         push.transform = projection_view * entity.transform.transform();
         push.normal = entity.transform.normal();
+        if (entity.node) {
+            // Node transforms may scale non-uniformly, so their normals need the inverse transpose
+            const auto &world = hierarchy.worlds[*entity.node];
+            push.transform = push.transform * world;
+            push.normal = push.normal * glm::transpose(glm::inverse(world));
+        }
         vkCmdPushConstants(info.command_buffer, pipeline_layout,
                            VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof push, &push);
         entity.mesh->bind(info.command_buffer);
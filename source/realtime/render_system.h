@@ -31,6 +31,7 @@
 #include "device.h"
 #include "entity.h"
 #include "frame_info.h"
+#include "hierarchy.h"
 #include "pipeline.h"
 
 
@@ -60,7 +61,8 @@ public:
     /// Renders the entities
     /// @param info The frame info
     /// @param entities The entities to render
-    void render_entities(const FrameInfo &info, std::vector<Entity> &entities) const;
+    /// @param hierarchy The hierarchy the nodes of the entities refer to, whose world matrices are up to date
+    void render_entities(const FrameInfo &info, std::vector<Entity> &entities, const Hierarchy &hierarchy) const;
 
 private:
     /// Creates the layout of the pipeline
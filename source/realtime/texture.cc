@@ -0,0 +1,392 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Elias Engelbert Plank
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "texture.h"
+#include "mapped_file.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <iterator>
+
+namespace rt {
+
+namespace {
+
+/// The alignment of staging ring allocations, which satisfies the texel alignment of every format
+constexpr VkDeviceSize STAGING_ALIGNMENT = 16;
+
+/// Records a layout transition of a range of mip levels
+/// @param command_buffer The recording command buffer
+/// @param image The image
+/// @param level The first mip level
+/// @param count The number of mip levels
+/// @param from The layout and access of the previous commands, which run in the source stage
+/// @param to The layout and access of the following commands, which run in the destination stage
+/// @param source_stage The stage of the previous commands
+/// @param destination_stage The stage of the following commands
+void transition(VkCommandBuffer command_buffer, VkImage image, u32 level, u32 count,
+                std::pair<VkImageLayout, VkAccessFlags> from, std::pair<VkImageLayout, VkAccessFlags> to,
+                VkPipelineStageFlags source_stage, VkPipelineStageFlags destination_stage) {
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.oldLayout = from.first;
+    barrier.newLayout = to.first;
+    barrier.srcAccessMask = from.second;
+    barrier.dstAccessMask = to.second;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = image;
+    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    barrier.subresourceRange.baseMipLevel = level;
+    barrier.subresourceRange.levelCount = count;
+    barrier.subresourceRange.baseArrayLayer = 0;
+    barrier.subresourceRange.layerCount = 1;
+    vkCmdPipelineBarrier(command_buffer, source_stage, destination_stage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+}
+
+}// namespace
+
+/// Creates a texture whose image contents are undefined
+Texture::Texture(Device &device, u32 width, u32 height, u32 mip_count, VkFormat format)
+    : width{ width },
+      height{ height },
+      mip_count{ mip_count },
+      format{ format },
+      device{ device },
+      image{},
+      memory{},
+      view{},
+      sampler{} {
+    VkImageCreateInfo image_info{};
+    image_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    image_info.imageType = VK_IMAGE_TYPE_2D;
+    image_info.format = format;
+    image_info.extent = { width, height, 1 };
+    image_info.mipLevels = mip_count;
+    image_info.arrayLayers = 1;
+    image_info.samples = VK_SAMPLE_COUNT_1_BIT;
+    image_info.tiling = VK_IMAGE_TILING_OPTIMAL;
+    image_info.usage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    image_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    image_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    device.create_image(image_info, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, image, memory);
+
+    VkImageViewCreateInfo view_info{};
+    view_info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    view_info.image = image;
+    view_info.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    view_info.format = format;
+    view_info.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    view_info.subresourceRange.baseMipLevel = 0;
+    view_info.subresourceRange.levelCount = mip_count;
+    view_info.subresourceRange.baseArrayLayer = 0;
+    view_info.subresourceRange.layerCount = 1;
+    if (vkCreateImageView(device.logical_device, &view_info, nullptr, &view) != VK_SUCCESS) {
+        error(64, "[texture] Failed to create image view!");
+    }
+
+    VkSamplerCreateInfo sampler_info{};
+    sampler_info.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    sampler_info.magFilter = VK_FILTER_LINEAR;
+    sampler_info.minFilter = VK_FILTER_LINEAR;
+    sampler_info.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+    sampler_info.addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    sampler_info.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    sampler_info.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    sampler_info.anisotropyEnable = VK_TRUE;
+    sampler_info.maxAnisotropy = device.physical_device_properties.limits.maxSamplerAnisotropy;
+    sampler_info.minLod = 0.0f;
+    sampler_info.maxLod = static_cast<f32>(mip_count);
+    sampler_info.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
+    if (vkCreateSampler(device.logical_device, &sampler_info, nullptr, &sampler) != VK_SUCCESS) {
+        error(64, "[texture] Failed to create sampler!");
+    }
+}
+
+/// Destroys the image, its view and its sampler
+Texture::~Texture() {
+    vkDestroySampler(device.logical_device, sampler, nullptr);
+    vkDestroyImageView(device.logical_device, view, nullptr);
+    vkDestroyImage(device.logical_device, image, nullptr);
+    vkFreeMemory(device.logical_device, memory, nullptr);
+}
+
+/// Retrieves the descriptor info of the texture as combined image sampler
+VkDescriptorImageInfo Texture::descriptor_info() const {
+    return VkDescriptorImageInfo{ .sampler = sampler,
+                                  .imageView = view,
+                                  .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
+}
+
+/// Computes the number of mip levels of a full mip chain
+u32 Texture::mip_levels(u32 width, u32 height) {
+    return static_cast<u32>(std::bit_width(std::max(width, height)));
+}
+
+/// Creates a texture loader
+TextureLoader::TextureLoader(Device &device, ThreadPool &pool, VkDeviceSize staging_size)
+    : device{ device },
+      pool{ pool },
+      staging{ device, staging_size, 1, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+               VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT },
+      head{ 0 },
+      tail{ 0 },
+      decoding{ 0 } {
+    staging.map();
+}
+
+/// Waits for the images that are being decoded and the uploads in flight
+TextureLoader::~TextureLoader() {
+    {
+        std::unique_lock lock{ mutex };
+        idle.wait(lock, [this] { return decoding == 0; });
+    }
+    for (auto &upload : uploads) {
+        vkWaitForFences(device.logical_device, 1, &upload.fence, VK_TRUE, UINT64_MAX);
+        vkDestroyFence(device.logical_device, upload.fence, nullptr);
+        vkFreeCommandBuffers(device.logical_device, device.command_pool, 1, &upload.command_buffer);
+    }
+}
+
+/// Loads the image file at the specified filesystem path
+void TextureLoader::load(const fs::path &path, Callback callback, VkFormat format) {
+    auto read = [path]() -> std::optional<Image> {
+        auto file = MappedFile::open(path);
+        if (not file) {
+            return std::nullopt;
+        }
+        return Image::decode(file->bytes());
+    };
+    decode(std::move(read), std::move(callback), format);
+}
+
+/// Loads an image of a glTF file
+void TextureLoader::load(std::shared_ptr<const GltfFile> file, u32 image, Callback callback, VkFormat format) {
+    // Images at a URI may need to be decoded from base64 as well, which is left to the thread pool
+    auto read = [file = std::move(file), image]() -> std::optional<Image> {
+        GltfFile::Storage storage{};
+        auto data = file->image_data(image, storage);
+        if (not data) {
+            return std::nullopt;
+        }
+        return Image::decode(*data);
+    };
+    decode(std::move(read), std::move(callback), format);
+}
+
+/// Decodes an image on the thread pool
+void TextureLoader::decode(std::function<std::optional<Image>()> read, Callback callback, VkFormat format) {
+    {
+        std::lock_guard lock{ mutex };
+        decoding++;
+    }
+    pool.submit([this, read = std::move(read), callback = std::move(callback), format]() mutable {
+        auto image = read();
+        std::lock_guard lock{ mutex };
+        decoded.push_back({ std::move(image), format, std::move(callback) });
+        decoding--;
+        idle.notify_all();
+    });
+}
+
+/// Retires completed uploads and submits the images that were decoded since the last update
+void TextureLoader::update() {
+    retire();
+    {
+        std::lock_guard lock{ mutex };
+        std::move(decoded.begin(), decoded.end(), std::back_inserter(waiting));
+        decoded.clear();
+    }
+
+    // Images are staged in order until the ring is full, the remaining ones wait for the next update
+    auto upload = Upload{};
+    while (not waiting.empty()) {
+        auto &next = waiting.front();
+        if (not next.image) {
+            auto callback = std::move(next.callback);
+            waiting.pop_front();
+            callback(nullptr);
+            continue;
+        }
+
+        const auto &pixels = next.image->pixels;
+        auto source = staging.buffer;
+        VkDeviceSize offset = 0;
+        if (pixels.size() > staging.buffer_size) {
+            const auto &buffer = upload.dedicated.emplace_back(std::make_unique<Buffer>(
+                    device, pixels.size(), 1, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                    VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT));
+            buffer->map();
+            std::memcpy(buffer->mapped, pixels.data(), pixels.size());
+            source = buffer->buffer;
+        } else if (auto allocation = allocate(pixels.size())) {
+            offset = *allocation;
+            std::memcpy(static_cast<u8 *>(staging.mapped) + offset, pixels.data(), pixels.size());
+        } else {
+            break;
+        }
+
+        // Without linear filtering of the format, blits cannot downsample and the texture keeps one level
+        VkFormatProperties properties{};
+        vkGetPhysicalDeviceFormatProperties(device.physical_device, next.format, &properties);
+        constexpr VkFormatFeatureFlags BLIT_FEATURES = VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT |
+                                                       VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+        auto width = next.image->width;
+        auto height = next.image->height;
+        auto mip_count = (properties.optimalTilingFeatures & BLIT_FEATURES) == BLIT_FEATURES
+                                 ? Texture::mip_levels(width, height)
+                                 : 1;
+        auto texture = std::make_shared<Texture>(device, width, height, mip_count, next.format);
+
+        if (not upload.command_buffer) {
+            upload.command_buffer = device.begin_commands();
+        }
+        record(upload.command_buffer, *texture, source, offset);
+        upload.textures.emplace_back(std::move(texture), std::move(next.callback));
+        waiting.pop_front();
+    }
+    if (not upload.command_buffer) {
+        return;
+    }
+
+    // The upload is submitted without waiting, its fence is polled by later updates
+    vkEndCommandBuffer(upload.command_buffer);
+    VkFenceCreateInfo fence_info{};
+    fence_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+    if (vkCreateFence(device.logical_device, &fence_info, nullptr, &upload.fence) != VK_SUCCESS) {
+        error(64, "[texture] Failed to create upload fence!");
+    }
+    VkSubmitInfo submit_info{};
+    submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submit_info.commandBufferCount = 1;
+    submit_info.pCommandBuffers = &upload.command_buffer;
+    if (vkQueueSubmit(device.graphics_queue, 1, &submit_info, upload.fence) != VK_SUCCESS) {
+        error(64, "[texture] Failed to submit texture upload!");
+    }
+    upload.end = head;
+    uploads.push_back(std::move(upload));
+}
+
+/// Retrieves the number of textures that are being decoded, staged or uploaded
+usize TextureLoader::pending() const {
+    usize result = waiting.size();
+    for (const auto &upload : uploads) {
+        result += upload.textures.size();
+    }
+    std::lock_guard lock{ mutex };
+    return result + decoded.size() + decoding;
+}
+
+/// Allocates a region of the staging ring
+std::optional<VkDeviceSize> TextureLoader::allocate(VkDeviceSize size) {
+    // The head never catches up with the tail from behind, so equal positions always mean an empty ring
+    size = (size + STAGING_ALIGNMENT - 1) & ~(STAGING_ALIGNMENT - 1);
+    auto offset = head;
+    if (head >= tail) {
+        if (size <= staging.buffer_size - head) {
+            head += size;
+            return offset;
+        }
+        if (size < tail) {
+            head = size;
+            return 0;
+        }
+        return std::nullopt;
+    }
+    if (size < tail - head) {
+        head += size;
+        return offset;
+    }
+    return std::nullopt;
+}
+
+/// Records the copy of the largest mip level from a staging buffer and the blits of all smaller levels
+void TextureLoader::record(VkCommandBuffer command_buffer, const Texture &texture, VkBuffer source,
+                           VkDeviceSize offset) const {
+    transition(command_buffer, texture.image, 0, texture.mip_count, { VK_IMAGE_LAYOUT_UNDEFINED, 0 },
+               { VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_ACCESS_TRANSFER_WRITE_BIT },
+               VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+
+    VkBufferImageCopy copy_region{};
+    copy_region.bufferOffset = offset;
+    copy_region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    copy_region.imageSubresource.mipLevel = 0;
+    copy_region.imageSubresource.baseArrayLayer = 0;
+    copy_region.imageSubresource.layerCount = 1;
+    copy_region.imageExtent = { texture.width, texture.height, 1 };
+    vkCmdCopyBufferToImage(command_buffer, source, texture.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1,
+                           &copy_region);
+
+    // Every level is downsampled from the previous one, which is done being read afterwards
+    auto width = static_cast<s32>(texture.width);
+    auto height = static_cast<s32>(texture.height);
+    for (u32 level = 1; level < texture.mip_count; level++) {
+        transition(command_buffer, texture.image, level - 1, 1,
+                   { VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_ACCESS_TRANSFER_WRITE_BIT },
+                   { VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_ACCESS_TRANSFER_READ_BIT },
+                   VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+
+        auto next_width = std::max(width / 2, 1);
+        auto next_height = std::max(height / 2, 1);
+        VkImageBlit blit{};
+        blit.srcSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, level - 1, 0, 1 };
+        blit.srcOffsets[1] = { width, height, 1 };
+        blit.dstSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, level, 0, 1 };
+        blit.dstOffsets[1] = { next_width, next_height, 1 };
+        vkCmdBlitImage(command_buffer, texture.image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, texture.image,
+                       VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit, VK_FILTER_LINEAR);
+
+        transition(command_buffer, texture.image, level - 1, 1,
+                   { VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_ACCESS_TRANSFER_READ_BIT },
+                   { VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_ACCESS_SHADER_READ_BIT },
+                   VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+        width = next_width;
+        height = next_height;
+    }
+    transition(command_buffer, texture.image, texture.mip_count - 1, 1,
+               { VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_ACCESS_TRANSFER_WRITE_BIT },
+               { VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_ACCESS_SHADER_READ_BIT }, VK_PIPELINE_STAGE_TRANSFER_BIT,
+               VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+}
+
+/// Retires the uploads whose fences are signaled and invokes their callbacks
+void TextureLoader::retire() {
+    // Uploads are submitted to a single queue, so they are retired in order
+    while (not uploads.empty() and vkGetFenceStatus(device.logical_device, uploads.front().fence) == VK_SUCCESS) {
+        auto upload = std::move(uploads.front());
+        uploads.pop_front();
+        vkDestroyFence(device.logical_device, upload.fence, nullptr);
+        vkFreeCommandBuffers(device.logical_device, device.command_pool, 1, &upload.command_buffer);
+        tail = upload.end;
+        if (uploads.empty()) {
+            head = 0;
+            tail = 0;
+        }
+        for (auto &[texture, callback] : upload.textures) {
+            callback(std::move(texture));
+        }
+    }
+}
+
+}// namespace rt
@@ -0,0 +1,197 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Elias Engelbert Plank
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef REALTIME_TEXTURE_H
+#define REALTIME_TEXTURE_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "buffer.h"
+#include "device.h"
+#include "gltf.h"
+#include "image.h"
+#include "thread_pool.h"
+
+namespace rt {
+
+/// A sampled 2D texture with a full mip chain. Textures are created by the texture loader, which hands them
+/// out once their image is uploaded and every mip level is in shader read-only layout.
+class Texture {
+public:
+    /// Creates a texture whose image contents are undefined
+    /// @param device The device instance
+    /// @param width The width of the texture
+    /// @param height The height of the texture
+    /// @param mip_count The number of mip levels
+    /// @param format The format of the texture, which has four 8-bit channels
+    Texture(Device &device, u32 width, u32 height, u32 mip_count, VkFormat format);
+
+    /// Destroys the image, its view and its sampler
+    ~Texture();
+
+    /// A texture cannot be copied
+    Texture(const Texture &) = delete;
+    Texture &operator=(const Texture &) = delete;
+
+    /// Retrieves the descriptor info of the texture as combined image sampler
+    /// @return The descriptor image info
+    VkDescriptorImageInfo descriptor_info() const;
+
+    /// Computes the number of mip levels of a full mip chain
+    /// @param width The width of the largest level
+    /// @param height The height of the largest level
+    /// @return The number of mip levels
+    static u32 mip_levels(u32 width, u32 height);
+
+    u32 width;
+    u32 height;
+    u32 mip_count;
+    VkFormat format;
+
+private:
+    friend class TextureLoader;
+
+    Device &device;
+    VkImage image;
+    VkDeviceMemory memory;
+    VkImageView view;
+    VkSampler sampler;
+};
+
+/// Loads textures without ever blocking the render thread. Images are read and decoded on the thread pool.
+/// Every frame, the render thread copies the decoded images into a persistently mapped staging ring and
+/// records their copies and mip chain blits into a single command buffer, which is submitted with a fence.
+/// Uploads are retired by polling their fences, which releases their part of the ring and hands their
+/// textures to the completion callbacks on the render thread.
+class TextureLoader {
+public:
+    /// Receives the loaded texture, or nullptr if its image could not be read or decoded
+    using Callback = std::function<void(std::shared_ptr<Texture>)>;
+
+    /// The default size of the staging ring, images that are larger get a staging buffer of their own
+    static constexpr VkDeviceSize DEFAULT_STAGING_SIZE = 64 << 20;
+
+    /// Creates a texture loader
+    /// @param device The device instance
+    /// @param pool The thread pool that decodes the images
+    /// @param staging_size The size of the staging ring
+    TextureLoader(Device &device, ThreadPool &pool, VkDeviceSize staging_size = DEFAULT_STAGING_SIZE);
+
+    /// Waits for the images that are being decoded and the uploads in flight, whose callbacks are dropped
+    ~TextureLoader();
+
+    /// A texture loader cannot be copied or moved
+    TextureLoader(const TextureLoader &) = delete;
+    TextureLoader &operator=(const TextureLoader &) = delete;
+    TextureLoader(TextureLoader &&) = delete;
+    TextureLoader &operator=(TextureLoader &&) = delete;
+
+    /// Loads the image file at the specified filesystem path
+    /// @param path The filesystem path of the image
+    /// @param callback The callback that receives the texture on the render thread
+    /// @param format The format of the texture, sRGB for colours and UNORM for other data
+    void load(const fs::path &path, Callback callback, VkFormat format = VK_FORMAT_R8G8B8A8_SRGB);
+
+    /// Loads an image of a glTF file, which is kept alive until the image is decoded
+    /// @param file The glTF file
+    /// @param image The index of the image
+    /// @param callback The callback that receives the texture on the render thread
+    /// @param format The format of the texture, sRGB for colours and UNORM for other data
+    void load(std::shared_ptr<const GltfFile> file, u32 image, Callback callback,
+              VkFormat format = VK_FORMAT_R8G8B8A8_SRGB);
+
+    /// Retires completed uploads and submits the images that were decoded since the last update. Must be
+    /// called regularly on the render thread, it never waits for the device or the thread pool.
+    void update();
+
+    /// Retrieves the number of textures that are being decoded, staged or uploaded
+    /// @return The number of pending textures
+    usize pending() const;
+
+private:
+    /// An image that was decoded on the thread pool and waits for its upload
+    struct Decoded {
+        std::optional<Image> image;
+        VkFormat format;
+        Callback callback;
+    };
+
+    /// A submitted command buffer, which owns its part of the staging ring until its fence is signaled
+    struct Upload {
+        VkCommandBuffer command_buffer;
+        VkFence fence;
+
+        /// The end of the staging ring allocations of the upload and all earlier ones
+        VkDeviceSize end;
+        std::vector<std::unique_ptr<Buffer>> dedicated;
+        std::vector<std::pair<std::shared_ptr<Texture>, Callback>> textures;
+    };
+
+    /// Decodes an image on the thread pool
+    /// @param read The function that reads and decodes the image
+    /// @param callback The callback that receives the texture
+    /// @param format The format of the texture
+    void decode(std::function<std::optional<Image>()> read, Callback callback, VkFormat format);
+
+    /// Allocates a region of the staging ring
+    /// @param size The size of the region
+    /// @return The offset of the region or std::nullopt if the ring is full
+    std::optional<VkDeviceSize> allocate(VkDeviceSize size);
+
+    /// Records the copy of the largest mip level from a staging buffer and the blits of all smaller levels
+    /// @param command_buffer The recording command buffer
+    /// @param texture The texture
+    /// @param source The staging buffer
+    /// @param offset The offset of the pixels in the staging buffer
+    void record(VkCommandBuffer command_buffer, const Texture &texture, VkBuffer source, VkDeviceSize offset) const;
+
+    /// Retires the uploads whose fences are signaled and invokes their callbacks
+    void retire();
+
+    Device &device;
+    ThreadPool &pool;
+    Buffer staging;
+
+    /// The staging ring is allocated at its head and released at its tail
+    VkDeviceSize head;
+    VkDeviceSize tail;
+    std::deque<Upload> uploads;
+
+    /// Decoded images that did not fit into the staging ring yet
+    std::deque<Decoded> waiting;
+
+    /// Images that were decoded since the last update, handed over by the thread pool
+    mutable std::mutex mutex;
+    std::condition_variable idle;
+    std::vector<Decoded> decoded;
+    usize decoding;
+};
+
+}// namespace rt
+
+#endif// REALTIME_TEXTURE_H
@@ -0,0 +1,94 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Elias Engelbert Plank
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "thread_pool.h"
+
+namespace rt {
+
+/// Creates a new thread pool
+ThreadPool::ThreadPool(usize count) : stopping{ false } {
+    workers.reserve(std::max<usize>(count, 1));
+    for (usize index = 0; index < std::max<usize>(count, 1); index++) {
+        workers.emplace_back([this] { work(); });
+    }
+}
+
+/// Joins all worker threads after the remaining tasks have been executed
+ThreadPool::~ThreadPool() {
+    {
+        auto lock = std::scoped_lock{ mutex };
+        stopping = true;
+    }
+    available.notify_all();
+    for (auto &worker : workers) {
+        worker.join();
+    }
+}
+
+/// Submits a task for execution on one of the worker threads
+void ThreadPool::submit(std::function<void()> task) {
+    {
+        auto lock = std::scoped_lock{ mutex };
+        tasks.push_back(std::move(task));
+    }
+    available.notify_one();
+}
+
+/// Retrieves the number of worker threads
+usize ThreadPool::size() const {
+    return workers.size();
+}
+
+/// Executes a single queued task on the calling thread
+bool ThreadPool::run_one() {
+    std::function<void()> task;
+    {
+        auto lock = std::scoped_lock{ mutex };
+        if (tasks.empty()) {
+            return false;
+        }
+        task = std::move(tasks.front());
+        tasks.pop_front();
+    }
+    task();
+    return true;
+}
+
+/// Executes tasks until the pool is destroyed
+void ThreadPool::work() {
+    while (true) {
+        std::function<void()> task;
+        {
+            auto lock = std::unique_lock{ mutex };
+            available.wait(lock, [this] { return stopping or not tasks.empty(); });
+            if (tasks.empty()) {
+                return;
+            }
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        task();
+    }
+}
+
+}// namespace rt
@@ -0,0 +1,115 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Elias Engelbert Plank
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef REALTIME_THREAD_POOL_H
+#define REALTIME_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <latch>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "utility.h"
+
+namespace rt {
+
+/// A fixed set of worker threads that execute submitted tasks in submission order
+class ThreadPool {
+public:
+    /// Creates a new thread pool
+    /// @param count The number of worker threads, at least one
+    explicit ThreadPool(usize count = std::max(1u, std::thread::hardware_concurrency()));
+
+    /// Joins all worker threads after the remaining tasks have been executed
+    ~ThreadPool();
+
+    /// A thread pool cannot be copied or moved
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+    ThreadPool(ThreadPool &&) = delete;
+    ThreadPool &operator=(ThreadPool &&) = delete;
+
+    /// Submits a task for execution on one of the worker threads
+    /// @param task The task
+    void submit(std::function<void()> task);
+
+    /// Retrieves the number of worker threads
+    /// @return The number of worker threads
+    usize size() const;
+
+    /// Invokes the function for every index in [0, count) and waits for all invocations. Workers and the
+    /// calling thread claim indices dynamically, so uneven workloads are balanced.
+    /// @param count The number of indices
+    /// @param function The function, invoked with the index
+    template<typename Function>
+    void parallel_for(usize count, Function &&function) {
+        if (count == 0) {
+            return;
+        }
+
+        auto helpers = std::min(size(), count - 1);
+        std::atomic<usize> next{ 0 };
+        std::latch done{ static_cast<std::ptrdiff_t>(helpers) };
+        auto drain = [&next, &function, count] {
+            for (auto index = next++; index < count; index = next++) {
+                function(index);
+            }
+        };
+        for (usize helper = 0; helper < helpers; helper++) {
+            submit([&drain, &done] {
+                drain();
+                done.count_down();
+            });
+        }
+        drain();
+
+        // Help out with queued tasks while waiting, so nested calls from worker threads cannot deadlock
+        while (not done.try_wait()) {
+            if (not run_one()) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+private:
+    /// Executes a single queued task on the calling thread
+    /// @return A value that indicates whether a task was executed
+    bool run_one();
+
+    /// Executes tasks until the pool is destroyed
+    void work();
+
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable available;
+    bool stopping;
+};
+
+}// namespace rt
+
+#endif// REALTIME_THREAD_POOL_H
@@ -23,6 +23,8 @@
 
 #include "utility.h"
 
+#include <bit>
+#include <cstring>
 #include <fstream>
 
 namespace rt {
@@ -30,12 +32,133 @@ namespace rt {
 /// Tries to parse a unicode codepoint from a given string view
 std::optional<u32> codepoint_from_view(std::string_view view) {
     u32 result{};
-    if (std::from_chars(view.data(), view.data() + view.size(), result, 16).ec == std::errc{}) {
+    auto *end = view.data() + view.size();
+    if (auto [last, ec] = std::from_chars(view.data(), end, result, 16); ec == std::errc{} and last == end) {
         return result;
     }
     return std::nullopt;
 }
 
+/// Encodes a unicode codepoint as UTF-8
+usize utf8_encode(u32 codepoint, char *out) {
+    if (codepoint < 0x80) {
+        out[0] = static_cast<char>(codepoint);
+        return 1;
+    }
+    if (codepoint < 0x800) {
+        out[0] = static_cast<char>(0xC0 | (codepoint >> 6));
+        out[1] = static_cast<char>(0x80 | (codepoint & 0x3F));
+        return 2;
+    }
+    if (codepoint < 0x10000) {
+        out[0] = static_cast<char>(0xE0 | (codepoint >> 12));
+        out[1] = static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+        out[2] = static_cast<char>(0x80 | (codepoint & 0x3F));
+        return 3;
+    }
+    out[0] = static_cast<char>(0xF0 | (codepoint >> 18));
+    out[1] = static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F));
+    out[2] = static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+    out[3] = static_cast<char>(0x80 | (codepoint & 0x3F));
+    return 4;
+}
+
+/// Decodes the UTF-8 sequence at the front of the view and removes it from the view
+std::optional<u32> utf8_decode(std::string_view &view) {
+    if (view.empty()) {
+        return std::nullopt;
+    }
+
+    auto lead = static_cast<u8>(view.front());
+    usize length = 0;
+    u32 codepoint = 0;
+    if (lead < 0x80) {
+        length = 1;
+        codepoint = lead;
+    } else if ((lead & 0xE0) == 0xC0) {
+        length = 2;
+        codepoint = lead & 0x1F;
+    } else if ((lead & 0xF0) == 0xE0) {
+        length = 3;
+        codepoint = lead & 0x0F;
+    } else if ((lead & 0xF8) == 0xF0) {
+        length = 4;
+        codepoint = lead & 0x07;
+    } else {
+        return std::nullopt;
+    }
+
+    if (view.size() < length) {
+        return std::nullopt;
+    }
+    for (usize index = 1; index < length; index++) {
+        auto continuation = static_cast<u8>(view[index]);
+        if ((continuation & 0xC0) != 0x80) {
+            return std::nullopt;
+        }
+        codepoint = (codepoint << 6) | (continuation & 0x3F);
+    }
+    view.remove_prefix(length);
+    return codepoint;
+}
+
+namespace {
+
+constexpr u64 HASH_PRIME_1 = 0x9E3779B185EBCA87;
+constexpr u64 HASH_PRIME_2 = 0xC2B2AE3D27D4EB4F;
+constexpr u64 HASH_PRIME_3 = 0x165667B19E3779F9;
+
+/// Loads eight unaligned bytes in host byte order
+/// @param bytes The bytes
+/// @return The word
+u64 load_word(const char *bytes) {
+    u64 word;
+    std::memcpy(&word, bytes, sizeof(word));
+    return word;
+}
+
+/// Mixes a word into a lane of the hash
+/// @param lane The lane
+/// @param word The word
+/// @return The mixed lane
+u64 hash_round(u64 lane, u64 word) {
+    return std::rotl(lane + word * HASH_PRIME_2, 31) * HASH_PRIME_1;
+}
+
+}// namespace
+
+/// Hashes the bytes of the data eight at a time in four independent lanes
+u64 hash_bytes(std::string_view data, u64 seed) {
+    const auto *bytes = data.data();
+    auto remaining = data.size();
+
+    u64 hash = seed + HASH_PRIME_3;
+    if (remaining >= 32) {
+        u64 lanes[4] = { seed + HASH_PRIME_1 + HASH_PRIME_2, seed + HASH_PRIME_2, seed, seed - HASH_PRIME_1 };
+        for (; remaining >= 32; bytes += 32, remaining -= 32) {
+            for (usize lane = 0; lane < 4; lane++) {
+                lanes[lane] = hash_round(lanes[lane], load_word(bytes + lane * 8));
+            }
+        }
+        hash = std::rotl(lanes[0], 1) + std::rotl(lanes[1], 7) + std::rotl(lanes[2], 12) + std::rotl(lanes[3], 18);
+    }
+
+    hash += data.size();
+    for (; remaining >= 8; bytes += 8, remaining -= 8) {
+        hash = std::rotl(hash ^ hash_round(0, load_word(bytes)), 27) * HASH_PRIME_1 + HASH_PRIME_3;
+    }
+    for (; remaining > 0; bytes++, remaining--) {
+        hash = std::rotl(hash ^ (static_cast<u8>(*bytes) * HASH_PRIME_3), 11) * HASH_PRIME_1;
+    }
+
+    hash ^= hash >> 33;
+    hash *= HASH_PRIME_2;
+    hash ^= hash >> 29;
+    hash *= HASH_PRIME_3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
 /// Print out an error message to the console and exit the application
 /// with the specified error code
 void error(s32 code, std::string_view message) {
@@ -24,6 +24,7 @@
 #ifndef REALTIME_UTILITY_H
 #define REALTIME_UTILITY_H
 
+#include <charconv>
 #include <cstdarg>
 #include <filesystem>
 #include <fstream>
@@ -95,6 +96,25 @@ std::optional<T> number_from_view(std::string_view view) {
 /// @return An optional unicode codepoint
 std::optional<u32> codepoint_from_view(std::string_view view);
 
+/// Encodes a unicode codepoint as UTF-8
+/// @param codepoint The codepoint
+/// @param out The output buffer, must be able to hold at least four bytes
+/// @return The number of bytes written to the output buffer
+usize utf8_encode(u32 codepoint, char *out);
+
+/// Decodes the UTF-8 sequence at the front of the view and removes it from the view
+/// @param view The view
+/// @return The codepoint or std::nullopt if the view does not start with a valid UTF-8 sequence, in
+///         which case the view is left untouched
+std::optional<u32> utf8_decode(std::string_view &view);
+
+/// Hashes the bytes of the data eight at a time in four independent lanes. The hash is meant for content
+/// addressing and integrity checks on the same machine, it depends on the byte order of the host.
+/// @param data The data
+/// @param seed The seed
+/// @return The 64-bit hash
+u64 hash_bytes(std::string_view data, u64 seed = 0);
+
 /// Print out an error message to the console and exit the application
 /// with the specified error code
 /// @param code The error code
@@ -119,6 +139,37 @@ struct is_same_as_any<T, First, Rest...>
 template<typename T, typename... Args>
 inline constexpr bool is_same_as_any_v = is_same_as_any<T, Args...>::value;
 
+template<typename T, template<typename...> typename Template>
+struct is_specialization_of : std::false_type { };
+
+template<template<typename...> typename Template, typename... Args>
+struct is_specialization_of<Template<Args...>, Template> : std::true_type { };
+
+/// Checks whether a type is a specialization of the given class template
+/// @tparam T The type to check
+/// @tparam Template The class template
+template<typename T, template<typename...> typename Template>
+inline constexpr bool is_specialization_of_v = is_specialization_of<T, Template>::value;
+
+template<typename T>
+struct member_pointer;
+
+template<typename Class, typename Member>
+struct member_pointer<Member Class::*> {
+    using class_type = Class;
+    using member_type = Member;
+};
+
+/// Retrieves the class of a pointer to a data member
+/// @tparam T The type of the member pointer
+template<typename T>
+using member_class_t = typename member_pointer<T>::class_type;
+
+/// Retrieves the type of the member a pointer to a data member refers to
+/// @tparam T The type of the member pointer
+template<typename T>
+using member_type_t = typename member_pointer<T>::member_type;
+
 }// namespace meta
 
 std::partial_ordering operator<=>(glm::vec1 first, glm::vec1 second);
@@ -0,0 +1,453 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Elias Engelbert Plank
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "zlib.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace rt {
+
+namespace {
+
+constexpr u32 FAST_BITS = 10;
+constexpr u32 MAX_CODE_LENGTH = 15;
+constexpr u32 END_OF_BLOCK = 256;
+
+constexpr std::array<u16, 29> LENGTH_BASE = { 3,  4,  5,  6,  7,  8,  9,  10, 11,  13,  15,  17,  19,  23, 27,
+                                              31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+constexpr std::array<u8, 29> LENGTH_EXTRA = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+                                              2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+constexpr std::array<u16, 30> DISTANCE_BASE = { 1,   2,   3,   4,   5,   7,    9,    13,   17,   25,
+                                                33,  49,  65,  97,  129, 193,  257,  385,  513,  769,
+                                                1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+constexpr std::array<u8, 30> DISTANCE_EXTRA = { 0, 0, 0, 0, 1, 1, 2, 2,  3,  3,  4,  4,  5,  5,  6,
+                                                6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+/// The order in which the code lengths of the code length alphabet are stored
+constexpr std::array<u8, 19> CODE_LENGTH_ORDER = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+/// Reverses the lowest bits of a code, Huffman codes are packed starting with their most significant bit
+/// @param code The code
+/// @param length The number of bits
+/// @return The reversed code
+u32 reverse_bits(u32 code, u32 length) {
+    u32 result = 0;
+    for (u32 bit = 0; bit < length; bit++) {
+        result = result << 1 | (code >> bit & 1);
+    }
+    return result;
+}
+
+/// A canonical Huffman code. Codes of up to FAST_BITS bits are resolved by indexing the fast table with the
+/// next bits of the stream, longer ones by comparing against the last code of every length.
+struct Huffman {
+    /// The symbol and length of every code prefix, zero if the code is longer
+    std::array<u16, 1 << FAST_BITS> fast;
+    std::array<u16, MAX_CODE_LENGTH + 2> first_code;
+    std::array<u16, MAX_CODE_LENGTH + 2> first_symbol;
+
+    /// The first code past every length, left-aligned to sixteen bits
+    std::array<u32, MAX_CODE_LENGTH + 2> end_code;
+
+    /// The symbols ordered by their code
+    std::array<u16, 288> symbols;
+
+    /// Builds the code from the code length of every symbol
+    /// @param lengths The code lengths, zero for symbols that do not occur
+    /// @return A value that indicates whether the lengths describe a code that is not over-subscribed
+    bool build(std::span<const u8> lengths) {
+        std::array<u16, MAX_CODE_LENGTH + 1> counts{};
+        for (auto length : lengths) {
+            counts[length]++;
+        }
+        counts[0] = 0;
+
+        std::array<u16, MAX_CODE_LENGTH + 1> next_code{};
+        u32 code = 0;
+        u32 symbol = 0;
+        for (u32 length = 1; length <= MAX_CODE_LENGTH; length++) {
+            next_code[length] = static_cast<u16>(code);
+            first_code[length] = static_cast<u16>(code);
+            first_symbol[length] = static_cast<u16>(symbol);
+            code += counts[length];
+            if (code > 1u << length) {
+                return false;
+            }
+            end_code[length] = code << (16 - length);
+            code <<= 1;
+            symbol += counts[length];
+        }
+        end_code[MAX_CODE_LENGTH + 1] = 1 << 16;
+
+        fast.fill(0);
+        for (u32 index = 0; index < lengths.size(); index++) {
+            auto length = lengths[index];
+            if (length == 0) {
+                continue;
+            }
+            auto position = next_code[length] - first_code[length] + first_symbol[length];
+            symbols[position] = static_cast<u16>(index);
+            if (length <= FAST_BITS) {
+                for (auto prefix = reverse_bits(next_code[length], length); prefix < fast.size();
+                     prefix += 1u << length) {
+                    fast[prefix] = static_cast<u16>(index << 4 | length);
+                }
+            }
+            next_code[length]++;
+        }
+        return true;
+    }
+};
+
+/// Reads the bits of a stream starting with the least significant bit of every byte. Reading past the end of
+/// the stream yields zeros, which is detected by checking for overrun.
+class BitReader {
+public:
+    explicit BitReader(std::span<const u8> data) : data{ data }, position{ 0 }, bits{ 0 }, count{ 0 }, padding{ 0 } {
+    }
+
+    /// Retrieves the next bits without consuming them
+    /// @param length The number of bits, at most 32
+    /// @return The bits
+    u32 peek(u32 length) {
+        if (count < length) {
+            refill();
+        }
+        return static_cast<u32>(bits & ((u64{ 1 } << length) - 1));
+    }
+
+    /// Consumes bits that were peeked
+    /// @param length The number of bits
+    void consume(u32 length) {
+        bits >>= length;
+        count -= length;
+    }
+
+    /// Reads the next bits
+    /// @param length The number of bits, at most 32
+    /// @return The bits
+    u32 read(u32 length) {
+        auto result = peek(length);
+        consume(length);
+        return result;
+    }
+
+    /// Decodes the next symbol of a Huffman code
+    /// @param huffman The Huffman code
+    /// @return The symbol or std::nullopt if no code of the Huffman code matches
+    std::optional<u32> decode(const Huffman &huffman) {
+        auto next = peek(16);
+        if (auto entry = huffman.fast[next & ((1 << FAST_BITS) - 1)]) {
+            consume(entry & 15);
+            return entry >> 4;
+        }
+        auto code = reverse_bits(next, 16);
+        auto length = FAST_BITS + 1;
+        while (code >= huffman.end_code[length]) {
+            length++;
+        }
+        if (length > MAX_CODE_LENGTH) {
+            return std::nullopt;
+        }
+        auto position = (code >> (16 - length)) - huffman.first_code[length] + huffman.first_symbol[length];
+        if (position >= huffman.symbols.size()) {
+            return std::nullopt;
+        }
+        consume(length);
+        return huffman.symbols[position];
+    }
+
+    /// Discards the bits up to the next byte boundary and hands over the remaining bytes
+    /// @return The bytes after the boundary or std::nullopt if the stream was overrun
+    std::optional<std::span<const u8>> align() {
+        if (overrun()) {
+            return std::nullopt;
+        }
+        // The bit buffer holds the padding past the end as well
+        auto offset = position + padding - count / 8;
+        bits = 0;
+        count = 0;
+        padding = 0;
+        position = offset;
+        return data.subspan(offset);
+    }
+
+    /// Continues reading after bytes that were handed over by align
+    /// @param length The number of bytes that were consumed
+    void skip(usize length) {
+        position += length;
+    }
+
+    /// Checks whether more bits were consumed than the stream holds
+    /// @return A value that indicates whether the stream was overrun
+    bool overrun() const {
+        return padding * 8 > count;
+    }
+
+private:
+    /// Fills the bit buffer with whole bytes
+    void refill() {
+        while (count <= 56) {
+            if (position < data.size()) {
+                bits |= u64{ data[position++] } << count;
+            } else {
+                padding++;
+            }
+            count += 8;
+        }
+    }
+
+    std::span<const u8> data;
+    usize position;
+    u64 bits;
+    u32 count;
+    usize padding;
+};
+
+/// Copies a match of earlier output, overlapping matches repeat their first distance bytes
+/// @param out The output
+/// @param written The number of bytes already written
+/// @param length The length of the match
+/// @param distance The distance of the match
+void copy_match(u8 *out, usize written, usize length, usize distance) {
+    auto *destination = out + written;
+    const auto *source = destination - distance;
+    if (distance >= length) {
+        std::memcpy(destination, source, length);
+    } else if (distance == 1) {
+        std::memset(destination, *source, length);
+    } else {
+        for (usize index = 0; index < length; index++) {
+            destination[index] = source[index];
+        }
+    }
+}
+
+/// Decodes the literals and matches of a compressed block
+/// @param reader The reader
+/// @param literals The literal and length code
+/// @param distances The distance code
+/// @param out The output
+/// @param written The number of bytes already written, advanced by the block
+/// @return A value that indicates whether the block is well-formed and fits the output
+bool decode_block(BitReader &reader, const Huffman &literals, const Huffman &distances, std::span<u8> out,
+                  usize &written) {
+    while (true) {
+        auto symbol = reader.decode(literals);
+        if (not symbol or reader.overrun()) {
+            return false;
+        }
+        if (*symbol < END_OF_BLOCK) {
+            if (written == out.size()) {
+                return false;
+            }
+            out[written++] = static_cast<u8>(*symbol);
+            continue;
+        }
+        if (*symbol == END_OF_BLOCK) {
+            return true;
+        }
+
+        auto length_symbol = *symbol - END_OF_BLOCK - 1;
+        if (length_symbol >= LENGTH_BASE.size()) {
+            return false;
+        }
+        usize length = LENGTH_BASE[length_symbol] + reader.read(LENGTH_EXTRA[length_symbol]);
+        auto distance_symbol = reader.decode(distances);
+        if (not distance_symbol or *distance_symbol >= DISTANCE_BASE.size()) {
+            return false;
+        }
+        usize distance = DISTANCE_BASE[*distance_symbol] + reader.read(DISTANCE_EXTRA[*distance_symbol]);
+        if (reader.overrun() or distance > written or length > out.size() - written) {
+            return false;
+        }
+        copy_match(out.data(), written, length, distance);
+        written += length;
+    }
+}
+
+/// Reads the literal and length code and the distance code of a block with dynamic Huffman codes
+/// @param reader The reader
+/// @param literals The literal and length code
+/// @param distances The distance code
+/// @return A value that indicates whether the codes are well-formed
+bool read_dynamic_codes(BitReader &reader, Huffman &literals, Huffman &distances) {
+    auto literal_count = reader.read(5) + 257;
+    auto distance_count = reader.read(5) + 1;
+    auto code_length_count = reader.read(4) + 4;
+    // The header can announce 288 literal and 32 distance codes, but only 286 and 30 of them are valid
+    if (literal_count > 286 or distance_count > 30) {
+        return false;
+    }
+
+    std::array<u8, 19> code_length_lengths{};
+    for (u32 index = 0; index < code_length_count; index++) {
+        code_length_lengths[CODE_LENGTH_ORDER[index]] = static_cast<u8>(reader.read(3));
+    }
+    Huffman code_lengths{};
+    if (not code_lengths.build(code_length_lengths)) {
+        return false;
+    }
+
+    // The code lengths of both codes form a single sequence, so runs may cross from one into the other
+    std::array<u8, 286 + 30> lengths{};
+    u32 count = literal_count + distance_count;
+    for (u32 index = 0; index < count;) {
+        auto symbol = reader.decode(code_lengths);
+        if (not symbol or reader.overrun()) {
+            return false;
+        }
+        if (*symbol < 16) {
+            lengths[index++] = static_cast<u8>(*symbol);
+            continue;
+        }
+        u8 value = 0;
+        u32 repeat = 0;
+        if (*symbol == 16) {
+            if (index == 0) {
+                return false;
+            }
+            value = lengths[index - 1];
+            repeat = 3 + reader.read(2);
+        } else if (*symbol == 17) {
+            repeat = 3 + reader.read(3);
+        } else {
+            repeat = 11 + reader.read(7);
+        }
+        if (repeat > count - index) {
+            return false;
+        }
+        std::memset(lengths.data() + index, value, repeat);
+        index += repeat;
+    }
+
+    // A block without end-of-block code could never end
+    if (lengths[END_OF_BLOCK] == 0) {
+        return false;
+    }
+    return literals.build(std::span{ lengths }.first(literal_count)) and
+           distances.build(std::span{ lengths }.subspan(literal_count, distance_count));
+}
+
+/// Builds the fixed Huffman codes of the DEFLATE specification
+/// @param literals The literal and length code
+/// @param distances The distance code
+void build_fixed_codes(Huffman &literals, Huffman &distances) {
+    std::array<u8, 288> literal_lengths{};
+    std::memset(literal_lengths.data(), 8, 144);
+    std::memset(literal_lengths.data() + 144, 9, 112);
+    std::memset(literal_lengths.data() + 256, 7, 24);
+    std::memset(literal_lengths.data() + 280, 8, 8);
+    std::array<u8, 30> distance_lengths{};
+    distance_lengths.fill(5);
+    literals.build(literal_lengths);
+    distances.build(distance_lengths);
+}
+
+/// Computes the Adler-32 checksum of a zlib stream
+/// @param data The data
+/// @return The checksum
+u32 adler32(std::span<const u8> data) {
+    // The largest number of bytes whose sums cannot overflow before they are reduced
+    constexpr usize BLOCK_SIZE = 5552;
+    constexpr u32 MODULUS = 65521;
+    u32 low = 1;
+    u32 high = 0;
+    while (not data.empty()) {
+        auto block = data.first(std::min(data.size(), BLOCK_SIZE));
+        for (auto byte : block) {
+            low += byte;
+            high += low;
+        }
+        low %= MODULUS;
+        high %= MODULUS;
+        data = data.subspan(block.size());
+    }
+    return high << 16 | low;
+}
+
+}// namespace
+
+/// Decompresses a zlib stream straight into the destination and verifies its checksum
+std::optional<usize> ZlibDecoder::decode(std::span<const u8> data, std::span<u8> out) {
+    // The header selects DEFLATE with a window of at most 32 KiB and no preset dictionary
+    if (data.size() < 2) {
+        return std::nullopt;
+    }
+    auto method = data[0];
+    auto flags = data[1];
+    if ((method & 15) != 8 or (method >> 4) > 7 or (method << 8 | flags) % 31 != 0 or (flags & 32) != 0) {
+        return std::nullopt;
+    }
+
+    BitReader reader{ data.subspan(2) };
+    usize written = 0;
+    Huffman literals{};
+    Huffman distances{};
+    auto last = false;
+    while (not last) {
+        last = reader.read(1) != 0;
+        auto type = reader.read(2);
+        if (type == 0) {
+            auto stored = reader.align();
+            if (not stored or stored->size() < 4) {
+                return std::nullopt;
+            }
+            u32 length = (*stored)[0] | (*stored)[1] << 8;
+            u32 complement = (*stored)[2] | (*stored)[3] << 8;
+            if ((length ^ 0xFFFF) != complement or stored->size() - 4 < length or length > out.size() - written) {
+                return std::nullopt;
+            }
+            std::copy_n(stored->data() + 4, length, out.data() + written);
+            written += length;
+            reader.skip(4 + length);
+        } else if (type == 1) {
+            build_fixed_codes(literals, distances);
+            if (not decode_block(reader, literals, distances, out, written)) {
+                return std::nullopt;
+            }
+        } else if (type == 2) {
+            if (not read_dynamic_codes(reader, literals, distances) or
+                not decode_block(reader, literals, distances, out, written)) {
+                return std::nullopt;
+            }
+        } else {
+            return std::nullopt;
+        }
+    }
+
+    // The checksum follows the last block at the next byte boundary, most significant byte first
+    auto trailer = reader.align();
+    if (not trailer or trailer->size() < 4) {
+        return std::nullopt;
+    }
+    auto checksum = u32{ (*trailer)[0] } << 24 | (*trailer)[1] << 16 | (*trailer)[2] << 8 | (*trailer)[3];
+    if (checksum != adler32(out.first(written))) {
+        return std::nullopt;
+    }
+    return written;
+}
+
+}// namespace rt
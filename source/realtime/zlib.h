@@ -0,0 +1,49 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Elias Engelbert Plank
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef REALTIME_ZLIB_H
+#define REALTIME_ZLIB_H
+
+#include <optional>
+#include <span>
+
+#include "utility.h"
+
+namespace rt {
+
+/// A decoder for zlib streams (RFC 1950) of DEFLATE blocks (RFC 1951), as used by PNG images. Huffman codes of
+/// up to ten bits are decoded with a single table lookup, matches are copied a word at a time where they do
+/// not overlap themselves.
+class ZlibDecoder {
+public:
+    /// Decompresses a zlib stream straight into the destination and verifies its checksum
+    /// @param data The zlib stream
+    /// @param out The decompressed bytes
+    /// @return The number of decompressed bytes or std::nullopt if the stream is malformed, truncated, needs a
+    /// preset dictionary or does not fit the destination
+    static std::optional<usize> decode(std::span<const u8> data, std::span<u8> out);
+};
+
+}// namespace rt
+
+#endif// REALTIME_ZLIB_H